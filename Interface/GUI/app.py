@@ -123,7 +123,7 @@ def start_mqtt_process():
         print("Erro ao iniciar processo MQTT:", e)
         return None, None, None, None
 
-def start_tel_poller(page: ft.Page, tel_q, on_telemetry_cb=None, on_status_cb=None):
+def start_tel_poller(page: ft.Page, tel_q, on_telemetry_cb=None, on_status_cb=None, on_tel_estado_cb=None):
     if tel_q is None:
         return None
 
@@ -137,7 +137,7 @@ def start_tel_poller(page: ft.Page, tel_q, on_telemetry_cb=None, on_status_cb=No
         log_writer = csv.writer(log_file)
         if not file_exists:
             # cabeçalho
-            log_writer.writerow(["timestamp_pc", "level", "tag", "message"])
+            log_writer.writerow(["timestamp_pc", "level", "tag", "message", "timestamp_esp", "t_esp_us"])
             log_file.flush()
     except Exception as e:
         print("Nao foi possivel abrir arquivo de log CSV:", e)
@@ -171,6 +171,13 @@ def start_tel_poller(page: ft.Page, tel_q, on_telemetry_cb=None, on_status_cb=No
                         except Exception:
                             pass
 
+                elif ttype == "tel_estado":
+                    if on_tel_estado_cb:
+                        try:
+                            on_tel_estado_cb(item.get("data", {}))
+                        except Exception:
+                            pass
+
                 elif ttype == "error":
                     try:
                         page.snack_bar = ft.SnackBar(
@@ -187,9 +194,12 @@ def start_tel_poller(page: ft.Page, tel_q, on_telemetry_cb=None, on_status_cb=No
                     tag = str(data.get("tag", ""))
                     msg_txt = str(data.get("msg", ""))
                     ts = datetime.now().isoformat(timespec="seconds")
+                    # Instante do ESP32 já convertido para o relógio do PC (ver MQTT/relogio.py)
+                    t_esp = data.get("t")
+                    ts_esp = datetime.fromtimestamp(t_esp).isoformat(timespec="milliseconds") if t_esp else ""
 
                     try:
-                        log_writer.writerow([ts, level, tag, msg_txt])
+                        log_writer.writerow([ts, level, tag, msg_txt, ts_esp, data.get("t_us", "")])
                         log_file.flush()
                     except Exception:
                         pass
@@ -324,6 +334,18 @@ def main(pagina: ft.Page):
     titulo_tel = ft.Text("Telemetria", size=18, weight=ft.FontWeight.W_700)
     tel_pitch_txt = ft.Text("—", size=16, text_align=ft.TextAlign.CENTER)
     tel_roll_txt  = ft.Text("—", size=16, text_align=ft.TextAlign.CENTER)
+    tel_estado_txt = ft.Text("", size=11)     # Taxa escolhida pelo ESP32 e saúde do enlace
+
+    def aplicar_estado_telemetria(e: dict):
+        conteudo = "rajada" if e.get("rajada") else e.get("conteudo", "")
+        descartes = int(e.get("falhas", 0)) + int(e.get("descartes_buffer", 0))
+        tel_estado_txt.value = (f"{e.get('hz', 0)} Hz ({conteudo}) • fila {e.get('outbox', 0)} B, "
+                                f"{e.get('latencia_ms', 0)} ms • RSSI {e.get('rssi', 0)} dBm • {descartes} descartes")
+        pagina.update()
+
+    def pedir_rajada(_):
+        if ctl_q is not None:
+            ctl_q.put({"rajada_s": 10})
 
     def aplicar_telemetria(pitch_lido: float, roll_lido: float, vbat=None):  # vbat em Volts
         nonlocal bat_warned  
@@ -359,7 +381,10 @@ def main(pagina: ft.Page):
         border=None,
         content=ft.Column(
             [
-                titulo_tel,
+                ft.Row(
+                    [titulo_tel, ft.TextButton("Rajada 10 s", icon="speed", on_click=pedir_rajada)],
+                    alignment=ft.MainAxisAlignment.SPACE_BETWEEN,
+                ),
                 ft.Row(
                     [
                         ft.Column(
@@ -373,6 +398,7 @@ def main(pagina: ft.Page):
                     ],
                     spacing=16,
                 ),
+                tel_estado_txt,
             ],
             spacing=10,
         ),
@@ -385,7 +411,8 @@ def main(pagina: ft.Page):
         pagina.update()
         cmd_q = tel_q = ctl_q = None
     else:
-        start_tel_poller(pagina, tel_q, on_telemetry_cb=aplicar_telemetria, on_status_cb=atualizar_status)
+        start_tel_poller(pagina, tel_q, on_telemetry_cb=aplicar_telemetria, on_status_cb=atualizar_status,
+                         on_tel_estado_cb=aplicar_estado_telemetria)
 
     # ===== BOTOES =====
     def clamp(v, vmin=-80.0, vmax=80.0):
@@ -9,9 +9,10 @@ Correções importantes:
 
 import json
 import ssl
+import time
 import logging
 import traceback
-from threading import Lock, Timer
+from threading import Event, Lock, Timer
 from typing import Callable, Optional
 import paho.mqtt.client as mqtt
 
@@ -21,8 +22,81 @@ from MQTT.config import (
     CHAVE_JSON_INCLINACAO, CHAVE_JSON_ROLAGEM, QOS, RETER,
     ASSINAR_TELEMETRIA, TOPICO_CMD, TOPICO_TEL
 )
+from MQTT.relogio import SincronizadorRelogio, manter_sincronia, TOPICO_PONG
+from MQTT.codec_telemetria import DecodificadorTelemetria, TOPICO_TEL_BIN
 
 TOPICO_LOG = "gimbal/log"
+TOPICO_TEL_ESTADO = "gimbal/tel_estado"   # Taxa/conteúdo da telemetria e saúde do enlace (~5 s)
+
+# Faixas do histograma de latência (ms)
+FAIXAS_LATENCIA_MS = [5, 10, 20, 30, 50, 75, 100, 150, 200, 300, 500, 1000]
+
+
+def _relogio_ms() -> int:
+    """Relógio do remetente enviado em "th"/"t" (ms, 32 bits)."""
+    return int(time.monotonic() * 1000) & 0xFFFFFFFF
+
+
+class LatenciaComandos:
+    """Histogramas de RTT e de latência comando -> motores a partir das confirmações ("ack") da telemetria.
+
+    RTT = chegada da confirmação - envio ("th" devolvido pelo ESP32).
+    Rede (ida + volta) = RTT - tempo que o comando passou no ESP32 (tx - rx).
+    Comando -> motores = metade da rede + espera até o primeiro ciclo de controle (at - rx).
+    """
+
+    def __init__(self, relatar_a_cada: int = 50):
+        self.relatar_a_cada = relatar_a_cada
+        self.rtt_ms = []
+        self.atuacao_ms = []
+        self._ultimo_id = None
+
+    def registrar(self, ack: dict):
+        if ack.get("id") == self._ultimo_id:
+            return
+        self._ultimo_id = ack.get("id")
+
+        rtt = (_relogio_ms() - int(ack["th"])) & 0xFFFFFFFF
+        no_esp_ms = (float(ack["tx"]) - float(ack["rx"])) / 1000.0
+        ate_controle_ms = (float(ack["at"]) - float(ack["rx"])) / 1000.0
+        rede = max(rtt - no_esp_ms, 0.0)
+        self.rtt_ms.append(float(rtt))
+        self.atuacao_ms.append(rede / 2.0 + ate_controle_ms)
+
+        if len(self.rtt_ms) % self.relatar_a_cada == 0:
+            print(self.relatorio())
+
+    @staticmethod
+    def _histograma(valores):
+        contagem = [0] * (len(FAIXAS_LATENCIA_MS) + 1)
+        for v in valores:
+            i = 0
+            while i < len(FAIXAS_LATENCIA_MS) and v >= FAIXAS_LATENCIA_MS[i]:
+                i += 1
+            contagem[i] += 1
+        return contagem
+
+    @staticmethod
+    def _percentil(valores, p):
+        ordenados = sorted(valores)
+        return ordenados[min(len(ordenados) - 1, int(p / 100.0 * len(ordenados)))]
+
+    def relatorio(self) -> str:
+        if not self.rtt_ms:
+            return "Latência: nenhuma confirmação recebida."
+
+        linhas = [f"Latência de {len(self.rtt_ms)} comandos (ms):"]
+        for nome, valores in (("RTT", self.rtt_ms), ("comando->motores", self.atuacao_ms)):
+            linhas.append(f"  {nome}: p50 {self._percentil(valores, 50):.1f}  p90 {self._percentil(valores, 90):.1f}"
+                          f"  p99 {self._percentil(valores, 99):.1f}  máx {max(valores):.1f}")
+            inicio = 0
+            for limite, n in zip(FAIXAS_LATENCIA_MS + [None], self._histograma(valores)):
+                if n:
+                    faixa = f"{inicio}-{limite}" if limite is not None else f">={inicio}"
+                    linhas.append(f"    {faixa:>9}: {'#' * max(1, 40 * n // len(valores))} {n}")
+                inicio = limite
+        return "\n".join(linhas)
+
 
 class ConexaoGimbalMQTT:
     """Gerencia a conexão com o broker MQTT (HiveMQ Cloud), publicação e assinatura de telemetria."""
@@ -77,6 +151,24 @@ class ConexaoGimbalMQTT:
         self._ultimo_envio = None
         self._debounce_timer: Optional[Timer] = None
 
+        # Sequência dos setpoints (o ESP32 descarta os que chegam fora de ordem)
+        self._seq = 0
+
+        # Id dos comandos confirmados pela telemetria e estatísticas de latência
+        self._id_cmd = 0
+        self._lock_id = Lock()  # publish_cmd também é chamado com self._lock já tomado
+        self.latencia = LatenciaComandos()
+
+        # Relógio do ESP32 -> relógio do PC (pings em gimbal/cmd, respostas em gimbal/pong)
+        self.relogio = SincronizadorRelogio()
+        self._parar_pings: Optional[Event] = None
+
+        # Telemetria binária (quando ativada no ESP32 com {"telemetria":{"formato":"binario"}})
+        self.decodificador = DecodificadorTelemetria()
+
+        # Último estado do agendador de telemetria do ESP32 (taxa, fila de saída, descartes)
+        self.estado_telemetria: dict = {}
+
         # Callbacks MQTT
         if self._cli is not None:
             self._cli.on_connect = self._ao_conectar
@@ -122,7 +214,8 @@ class ConexaoGimbalMQTT:
                 return
 
             p, r = self._ultimo_envio
-            obj = {"pitch": float(p), "roll": float(r)}
+            self._seq += 1
+            obj = {"pitch": float(p), "roll": float(r), "seq": self._seq}
 
             try:
                 self.publish_cmd(obj, debounce=False)
@@ -135,6 +228,18 @@ class ConexaoGimbalMQTT:
             self._ultimo_envio = None
             self._debounce_timer = None
 
+    # ============================== STREAMING ==============================
+    def publicar_stream(self, pitch: float, roll: float):
+        """Amostra de streaming: o ESP32 ordena por "seq" e reproduz pelo relógio "t" (ms)."""
+        with self._lock:
+            self._seq += 1
+            obj = {"pitch": float(pitch), "roll": float(roll), "seq": self._seq,
+                   "t": _relogio_ms()}
+        try:
+            self._cli.publish(TOPICO_CMD, json.dumps(obj), qos=0, retain=False)
+        except Exception as e:
+            print("Erro em publicar_stream:", e)
+
     # ============================== MQTT ==============================
     def conectar(self):
         if self._cb_status:
@@ -173,6 +278,12 @@ class ConexaoGimbalMQTT:
             except Exception:
                 pass
 
+        # Setpoints absolutos levam id e relógio de envio; o ESP32 confirma na telemetria
+        if "pitch" in obj and "roll" in obj and "t" not in obj:
+            with self._lock_id:
+                self._id_cmd = self._id_cmd % 0xFFFFFFFF + 1
+                obj = dict(obj, id=self._id_cmd, th=_relogio_ms())
+
         try:
             payload = json.dumps(obj)
             self._cli.publish(TOPICO_CMD, payload, qos=QOS, retain=RETER)
@@ -180,6 +291,13 @@ class ConexaoGimbalMQTT:
             print("Erro em publish_cmd:", e)
             print(traceback.format_exc())
 
+    def pedir_rajada(self, segundos: float = 10.0):
+        """Telemetria na taxa máxima por alguns segundos (o ESP32 encerra antes se o enlace congestionar)."""
+        try:
+            self._cli.publish(TOPICO_CMD, json.dumps({"telemetria": {"rajada_s": segundos}}), qos=1)
+        except Exception as e:
+            print("Erro em pedir_rajada:", e)
+
     # ============================== CALLBACKS MQTT ==============================
     def _ao_conectar(self, client, userdata, flags=None, rc=0, *extra):
         self._conectado = (rc == 0)
@@ -208,8 +326,23 @@ class ConexaoGimbalMQTT:
             except Exception:
                 pass
 
+        try:
+            client.subscribe(TOPICO_PONG, qos=0)
+            if ASSINAR_TELEMETRIA:
+                client.subscribe(TOPICO_TEL_BIN, qos=0)
+                client.subscribe(TOPICO_TEL_ESTADO, qos=0)
+            if self._parar_pings:
+                self._parar_pings.set()
+            self._parar_pings = Event()
+            manter_sincronia(lambda obj: client.publish(TOPICO_CMD, json.dumps(obj), qos=0),
+                             self.relogio, self._parar_pings)
+        except Exception:
+            pass
+
     def _ao_desconectar(self, client, userdata, rc=0, *extra):
         self._conectado = False
+        if self._parar_pings:
+            self._parar_pings.set()
         if self._cb_status:
             if rc == 0:
                 self._cb_status(False, "Desconectado do broker.")
@@ -220,12 +353,42 @@ class ConexaoGimbalMQTT:
         try:
             topic = msg.topic
 
+            if topic == TOPICO_PONG:
+                self.relogio.receber_pong(json.loads(msg.payload.decode("utf-8")))
+                return
+
+            if topic == TOPICO_TEL_ESTADO:
+                self.estado_telemetria = json.loads(msg.payload.decode("utf-8"))
+                if self._cb_tel_dict:
+                    self._cb_tel_dict({"__tel_estado__": self.estado_telemetria})
+                return
+
+            if topic == TOPICO_TEL_BIN:
+                # Lote de várias amostras: a GUI só precisa da mais recente
+                amostras = self.decodificador.decodificar(msg.payload)
+                if amostras:
+                    a = amostras[-1]
+                    tel_dict = {"pitch": a["pitch"], "roll": a["roll"], "t_us": float(a["t_us"]),
+                                "t": self.relogio.esp_para_epoch(float(a["t_us"]))}
+                    if self._cb_tel_dict:
+                        self._cb_tel_dict(tel_dict)
+                    if self._cb_tel:
+                        try:
+                            self._cb_tel(a["pitch"], a["roll"], None)
+                        except TypeError:
+                            self._cb_tel(a["pitch"], a["roll"])
+                return
+
             if topic == TOPICO_LOG:
                 try:
                     payload = json.loads(msg.payload.decode("utf-8"))
                 except Exception:
                     payload = {"raw": msg.payload.decode("utf-8", errors="ignore")}
 
+                # Instante do ESP32 no relógio de parede do PC (None antes da sincronia)
+                if isinstance(payload, dict) and "t_us" in payload:
+                    payload["t"] = self.relogio.esp_para_epoch(float(payload["t_us"]))
+
                 if self._cb_tel_dict:
                     self._cb_tel_dict({"__log__": payload})
                 return  
@@ -233,6 +396,11 @@ class ConexaoGimbalMQTT:
             if MODO in ("json_cmd_tel", "json_single"):
                 payload = json.loads(msg.payload.decode("utf-8"))
 
+                if isinstance(payload.get("ack"), dict):
+                    self.latencia.registrar(payload["ack"])
+                    if CHAVE_JSON_INCLINACAO not in payload and "vbat" not in payload:
+                        return  # Só a confirmação (telemetria no formato binário)
+
                 p = float(payload.get(CHAVE_JSON_INCLINACAO, 0.0))
                 r = float(payload.get(CHAVE_JSON_ROLAGEM, 0.0))
                 v = payload.get("vbat", None)
@@ -241,6 +409,9 @@ class ConexaoGimbalMQTT:
                 tel_dict = {"pitch": p, "roll": r}
                 if v is not None:
                     tel_dict["vbat"] = v
+                if "t_us" in payload:
+                    tel_dict["t_us"] = float(payload["t_us"])
+                    tel_dict["t"] = self.relogio.esp_para_epoch(tel_dict["t_us"])
 
                 if self._cb_tel_dict:
                     self._cb_tel_dict(tel_dict)
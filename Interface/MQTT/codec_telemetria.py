@@ -0,0 +1,177 @@
+"""
+Decodificador da telemetria binária do gimbal (`gimbal/tel_bin`).
+
+Formato (main/TELEMETRIA/codec_telemetria.h): lotes com cabeçalho
+[versao][flags][keyframe][resolucao u16 LE, 0,001°][contador varint][n]
+seguidos de n amostras. Keyframes trazem t_us e ângulos quantizados
+absolutos; as demais, zigzag-varints de (dt - dt_anterior), dpitch e droll.
+As diferenças atravessam os lotes: se um lote se perde, as amostras são
+descartadas até o próximo keyframe.
+
+Uso (dentro de Interface/), compara bytes por amostra com o JSON atual:
+    python -m MQTT.codec_telemetria --ativar --resolucao 0.01 --duracao 30
+"""
+import argparse
+import json
+import ssl
+import struct
+import time
+
+import paho.mqtt.client as mqtt
+
+from MQTT.config import (
+    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO, TOPICO_CMD,
+)
+
+# Tópico da telemetria binária
+TOPICO_TEL_BIN = "gimbal/tel_bin"
+
+VERSAO = 1
+FLAG_KEYFRAME = 0x01
+
+
+def _varint(dados, i):
+    valor = desloc = 0
+    while True:
+        b = dados[i]
+        i += 1
+        valor |= (b & 0x7F) << desloc
+        if b < 0x80:
+            return valor, i
+        desloc += 7
+
+
+def _zigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def _num_cjson(v):
+    """Número como o cJSON do ESP32 imprime (%1.15g, ou %1.17g se não voltar igual)."""
+    s = "%1.15g" % v
+    return s if float(s) == v else "%1.17g" % v
+
+
+def tamanho_json_equivalente(amostra):
+    """Bytes do {"pitch":..,"roll":..,"t_us":..} que o ESP32 publicaria para a mesma amostra."""
+    pitch = struct.unpack("f", struct.pack("f", amostra["pitch"]))[0]    # float do ESP32
+    roll = struct.unpack("f", struct.pack("f", amostra["roll"]))[0]
+    return len('{"pitch":%s,"roll":%s,"t_us":%s}' % (_num_cjson(pitch), _num_cjson(roll), _num_cjson(float(amostra["t_us"]))))
+
+
+class DecodificadorTelemetria:
+    """Mantém o estado entre lotes e conta bytes, perdas e descartes."""
+
+    def __init__(self):
+        self._proximo = None        # Contador esperado do próximo lote
+        self._sincronizado = False  # Já passou por um keyframe desde a última perda
+        self._t = self._dt = 0
+        self._q = [0, 0]
+        self.lotes = self.amostras = self.bytes = 0
+        self.perdidas = self.descartadas = 0
+        self.bytes_json = 0
+
+    def decodificar(self, dados: bytes):
+        """Lista de amostras {"t_us", "pitch", "roll", "contador"} do lote."""
+
+        if len(dados) < 6 or dados[0] != VERSAO:
+            raise ValueError("Lote de telemetria inválido")
+        flags, keyframe = dados[1], dados[2]
+        res = (dados[3] | dados[4] << 8) / 1000.0
+        contador, i = _varint(dados, 5)
+        n = dados[i]
+        i += 1
+
+        if self._proximo is not None and contador != self._proximo:
+            self.perdidas += (contador - self._proximo) & 0xFFFFFFFF
+            self._sincronizado = False
+        self._proximo = (contador + n) & 0xFFFFFFFF
+
+        saida = []
+        for k in range(n):
+            eh_keyframe = (k == 0 and flags & FLAG_KEYFRAME) or (contador + k) % keyframe == 0
+            a, i = _varint(dados, i)
+            b, i = _varint(dados, i)
+            c, i = _varint(dados, i)
+            if eh_keyframe:
+                self._t, self._dt = a, 0
+                self._q = [_zigzag(b), _zigzag(c)]
+                self._sincronizado = True
+            else:
+                self._dt += _zigzag(a)
+                self._t += self._dt
+                self._q[0] += _zigzag(b)
+                self._q[1] += _zigzag(c)
+
+            if not self._sincronizado:
+                self.descartadas += 1
+                continue
+            amostra = {"t_us": self._t, "pitch": self._q[0] * res, "roll": self._q[1] * res,
+                       "contador": (contador + k) & 0xFFFFFFFF}
+            self.bytes_json += tamanho_json_equivalente(amostra)
+            saida.append(amostra)
+
+        self.lotes += 1
+        self.amostras += len(saida)
+        self.bytes += len(dados)
+        return saida
+
+    def relatorio(self) -> str:
+        if not self.amostras:
+            return "Nenhuma amostra decodificada."
+        binario = self.bytes / self.amostras
+        json_ = self.bytes_json / self.amostras
+        return (f"{self.amostras} amostras em {self.lotes} lotes: {binario:.2f} bytes/amostra "
+                f"(JSON: {json_:.1f}, {json_ / binario:.1f}x menor); "
+                f"{self.perdidas} perdidas, {self.descartadas} descartadas até o keyframe")
+
+
+def main():
+    """Liga o formato binário, decodifica por um tempo e mostra a taxa de compressão."""
+
+    p = argparse.ArgumentParser(description="Telemetria binária do gimbal")
+    p.add_argument("--ativar", action="store_true", help="Pede o formato binário ao ESP32")
+    p.add_argument("--desativar", action="store_true", help="Volta ao JSON ao sair")
+    p.add_argument("--resolucao", type=float, default=0.01, help="Graus por unidade")
+    p.add_argument("--keyframe", type=int, default=50, help="Amostras entre keyframes")
+    p.add_argument("--lote-ms", type=int, default=100, help="Idade máxima de um lote")
+    p.add_argument("--duracao", type=float, default=30.0)
+    args = p.parse_args()
+
+    dec = DecodificadorTelemetria()
+    client = mqtt.Client()
+    if USUARIO_MQTT or SENHA_MQTT:
+        client.username_pw_set(USUARIO_MQTT, SENHA_MQTT)
+    client.tls_set(tls_version=ssl.PROTOCOL_TLS_CLIENT)
+    client.tls_insecure_set(False)
+
+    def on_connect(cli, userdata, flags, rc, properties=None):
+        print("Conectado ao MQTT, rc =", rc)
+        cli.subscribe(TOPICO_TEL_BIN)
+        if args.ativar:
+            cli.publish(TOPICO_CMD, json.dumps({"telemetria": {
+                "formato": "binario", "resolucao": args.resolucao,
+                "keyframe": args.keyframe, "lote_ms": args.lote_ms}}), qos=1)
+
+    def on_message(cli, userdata, msg):
+        try:
+            dec.decodificar(msg.payload)
+        except Exception as e:
+            print("Lote inválido:", e)
+
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.connect(SERVIDOR_MQTT, PORTA_MQTT, MANTER_VIVO)
+    client.loop_start()
+    try:
+        time.sleep(args.duracao)
+    except KeyboardInterrupt:
+        pass
+    if args.desativar:
+        client.publish(TOPICO_CMD, json.dumps({"telemetria": {"formato": "json"}}), qos=1).wait_for_publish()
+    client.loop_stop()
+    client.disconnect()
+    print(dec.relatorio())
+
+
+if __name__ == "__main__":
+    main()
@@ -30,6 +30,12 @@ TOPICO_ROLAGEM = "roll"
 CHAVE_JSON_INCLINACAO = "pitch"
 CHAVE_JSON_ROLAGEM    = "roll"
 
+# Streaming de setpoint: amostras com "seq" e "t" enquanto o slider se move
+# (o ESP32 interpola; False volta ao envio com debounce)
+STREAM_SETPOINT = True
+STREAM_HZ = 50                    # Taxa de envio (máx. ~100 Hz)
+STREAM_MANTER_S = 0.5             # Continua enviando o último valor por esse tempo após parar
+
 #CONFIG MQTT
 QOS = 0
 RETER = False
@@ -0,0 +1,247 @@
+"""
+Identificação da planta do gimbal.
+
+Pede ao ESP32 uma gravação de identificação (`{"ident": {...}}` em `gimbal/cmd`),
+recebe as amostras em `gimbal/ident` e calcula a resposta em frequência do
+comando do motor para a taxa do giroscópio (módulo, fase e coerência).
+
+Como a gravação é feita em malha fechada, a planta é estimada por
+P = G_ry / G_ru (r = excitação injetada, u = comando total, y = taxa),
+que não é enviesada pelo ruído realimentado pelo PID.
+
+Ajusta um modelo de 2ª ordem com atraso
+    P(s) = K * wn² * e^(-s*tau) / (s² + 2*zeta*wn*s + wn²)
+e estima a margem de fase do PID atual sobre a planta medida.
+
+Uso (dentro de Interface/):
+    python -m MQTT.identificacao --eixo pitch --sinal chirp --amplitude 0.5 --f0 1 --f1 200 --duracao 4
+"""
+import argparse
+import csv
+import json
+import ssl
+import threading
+from datetime import datetime
+
+import numpy as np
+import paho.mqtt.client as mqtt
+
+from MQTT.config import (
+    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO, TOPICO_CMD,
+)
+
+# Tópico em que o ESP32 publica a gravação
+TOPICO_IDENT = "gimbal/ident"
+
+# Filtro da derivada do PID (D_FILTER_ALPHA em ControladorPID.cpp)
+ALFA_DERIVADA = 0.2
+
+
+class Gravacao:
+    """Junta o cabeçalho e os blocos recebidos do ESP32."""
+
+    def __init__(self):
+        self.cabecalho = None
+        self.r = self.u = self.y = None
+        self.recebidas = 0
+        self.completa = threading.Event()
+
+    def receber(self, dados):
+        if "total" in dados:
+            self.cabecalho = dados
+            total = int(dados["total"])
+            self.r = np.zeros(total)
+            self.u = np.zeros(total)
+            self.y = np.zeros(total)
+            self.recebidas = 0
+            print(f"Gravando {total} amostras ({dados['sinal']} em {dados['eixo']})...")
+            return
+
+        if self.cabecalho is None:
+            return
+        inicio = int(dados["inicio"])
+        n = len(dados["r"])
+        self.r[inicio:inicio + n] = dados["r"]
+        self.u[inicio:inicio + n] = dados["u"]
+        self.y[inicio:inicio + n] = dados["y"]
+        self.recebidas += n
+        if self.recebidas >= len(self.r):
+            self.completa.set()
+
+    def sinais(self):
+        """Converte para unidades físicas: comando (rad/s do velocity_openloop) e taxa (rad/s)."""
+        escala = float(self.cabecalho["escala_cmd"])
+        lsb = float(self.cabecalho["giro_lsb_por_grau"])
+        return self.r / escala, self.u / escala, np.radians(self.y / lsb)
+
+
+def espectros_cruzados(a, b, fs, nseg):
+    """Densidade espectral cruzada média (Welch, Hann, 50% de sobreposição)."""
+    janela = np.hanning(nseg)
+    passo = nseg // 2
+    soma = None
+    n = 0
+    for ini in range(0, len(a) - nseg + 1, passo):
+        A = np.fft.rfft((a[ini:ini + nseg] - a[ini:ini + nseg].mean()) * janela)
+        B = np.fft.rfft((b[ini:ini + nseg] - b[ini:ini + nseg].mean()) * janela)
+        g = np.conj(A) * B
+        soma = g if soma is None else soma + g
+        n += 1
+    return np.fft.rfftfreq(nseg, 1.0 / fs), soma / n
+
+
+def resposta_em_frequencia(r, u, y, fs):
+    """Planta P = G_ry / G_ru e coerência r -> y."""
+    nseg = 1 << int(np.log2(max(64, len(r) // 4)))
+    f, G_ry = espectros_cruzados(r, y, fs, nseg)
+    _, G_ru = espectros_cruzados(r, u, fs, nseg)
+    _, G_rr = espectros_cruzados(r, r, fs, nseg)
+    _, G_yy = espectros_cruzados(y, y, fs, nseg)
+    P = G_ry / G_ru
+    coerencia = np.abs(G_ry) ** 2 / (G_rr.real * G_yy.real)
+    return f, P, coerencia
+
+
+def modelo(s, K, wn, zeta, tau):
+    return K * wn ** 2 * np.exp(-s * tau) / (s ** 2 + 2 * zeta * wn * s + wn ** 2)
+
+
+def ajustar_modelo(f, P, peso):
+    """Busca em grade (wn, zeta, tau) com K por mínimos quadrados ponderados, depois refina em volta."""
+    s = 2j * np.pi * f
+
+    def avaliar(wns, zetas, taus):
+        melhor = (np.inf, None)
+        W, Z = np.meshgrid(wns, zetas, indexing="ij")
+        for tau in taus:
+            M = W[..., None] ** 2 * np.exp(-s * tau) / (s ** 2 + 2 * Z[..., None] * W[..., None] * s + W[..., None] ** 2)
+            K = np.sum(peso * np.real(np.conj(M) * P), axis=-1) / np.sum(peso * np.abs(M) ** 2, axis=-1)
+            custo = np.sum(peso * np.abs(P - K[..., None] * M) ** 2, axis=-1)
+            i = np.unravel_index(np.argmin(custo), custo.shape)
+            if custo[i] < melhor[0]:
+                melhor = (custo[i], (K[i], W[i], Z[i], tau))
+        return melhor[1]
+
+    wmin, wmax = 2 * np.pi * f[0], 2 * np.pi * f[-1]
+    K, wn, zeta, tau = avaliar(np.geomspace(wmin, wmax, 60), np.geomspace(0.02, 3.0, 40), np.linspace(0.0, 0.01, 21))
+    return avaliar(np.geomspace(wn / 1.1, wn * 1.1, 21), np.geomspace(zeta / 1.15, zeta * 1.15, 21),
+                   np.linspace(max(0.0, tau - 0.0005), tau + 0.0005, 11))
+
+
+def margem_de_fase(f, P, fs, kp, ki, kd):
+    """Malha aberta L = C(s) * P(s) / s (o PID fecha no ângulo, integral da taxa)."""
+    s = 2j * np.pi * f
+    a = -fs * np.log(1.0 - ALFA_DERIVADA)
+    L = (kp + ki / s + kd * s * a / (s + a)) * P / s
+    cruza = np.where(np.diff(np.sign(np.abs(L) - 1.0)) != 0)[0]
+    if len(cruza) == 0:
+        return None, None
+    i = cruza[0]
+    return f[i], 180.0 + np.degrees(np.angle(L[i]))
+
+
+def salvar_csv(nome, cabecalho, linhas):
+    with open(nome, "w", newline="", encoding="utf-8") as arq:
+        escritor = csv.writer(arq)
+        escritor.writerow(cabecalho)
+        escritor.writerows(linhas)
+    print("Salvo:", nome)
+
+
+def main():
+    """Pede a identificação, espera a gravação e mostra o resultado."""
+
+    p = argparse.ArgumentParser(description="Identificação da planta do gimbal via MQTT")
+    p.add_argument("--eixo", choices=["pitch", "roll"], default="pitch")
+    p.add_argument("--sinal", choices=["chirp", "prbs"], default="chirp")
+    p.add_argument("--amplitude", type=float, default=0.5, help="Mesma unidade da saída do PID")
+    p.add_argument("--f0", type=float, default=1.0)
+    p.add_argument("--f1", type=float, default=200.0)
+    p.add_argument("--duracao", type=float, default=4.0)
+    p.add_argument("--kp", type=float, default=8.0, help="Ganhos do PID para a margem de fase")
+    p.add_argument("--ki", type=float, default=0.01)
+    p.add_argument("--kd", type=float, default=1.0)
+    p.add_argument("--coerencia-min", type=float, default=0.6, help="Pontos abaixo disso ficam fora do ajuste")
+    p.add_argument("--grafico", action="store_true", help="Mostra o diagrama de Bode (requer matplotlib)")
+    args = p.parse_args()
+
+    gravacao = Gravacao()
+    client = mqtt.Client()
+    if USUARIO_MQTT or SENHA_MQTT:
+        client.username_pw_set(USUARIO_MQTT, SENHA_MQTT)
+    client.tls_set(tls_version=ssl.PROTOCOL_TLS_CLIENT)
+    client.tls_insecure_set(False)
+
+    def on_connect(cli, userdata, flags, rc, properties=None):
+        print("Conectado ao MQTT, rc =", rc)
+        cli.subscribe(TOPICO_IDENT, qos=1)
+        pedido = {"ident": {"eixo": args.eixo, "sinal": args.sinal, "amplitude": args.amplitude,
+                            "f0": args.f0, "f1": args.f1, "duracao": args.duracao}}
+        cli.publish(TOPICO_CMD, json.dumps(pedido), qos=1)
+
+    def on_message(cli, userdata, msg):
+        try:
+            gravacao.receber(json.loads(msg.payload.decode("utf-8")))
+        except Exception as e:
+            print("Mensagem inválida:", e)
+
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.connect(SERVIDOR_MQTT, PORTA_MQTT, MANTER_VIVO)
+    client.loop_start()
+
+    if not gravacao.completa.wait(timeout=args.duracao + 60.0):
+        client.loop_stop()
+        print("Tempo esgotado esperando a gravação.")
+        return
+    client.loop_stop()
+    client.disconnect()
+
+    fs = float(gravacao.cabecalho["fs"])
+    r, u, y = gravacao.sinais()
+    carimbo = datetime.now().strftime("%Y%m%d_%H%M%S")
+    base = f"identificacao_{args.eixo}_{carimbo}"
+    salvar_csv(base + "_bruto.csv", ["t", "r", "u", "y_rad_s"],
+               zip(np.arange(len(r)) / fs, r, u, y))
+
+    f, P, coerencia = resposta_em_frequencia(r, u, y, fs)
+    banda = (f >= args.f0) & (f <= args.f1)
+    f, P, coerencia = f[banda], P[banda], coerencia[banda]
+    peso = np.where(coerencia >= args.coerencia_min, coerencia, 0.0)
+    if not np.any(peso):
+        print("Coerência baixa em toda a banda: aumente a amplitude ou a duração.")
+        return
+
+    K, wn, zeta, tau = ajustar_modelo(f, P, peso)
+    M = modelo(2j * np.pi * f, K, wn, zeta, tau)
+    print(f"Modelo: K = {K:.4f}, fn = {wn / (2 * np.pi):.1f} Hz, zeta = {zeta:.3f}, atraso = {tau * 1000:.2f} ms")
+
+    fc, mf = margem_de_fase(f, P, fs, args.kp, args.ki, args.kd)
+    if fc is None:
+        print("Sem cruzamento de ganho na banda medida.")
+    else:
+        print(f"PID kp={args.kp} ki={args.ki} kd={args.kd}: cruzamento em {fc:.1f} Hz, margem de fase {mf:.1f} graus")
+
+    salvar_csv(base + "_bode.csv",
+               ["f_hz", "mag_db", "fase_graus", "coerencia", "modelo_mag_db", "modelo_fase_graus"],
+               zip(f, 20 * np.log10(np.abs(P)), np.degrees(np.unwrap(np.angle(P))), coerencia,
+                   20 * np.log10(np.abs(M)), np.degrees(np.unwrap(np.angle(M)))))
+
+    if args.grafico:
+        import matplotlib.pyplot as plt
+        fig, (ax_m, ax_f, ax_c) = plt.subplots(3, 1, sharex=True)
+        ax_m.semilogx(f, 20 * np.log10(np.abs(P)), label="medido")
+        ax_m.semilogx(f, 20 * np.log10(np.abs(M)), "--", label="modelo")
+        ax_m.set_ylabel("Módulo (dB)")
+        ax_m.legend()
+        ax_f.semilogx(f, np.degrees(np.unwrap(np.angle(P))))
+        ax_f.semilogx(f, np.degrees(np.unwrap(np.angle(M))), "--")
+        ax_f.set_ylabel("Fase (graus)")
+        ax_c.semilogx(f, coerencia)
+        ax_c.set_ylabel("Coerência")
+        ax_c.set_xlabel("Frequência (Hz)")
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
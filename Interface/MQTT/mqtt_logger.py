@@ -3,76 +3,142 @@ Logger MQTT do gimbal.
 
 Conecta ao broker, assina o tópico de log (`gimbal/log`)
 e grava as mensagens recebidas em um arquivo CSV (`gimbal_logs.csv`).
+Com --telemetria, grava também a telemetria (`gimbal_telemetria.csv`).
+
+Os registros levam o instante do ESP32 (`t_us`), convertido para o relógio
+do PC pela sincronia de relógio (MQTT/relogio.py), além da hora de chegada.
+--grafico mostra a telemetria gravada no tempo do ESP32 ao sair.
 """
+import argparse
 import json
 import csv
 import os
+import threading
 from datetime import datetime
 import ssl
 import paho.mqtt.client as mqtt
 
 from MQTT.config import (
-    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO,
+    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO, TOPICO_CMD, TOPICO_TEL,
 )
+from MQTT.relogio import SincronizadorRelogio, manter_sincronia, TOPICO_PONG
 
 # Tópico em que o ESP32 publica os logs
 TOPIC_LOG = "gimbal/log"
 
-# Arquivo CSV onde os logs serão guardados
+# Arquivos CSV onde os logs e a telemetria serão guardados
 CSV_PATH = "gimbal_logs.csv"
+CSV_TELEMETRIA = "gimbal_telemetria.csv"
 
 csv_file = None
 csv_writer = None
+tel_file = None
+tel_writer = None
+relogio = SincronizadorRelogio()
+parar_pings = threading.Event()
+serie = []      # (t_esp_s, pitch, roll) para o gráfico
+
+def abrir_csv(caminho, cabecalho):
+    """Abre ou cria um .CSV, escrevendo o cabeçalho se for novo."""
+
+    file_exists = os.path.exists(caminho)
+    arquivo = open(caminho, "a", newline="", encoding="utf-8")
+    writer = csv.writer(arquivo)
+    if not file_exists:
+        writer.writerow(cabecalho)
+        arquivo.flush()
+    return arquivo, writer
 
-def setup_csv(): 
-    """Abre ou cria o .CSV"""
+def setup_csv(telemetria=False):
+    """Abre ou cria os .CSV (colunas novas no fim, compatível com os arquivos antigos)"""
 
-    global csv_file, csv_writer
-    file_exists = os.path.exists(CSV_PATH)
+    global csv_file, csv_writer, tel_file, tel_writer
+    csv_file, csv_writer = abrir_csv(CSV_PATH, ["timestamp_pc", "level", "tag", "message", "timestamp_esp", "t_esp_us"])
+    if telemetria:
+        tel_file, tel_writer = abrir_csv(CSV_TELEMETRIA, ["timestamp_esp", "t_esp_us", "pitch", "roll", "timestamp_pc"])
 
-    csv_file = open(CSV_PATH, "a", newline="", encoding="utf-8")
-    csv_writer = csv.writer(csv_file)
+def hora_esp(t_us):
+    """Instante do ESP32 no relógio de parede do PC (vazio antes da sincronia)."""
 
-    if not file_exists:
-        csv_writer.writerow(["timestamp_pc", "level", "tag", "message"])
-        csv_file.flush()
+    epoch = relogio.esp_para_epoch(float(t_us)) if t_us is not None else None
+    return datetime.fromtimestamp(epoch).isoformat(timespec="milliseconds") if epoch is not None else ""
 
 def on_connect(client, userdata, flags, rc, properties=None):
     """Callback chamado quando conecta ao broker MQTT."""
 
     print("Conectado ao MQTT, rc =", rc)
     client.subscribe(TOPIC_LOG, qos=0)
+    client.subscribe(TOPICO_PONG, qos=0)
+    if tel_writer is not None:
+        client.subscribe(TOPICO_TEL, qos=0)
+    manter_sincronia(lambda obj: client.publish(TOPICO_CMD, json.dumps(obj), qos=0), relogio, parar_pings)
 
 
 def on_message(client, userdata, msg):
-    """Callback chamado quando chega mensagem no topico de log."""
+    """Callback chamado quando chega mensagem no topico de log, de telemetria ou de pong."""
 
     global csv_writer, csv_file
 
-    timestamp = datetime.now().isoformat(timespec="seconds")
+    if msg.topic == TOPICO_PONG:
+        relogio.receber_pong(json.loads(msg.payload.decode("utf-8")))
+        return
+
+    timestamp = datetime.now().isoformat(timespec="milliseconds")
 
+    if msg.topic == TOPICO_TEL:
+        data = json.loads(msg.payload.decode("utf-8"))
+        if "pitch" in data and "t_us" in data:
+            tel_writer.writerow([hora_esp(data["t_us"]), data["t_us"], data["pitch"], data["roll"], timestamp])
+            tel_file.flush()
+            serie.append((data["t_us"] / 1e6, data["pitch"], data["roll"]))
+        return
+
+    t_us = None
     try:
         payload = msg.payload.decode("utf-8")
         data = json.loads(payload)
         level = data.get("level", "INFO")
         tag   = data.get("tag", "")
         text  = data.get("msg", "")
+        t_us  = data.get("t_us")
     except Exception:
         level = "INFO"
         tag   = ""
         text  = msg.payload.decode("utf-8", errors="ignore")
 
     # Grava no arquivo
-    csv_writer.writerow([timestamp, level, tag, text])
+    timestamp_esp = hora_esp(t_us)
+    csv_writer.writerow([timestamp, level, tag, text, timestamp_esp, t_us if t_us is not None else ""])
     csv_file.flush()
 
-    # Mostra no terminal
-    print(timestamp, level, tag, text)
+    # Mostra no terminal (tempo do ESP32 quando já sincronizado)
+    print(timestamp_esp or timestamp, level, tag, text)
+
+def mostrar_grafico():
+    """Telemetria gravada, no tempo do ESP32."""
+
+    if not serie:
+        print("Nenhuma telemetria gravada.")
+        return
+    import matplotlib.pyplot as plt
+    t0 = serie[0][0]
+    plt.plot([s[0] - t0 for s in serie], [s[1] for s in serie], label="pitch")
+    plt.plot([s[0] - t0 for s in serie], [s[2] for s in serie], label="roll")
+    plt.xlabel("tempo do ESP32 (s)")
+    plt.ylabel("ângulo (°)")
+    plt.legend()
+    plt.grid(True)
+    plt.show()
 
 def main():
     """Configura o CSV, conecta ao broker e entra no loop de mensagens."""
 
-    setup_csv()
+    p = argparse.ArgumentParser(description="Logger MQTT do gimbal")
+    p.add_argument("--telemetria", action="store_true", help=f"Grava também a telemetria em {CSV_TELEMETRIA}")
+    p.add_argument("--grafico", action="store_true", help="Mostra a telemetria ao sair (requer matplotlib)")
+    args = p.parse_args()
+
+    setup_csv(telemetria=args.telemetria or args.grafico)
     client = mqtt.Client()
 
     # Usuario/senha definidos no config
@@ -87,7 +153,13 @@ def main():
     client.on_message = on_message
 
     client.connect(SERVIDOR_MQTT, PORTA_MQTT, MANTER_VIVO)
-    client.loop_forever()
+    try:
+        client.loop_forever()
+    except KeyboardInterrupt:
+        pass
+    parar_pings.set()
+    if args.grafico:
+        mostrar_grafico()
 
 if __name__ == "__main__":
     main()
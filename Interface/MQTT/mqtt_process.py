@@ -12,6 +12,7 @@ import time
 import signal
 import traceback
 from MQTT.cliente import ConexaoGimbalMQTT
+from MQTT.config import STREAM_SETPOINT, STREAM_HZ, STREAM_MANTER_S
 
 def run_mqtt(cmd_queue: mp.Queue, tel_queue: mp.Queue, ctl_queue: mp.Queue = None):
     """
@@ -34,6 +35,8 @@ def run_mqtt(cmd_queue: mp.Queue, tel_queue: mp.Queue, ctl_queue: mp.Queue = Non
             if "__log__" in d:
                 payload = d.get("__log__", {})
                 tel_queue.put_nowait({"type": "log", "data": payload})
+            elif "__tel_estado__" in d:
+                tel_queue.put_nowait({"type": "tel_estado", "data": d["__tel_estado__"]})
             else:
                 tel_queue.put_nowait({"type": "telemetry", "data": d})
         except Exception:
@@ -70,6 +73,11 @@ def run_mqtt(cmd_queue: mp.Queue, tel_queue: mp.Queue, ctl_queue: mp.Queue = Non
             except Exception:
                 pass
 
+    # Streaming: último valor do slider e instantes da última mudança/envio
+    ultimo_cmd = None
+    ultima_mudanca = 0.0
+    ultimo_envio = 0.0
+
     try:
         while True:
 
@@ -93,14 +101,23 @@ def run_mqtt(cmd_queue: mp.Queue, tel_queue: mp.Queue, ctl_queue: mp.Queue = Non
                             tel_queue.put_nowait({"type": "error", "msg": "reconnect failed"})
                         except Exception:
                             pass
+                elif isinstance(ctl, dict) and "rajada_s" in ctl:
+                    # Rajada de telemetria pedida pela GUI
+                    try:
+                        mqtt.pedir_rajada(float(ctl["rajada_s"]))
+                    except Exception:
+                        pass
 
             # Pega comandos vindos da GUI (pitch/roll)
             try:
-                cmd = cmd_queue.get(timeout=0.1)
+                cmd = cmd_queue.get(timeout=0.005 if STREAM_SETPOINT else 0.1)
             except Exception:
                 cmd = None
 
-            if cmd is not None:
+            if cmd is not None and STREAM_SETPOINT:
+                ultimo_cmd = cmd
+                ultima_mudanca = time.monotonic()
+            elif cmd is not None:
                 try:
                     mqtt.publish_cmd(cmd, debounce=True)
                 except Exception as e:
@@ -109,7 +126,17 @@ def run_mqtt(cmd_queue: mp.Queue, tel_queue: mp.Queue, ctl_queue: mp.Queue = Non
                     except Exception:
                         pass
 
-            time.sleep(0.01)
+            # Envia a STREAM_HZ enquanto o slider se move (e um pouco depois, para o ESP32 fechar no valor final)
+            if STREAM_SETPOINT and ultimo_cmd is not None:
+                agora = time.monotonic()
+                if agora - ultima_mudanca <= STREAM_MANTER_S and agora - ultimo_envio >= 1.0 / STREAM_HZ:
+                    try:
+                        mqtt.publicar_stream(ultimo_cmd.get("pitch", 0.0), ultimo_cmd.get("roll", 0.0))
+                    except Exception:
+                        pass
+                    ultimo_envio = agora
+
+            time.sleep(0.001 if STREAM_SETPOINT else 0.01)
 
     except KeyboardInterrupt:
         pass
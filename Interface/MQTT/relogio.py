@@ -0,0 +1,139 @@
+"""
+Sincronia do relógio do ESP32 com o PC.
+
+A telemetria e os logs trazem `t_us` (esp_timer, us desde o boot do ESP32).
+Para mapear esse instante para o relógio do PC, o PC manda `{"ping": n}` em
+`gimbal/cmd` e o ESP32 responde em `gimbal/pong` com a chegada (`rx`) e a
+resposta (`tx`) no relógio dele. Como no NTP:
+
+    offset = ((rx - t0) + (tx - t3)) / 2      (ESP32 - PC)
+    rtt    = (t3 - t0) - (tx - rx)
+
+O erro de cada amostra é no máximo rtt/2 (assimetria da rede), então só a
+amostra de menor RTT de cada trecho da janela entra na estimativa, e uma reta
+offset(t) acompanha a deriva entre os cristais.
+"""
+import threading
+import time
+from collections import deque
+from typing import Callable, Optional
+
+# Tópico em que o ESP32 responde aos pings
+TOPICO_PONG = "gimbal/pong"
+
+# Pings: rajada na conexão, depois periódico
+PINGS_INICIAIS = 10
+INTERVALO_INICIAL_S = 0.2
+INTERVALO_PING_S = 2.0
+
+# Estimativa
+JANELA_AMOSTRAS = 64
+TRECHOS_JANELA = 8          # A janela é dividida em trechos; o menor RTT de cada um entra no ajuste
+SPAN_MIN_DERIVA_US = 10e6   # Desvio-padrão mínimo dos instantes para estimar a deriva
+SALTO_REINICIO_US = 1e6     # Offset que muda mais que isso = ESP32 reiniciou
+
+
+def _agora_us() -> float:
+    return time.monotonic() * 1e6
+
+
+class SincronizadorRelogio:
+    """Estima o offset (e a deriva) entre o relógio do ESP32 e o do PC."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._n = 0
+        self._pendentes = {}
+        self._amostras = deque(maxlen=JANELA_AMOSTRAS)    # (t_pc_us, offset_us, rtt_us)
+        self._a = None          # offset em t_ref (us)
+        self._b = 0.0           # deriva (us/us)
+        self._t_ref = 0.0
+        self.incerteza_us = None
+
+        # Âncora monotônico -> relógio de parede (para datas nos CSVs)
+        self._mono0 = time.monotonic()
+        self._parede0 = time.time()
+
+    @property
+    def sincronizado(self) -> bool:
+        return self._a is not None
+
+    def novo_ping(self) -> dict:
+        """Comando de ping a publicar em gimbal/cmd."""
+        with self._lock:
+            self._n += 1
+            self._pendentes[self._n] = _agora_us()
+            if len(self._pendentes) > 32:
+                self._pendentes.pop(min(self._pendentes))
+            return {"ping": self._n}
+
+    def receber_pong(self, dados: dict):
+        t3 = _agora_us()
+        with self._lock:
+            t0 = self._pendentes.pop(int(dados.get("ping", -1)), None)
+            if t0 is None:
+                return
+            rx, tx = float(dados["rx"]), float(dados["tx"])
+            rtt = (t3 - t0) - (tx - rx)
+            offset = ((rx - t0) + (tx - t3)) / 2.0
+
+            if self._a is not None and abs(offset - self._offset_em((t0 + t3) / 2.0)) > SALTO_REINICIO_US:
+                self._amostras.clear()  # Relógio do ESP32 recomeçou do zero
+            self._amostras.append(((t0 + t3) / 2.0, offset, rtt))
+            self._ajustar()
+
+    def _offset_em(self, t_pc_us: float) -> float:
+        return self._a + self._b * (t_pc_us - self._t_ref)
+
+    def _ajustar(self):
+        # Menor RTT de cada trecho da janela: poucas amostras boas, mas espalhadas no tempo
+        amostras = list(self._amostras)
+        passo = max(1, len(amostras) // TRECHOS_JANELA)
+        boas = [min(amostras[i:i + passo], key=lambda a: a[2]) for i in range(0, len(amostras), passo)]
+        self._t_ref = amostras[-1][0]
+        self.incerteza_us = sum(r for _, _, r in boas) / len(boas) / 2.0
+
+        # Reta só com amostras espalhadas o bastante no tempo; senão a média
+        n = len(boas)
+        tm = sum(t for t, _, _ in boas) / n
+        om = sum(o for _, o, _ in boas) / n
+        sxx = sum((t - tm) ** 2 for t, _, _ in boas)
+        if n >= 4 and sxx / n > SPAN_MIN_DERIVA_US ** 2:
+            self._b = sum((t - tm) * (o - om) for t, o, _ in boas) / sxx
+        else:
+            self._b = 0.0
+        self._a = om + self._b * (self._t_ref - tm)
+
+    def esp_para_pc_us(self, t_esp_us: float) -> Optional[float]:
+        """Instante do ESP32 no relógio monotônico do PC (us), ou None antes da sincronia."""
+        with self._lock:
+            if self._a is None:
+                return None
+            # t_pc = t_esp - offset(t_pc), com offset linear em t_pc
+            return (t_esp_us - self._a + self._b * self._t_ref) / (1.0 + self._b)
+
+    def esp_para_epoch(self, t_esp_us: float) -> Optional[float]:
+        """Instante do ESP32 em segundos desde a epoch (relógio de parede do PC)."""
+        t_pc = self.esp_para_pc_us(t_esp_us)
+        if t_pc is None:
+            return None
+        return self._parede0 + (t_pc / 1e6 - self._mono0)
+
+
+def manter_sincronia(publicar: Callable[[dict], None], sinc: SincronizadorRelogio,
+                     parar: threading.Event) -> threading.Thread:
+    """Thread que manda os pings (rajada inicial e depois periódicos) até `parar`."""
+
+    def laco():
+        enviados = 0
+        while not parar.is_set():
+            try:
+                publicar(sinc.novo_ping())
+            except Exception:
+                pass
+            enviados += 1
+            parar.wait(INTERVALO_INICIAL_S if enviados < PINGS_INICIAIS else INTERVALO_PING_S)
+
+    th = threading.Thread(target=laco, daemon=True)
+    th.start()
+    return th
@@ -0,0 +1,175 @@
+"""
+Roteiro de movimentos executado no próprio ESP32.
+
+Compila um roteiro legível (JSON) para o formato compacto do firmware e envia
+uma única vez em `gimbal/cmd`; o ESP32 salva na NVS e executa na task_pid, sem
+depender da rede durante o movimento. O progresso chega em `gimbal/roteiro`.
+
+Formato do arquivo:
+    {
+      "repeticoes": 0,                      # 0 = infinito
+      "pontos": [
+        {"pitch": 0, "roll": 0, "duracao": 1.0},
+        {"pitch": 30, "roll": -20, "velocidade": 15, "espera": 2, "suavizacao": "minimo_jerk"},
+        {"varredura": {"pitch": [-20, 20], "roll": [-40, 40], "linhas": 3, "colunas": 5,
+                       "velocidade": 20, "espera": 0.5, "serpentina": true}}
+      ]
+    }
+Cada ponto usa "duracao" (s) ou "velocidade" (°/s); "espera" (s) e
+"suavizacao" (linear, suave, cosseno, minimo_jerk) são opcionais.
+
+Uso (dentro de Interface/):
+    python -m MQTT.roteiro varredura.json --iniciar --acompanhar
+    python -m MQTT.roteiro --parar
+"""
+import argparse
+import json
+import ssl
+import threading
+
+import paho.mqtt.client as mqtt
+
+from MQTT.config import (
+    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO, TOPICO_CMD,
+)
+
+# Tópico em que o ESP32 publica o progresso
+TOPICO_ROTEIRO = "gimbal/roteiro"
+
+# Limites do firmware (roteiro.h e MAX_ANGLE do PID)
+MAX_PONTOS = 64
+ANGULO_MAX = 84.0
+SUAVIZACOES = ["linear", "suave", "cosseno", "minimo_jerk"]
+FLAG_VELOCIDADE = 1
+TAMANHO_MAX_CMD = 2560            # .buffer.size do cliente MQTT do ESP32
+
+
+def compilar_ponto(ponto):
+    """Converte um ponto legível em [pitch_cgraus, roll_cgraus, movimento, espera_ms, suavizacao, flags]."""
+
+    pitch, roll = float(ponto["pitch"]), float(ponto["roll"])
+    if abs(pitch) > ANGULO_MAX or abs(roll) > ANGULO_MAX:
+        raise ValueError(f"Ângulo fora de ±{ANGULO_MAX}°: {ponto}")
+
+    if "velocidade" in ponto:
+        movimento, flags = round(float(ponto["velocidade"]) * 10), FLAG_VELOCIDADE
+        if movimento <= 0:
+            raise ValueError(f"Velocidade deve ser positiva: {ponto}")
+    else:
+        movimento, flags = round(float(ponto.get("duracao", 0.0)) * 1000), 0
+    espera = round(float(ponto.get("espera", 0.0)) * 1000)
+    if not 0 <= movimento <= 0xFFFF or not 0 <= espera <= 0xFFFF:
+        raise ValueError(f"Duração, velocidade ou espera fora do limite (65,5 s / 6553 °/s): {ponto}")
+
+    nome = ponto.get("suavizacao", "minimo_jerk")
+    if nome not in SUAVIZACOES:
+        raise ValueError(f"Suavização desconhecida: {nome}")
+
+    return [round(pitch * 100), round(roll * 100), movimento, espera, SUAVIZACOES.index(nome), flags]
+
+
+def expandir_varredura(v):
+    """Grade linhas x colunas sobre as faixas de pitch/roll, em serpentina por padrão."""
+
+    def faixa(lim, n):
+        a, b = float(lim[0]), float(lim[1])
+        return [a] if n <= 1 else [a + (b - a) * i / (n - 1) for i in range(n)]
+
+    comum = {k: v[k] for k in ("duracao", "velocidade", "espera", "suavizacao") if k in v}
+    pontos = []
+    for i, pitch in enumerate(faixa(v["pitch"], int(v.get("linhas", 2)))):
+        rolls = faixa(v["roll"], int(v.get("colunas", 2)))
+        if v.get("serpentina", True) and i % 2:
+            rolls.reverse()
+        pontos += [dict(comum, pitch=pitch, roll=roll) for roll in rolls]
+    return pontos
+
+
+def compilar(roteiro):
+    """Roteiro legível -> comando {"roteiro": {"pontos": [...], "repeticoes": N}}."""
+
+    pontos = []
+    for p in roteiro["pontos"]:
+        pontos += expandir_varredura(p["varredura"]) if "varredura" in p else [p]
+    if not 1 <= len(pontos) <= MAX_PONTOS:
+        raise ValueError(f"O roteiro tem {len(pontos)} pontos (1 a {MAX_PONTOS}).")
+
+    repeticoes = int(roteiro.get("repeticoes", 1))
+    if not 0 <= repeticoes <= 0xFFFF:
+        raise ValueError("Repetições fora de 0..65535.")
+    return {"pontos": [compilar_ponto(p) for p in pontos], "repeticoes": repeticoes}
+
+
+def main():
+    """Compila, envia e (opcionalmente) inicia e acompanha o roteiro."""
+
+    p = argparse.ArgumentParser(description="Roteiro de movimentos do gimbal via MQTT")
+    p.add_argument("arquivo", nargs="?", help="Roteiro em JSON (omitir para só iniciar/parar)")
+    p.add_argument("--iniciar", action="store_true", help="Inicia após o envio (ou o roteiro já salvo)")
+    p.add_argument("--parar", action="store_true")
+    p.add_argument("--acompanhar", action="store_true", help="Mostra o progresso até concluir")
+    p.add_argument("--mostrar", action="store_true", help="Só mostra o roteiro compilado, sem enviar")
+    args = p.parse_args()
+
+    comando = {}
+    if args.arquivo:
+        with open(args.arquivo, encoding="utf-8") as f:
+            comando = compilar(json.load(f))
+        tamanho = len(json.dumps({"roteiro": comando}, separators=(",", ":")))
+        print(f"{len(comando['pontos'])} pontos, {comando['repeticoes']} repetições ({tamanho} bytes).")
+        if tamanho > TAMANHO_MAX_CMD:
+            p.error(f"Comando maior que {TAMANHO_MAX_CMD} bytes.")
+    if args.mostrar:
+        print(json.dumps({"roteiro": comando}, separators=(",", ":")))
+        return
+    if args.iniciar or args.parar:
+        comando["acao"] = "iniciar" if args.iniciar else "parar"
+    if not comando:
+        p.error("Nada a enviar: informe um arquivo, --iniciar ou --parar.")
+
+    concluido = threading.Event()
+    client = mqtt.Client(userdata={"executou": False})
+    if USUARIO_MQTT or SENHA_MQTT:
+        client.username_pw_set(USUARIO_MQTT, SENHA_MQTT)
+    client.tls_set(tls_version=ssl.PROTOCOL_TLS_CLIENT)
+    client.tls_insecure_set(False)
+
+    def on_connect(cli, userdata, flags, rc, properties=None):
+        print("Conectado ao MQTT, rc =", rc)
+        if args.acompanhar:
+            cli.subscribe(TOPICO_ROTEIRO)
+        cli.publish(TOPICO_CMD, json.dumps({"roteiro": comando}, separators=(",", ":")), qos=1)
+
+    def on_publish(cli, userdata, mid, *resto):
+        if not args.acompanhar:
+            concluido.set()
+
+    def on_message(cli, userdata, msg):
+        try:
+            prog = json.loads(msg.payload.decode("utf-8"))
+        except Exception as e:
+            print("Mensagem inválida:", e)
+            return
+        voltas = prog["repeticoes"] or "∞"
+        print(f"{prog['estado']}: ponto {prog['ponto'] + 1}/{prog['n_pontos']}, volta {prog['volta'] + 1}/{voltas}")
+        # Termina ao concluir, ou ao parar depois de ter executado (o envio publica "parado" antes)
+        if prog["estado"] == "executando":
+            userdata["executou"] = True
+        elif prog["estado"] == "concluido" or userdata["executou"]:
+            concluido.set()
+
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.on_publish = on_publish
+    client.connect(SERVIDOR_MQTT, PORTA_MQTT, MANTER_VIVO)
+    client.loop_start()
+    try:
+        concluido.wait()
+    except KeyboardInterrupt:
+        pass
+    client.loop_stop()
+    client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
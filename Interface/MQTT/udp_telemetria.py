@@ -0,0 +1,174 @@
+"""
+Receptor da telemetria binária por UDP (rede local, sem TLS nem broker).
+
+O PC se registra no ESP32 pelo MQTT com {"telemetria":{"udp":{"host","porta","hz"}}} e
+renova o registro a cada RENOVAR_S (o ESP32 para de enviar se ficar UDP_LEASE_MS sem
+renovação). Comandos e logs continuam no MQTT.
+
+Datagrama (main/TELEMETRIA/udp_telemetria.h):
+    ['G']['T'][versao u8][reservado u8][seq u32 LE] + lote de codec_telemetria.h
+"seq" conta datagramas: lacunas são perdas, valores atrasados são reordenação.
+
+Uso (dentro de Interface/):
+    python -m MQTT.udp_telemetria --hz 200 --duracao 30
+    python -m MQTT.udp_telemetria --sem-mqtt      # só escuta (outro processo registra/envia)
+"""
+import argparse
+import json
+import socket
+import ssl
+import struct
+import threading
+import time
+
+import paho.mqtt.client as mqtt
+
+from MQTT.config import (
+    SERVIDOR_MQTT, PORTA_MQTT, USUARIO_MQTT, SENHA_MQTT, MANTER_VIVO, TOPICO_CMD,
+)
+from MQTT.codec_telemetria import DecodificadorTelemetria
+
+PORTA_PADRAO = 5005
+RENOVAR_S = 5.0             # Bem abaixo do UDP_LEASE_MS (15 s) do ESP32
+CABECALHO = struct.Struct("<2sBBI")
+VERSAO = 1
+
+
+def ip_local(destino: str = SERVIDOR_MQTT) -> str:
+    """IP da interface usada para chegar ao destino (nada é enviado)."""
+    for alvo in (destino, "8.8.8.8"):
+        try:
+            with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+                s.connect((alvo, 80))
+                return s.getsockname()[0]
+        except OSError:
+            continue
+    return "127.0.0.1"
+
+
+class ReceptorUDP:
+    """Conta datagramas, perdas e reordenação pelo seq e decodifica os lotes."""
+
+    def __init__(self):
+        self.decodificador = DecodificadorTelemetria()
+        self._proximo = None
+        self.pacotes = self.bytes = 0
+        self.perdidos = self.atrasados = self.invalidos = 0
+        self._janela = [time.monotonic(), 0, 0, 0]     # inicio, pacotes, bytes, amostras
+
+    def receber(self, dados: bytes):
+        """Lista de amostras do datagrama (vazia se atrasado ou inválido)."""
+
+        if len(dados) < CABECALHO.size:
+            self.invalidos += 1
+            return []
+        magica, versao, _, seq = CABECALHO.unpack_from(dados)
+        if magica != b"GT" or versao != VERSAO:
+            self.invalidos += 1
+            return []
+
+        if self._proximo is not None:
+            lacuna = (seq - self._proximo) & 0xFFFFFFFF
+            if lacuna >= 0x80000000:
+                # Atrasado: já contado como perdido na lacuna; o decodificador passou dessas amostras
+                if seq != 0:
+                    self.atrasados += 1
+                    self.perdidos = max(0, self.perdidos - 1)
+                    return []
+                self._proximo = None        # ESP32 reiniciou
+            else:
+                self.perdidos += lacuna
+        self._proximo = (seq + 1) & 0xFFFFFFFF
+
+        try:
+            amostras = self.decodificador.decodificar(dados[CABECALHO.size:])
+        except (ValueError, IndexError):
+            self.invalidos += 1
+            return []
+        self.pacotes += 1
+        self.bytes += len(dados)
+        self._janela[1] += 1
+        self._janela[2] += len(dados)
+        self._janela[3] += len(amostras)
+        return amostras
+
+    def taxa(self) -> str:
+        """Vazão desde a última chamada."""
+        agora = time.monotonic()
+        inicio, pacotes, bytes_, amostras = self._janela
+        dt = max(agora - inicio, 1e-6)
+        self._janela = [agora, 0, 0, 0]
+        return f"{pacotes / dt:6.1f} pacotes/s  {amostras / dt:6.1f} amostras/s  {bytes_ / dt / 1000:6.2f} kB/s"
+
+    def relatorio(self) -> str:
+        total = self.pacotes + self.perdidos
+        perda = 100.0 * self.perdidos / total if total else 0.0
+        return (f"{self.pacotes} pacotes ({self.bytes} bytes); {self.perdidos} perdidos ({perda:.2f}%), "
+                f"{self.atrasados} fora de ordem, {self.invalidos} inválidos\n"
+                + self.decodificador.relatorio())
+
+
+def main():
+    """Registra o PC no ESP32, recebe por um tempo e mostra vazão e perdas."""
+
+    p = argparse.ArgumentParser(description="Telemetria do gimbal por UDP")
+    p.add_argument("--porta", type=int, default=PORTA_PADRAO)
+    p.add_argument("--host", default=None, help="IP deste PC visto pelo ESP32 (padrão: detecta)")
+    p.add_argument("--hz", type=int, default=200, help="Taxa pedida ao ESP32")
+    p.add_argument("--duracao", type=float, default=30.0)
+    p.add_argument("--sem-mqtt", action="store_true", help="Só escuta, sem registrar pelo MQTT")
+    args = p.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+    sock.bind(("0.0.0.0", args.porta))
+    sock.settimeout(0.2)
+
+    parar = threading.Event()
+    client = None
+    if not args.sem_mqtt:
+        host = args.host or ip_local()
+        registro = json.dumps({"telemetria": {"udp": {"host": host, "porta": args.porta, "hz": args.hz}}})
+        client = mqtt.Client()
+        if USUARIO_MQTT or SENHA_MQTT:
+            client.username_pw_set(USUARIO_MQTT, SENHA_MQTT)
+        client.tls_set(tls_version=ssl.PROTOCOL_TLS_CLIENT)
+        client.tls_insecure_set(False)
+        client.connect(SERVIDOR_MQTT, PORTA_MQTT, MANTER_VIVO)
+        client.loop_start()
+
+        def renovar():
+            while not parar.is_set():
+                client.publish(TOPICO_CMD, registro, qos=1)
+                parar.wait(RENOVAR_S)
+
+        threading.Thread(target=renovar, daemon=True).start()
+        print(f"Registrando {host}:{args.porta} a {args.hz} Hz")
+
+    rx = ReceptorUDP()
+    fim = time.monotonic() + args.duracao
+    proximo_relatorio = time.monotonic() + 1.0
+    try:
+        while time.monotonic() < fim:
+            try:
+                dados, _ = sock.recvfrom(2048)
+                rx.receber(dados)
+            except socket.timeout:
+                pass
+            if time.monotonic() >= proximo_relatorio:
+                proximo_relatorio += 1.0
+                print(rx.taxa(), f"  perdidos {rx.perdidos}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        parar.set()
+        if client is not None:
+            client.publish(TOPICO_CMD, json.dumps({"telemetria": {"udp": False}}), qos=1).wait_for_publish()
+            client.loop_stop()
+            client.disconnect()
+        sock.close()
+    print(rx.relatorio())
+
+
+if __name__ == "__main__":
+    main()
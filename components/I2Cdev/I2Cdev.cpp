@@ -31,18 +31,60 @@ THE SOFTWARE.
 ===============================================
 */
 
+#include <string.h>
 #include <esp_log.h>
 #include <esp_err.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include "sdkconfig.h"
 
 #include "I2Cdev.h"
 
 #define I2C_NUM I2C_NUM_0
 
-#undef ESP_ERROR_CHECK
-#define ESP_ERROR_CHECK(x)   do { esp_err_t rc = (x); if (rc != ESP_OK) { ESP_LOGE("err", "esp_err_t = %d", rc); /*assert(0 && #x);*/} } while(0);
+#define I2CDEV_MAX_DEVICES          4
+#define I2CDEV_RECOVERY_ERRORS      3   // consecutive failures before a bus reset
+
+static const char *TAG = "I2Cdev";
+
+/** Bus traffic counters, updated by the caller's task and the async worker
+ * (statsMux).
+ */
+static I2CdevStats stats = {};
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+/** Held for each transfer and while a device handle is replaced; guards the
+ * device table and consecutiveErrors.
+ */
+static SemaphoreHandle_t busMutex = NULL;
+
+static i2c_master_bus_handle_t bus = NULL;
+static uint32_t busSpeed = 400000;
+static struct {
+    uint8_t address;
+    i2c_master_dev_handle_t handle;
+} devices[I2CDEV_MAX_DEVICES];
+static uint8_t numDevices = 0;
+static uint8_t consecutiveErrors = 0;
+
+/** Pending asynchronous read, served by the worker task.
+ */
+typedef struct {
+    uint8_t devAddr;
+    uint8_t regAddr;
+    uint8_t length;
+    uint16_t timeout;
+    uint32_t seq;
+    TaskHandle_t requester;
+} AsyncRequest;
+
+static QueueHandle_t asyncQueue = NULL;
+static uint8_t asyncData[I2CDEV_ASYNC_MAX_LENGTH];
+static volatile esp_err_t asyncResult = ESP_OK;
+static volatile uint32_t asyncDoneSeq = 0;
+static uint32_t asyncSeq = 0;
 
 /** Default constructor.
  */
@@ -55,6 +97,139 @@ void I2Cdev::initialize() {
 
 }
 
+/** Worker task: runs queued reads and notifies the requesting task.
+ * The data stays in asyncData until the requester collects it.
+ */
+static void asyncWorker(void *) {
+    AsyncRequest req;
+    while (1) {
+        xQueueReceive(asyncQueue, &req, portMAX_DELAY);
+        asyncResult = I2Cdev::transfer(req.devAddr, &req.regAddr, 1, asyncData, req.length, req.timeout);
+        asyncDoneSeq = req.seq;
+        xTaskNotifyGive(req.requester);
+    }
+}
+
+/** Create the I2C0 master bus and the asynchronous read worker.
+ * The worker runs on the calling core, one priority level above the caller,
+ * so a queued read starts as soon as the caller blocks.
+ * @param sda SDA pin
+ * @param scl SCL pin
+ * @param speedHz SCL frequency for devices added from now on
+ * @return Result of i2c_new_master_bus
+ */
+esp_err_t I2Cdev::begin(gpio_num_t sda, gpio_num_t scl, uint32_t speedHz) {
+    i2c_master_bus_config_t conf = {};
+    conf.i2c_port = I2C_NUM;
+    conf.sda_io_num = sda;
+    conf.scl_io_num = scl;
+    conf.clk_source = I2C_CLK_SRC_DEFAULT;
+    conf.glitch_ignore_cnt = 7;
+    conf.flags.enable_internal_pullup = true;
+
+    esp_err_t rc = i2c_new_master_bus(&conf, &bus);
+    if (rc != ESP_OK) {
+        ESP_LOGE(TAG, "i2c_new_master_bus: %s", esp_err_to_name(rc));
+        return rc;
+    }
+    busSpeed = speedHz;
+
+    busMutex = xSemaphoreCreateMutex();
+    asyncQueue = xQueueCreate(1, sizeof(AsyncRequest));
+    xTaskCreatePinnedToCore(asyncWorker, "i2c_async", 2048, NULL, uxTaskPriorityGet(NULL) + 1, NULL, xPortGetCoreID());
+    return ESP_OK;
+}
+
+/** Device handle for an address, added to the bus on first use (busMutex held).
+ * @param devAddr I2C slave device address
+ * @return Handle, or NULL if the bus is not up or the table is full
+ */
+static i2c_master_dev_handle_t deviceHandle(uint8_t devAddr) {
+    for (int i = 0; i < numDevices; i++) {
+        if (devices[i].address == devAddr) return devices[i].handle;
+    }
+    if (bus == NULL || numDevices >= I2CDEV_MAX_DEVICES) return NULL;
+
+    i2c_device_config_t conf = {};
+    conf.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    conf.device_address = devAddr;
+    conf.scl_speed_hz = busSpeed;
+    if (i2c_master_bus_add_device(bus, &conf, &devices[numDevices].handle) != ESP_OK) return NULL;
+    devices[numDevices].address = devAddr;
+    return devices[numDevices++].handle;
+}
+
+/** Change the SCL frequency of a device (re-added to the bus).
+ * Waits for a transfer in flight (including one run by the async worker);
+ * a read still queued runs afterwards on the new handle.
+ * @param devAddr I2C slave device address
+ * @param speedHz New SCL frequency; also used for devices added later
+ * @return ESP_OK if the device handle was recreated
+ */
+esp_err_t I2Cdev::setSpeed(uint8_t devAddr, uint32_t speedHz) {
+    if (busMutex == NULL) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(busMutex, portMAX_DELAY);
+    busSpeed = speedHz;
+    for (int i = 0; i < numDevices; i++) {
+        if (devices[i].address != devAddr) continue;
+        i2c_master_bus_rm_device(devices[i].handle);
+        devices[i] = devices[--numDevices];
+        break;
+    }
+    bool ok = deviceHandle(devAddr) != NULL;
+    xSemaphoreGive(busMutex);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+/** Current SCL frequency for new devices.
+ */
+uint32_t I2Cdev::getSpeed() {
+    return busSpeed;
+}
+
+/** Queue a burst read served by the worker task.
+ * Only one read may be pending; collect it with waitAsync().
+ * @param devAddr I2C slave device address
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read (up to I2CDEV_ASYNC_MAX_LENGTH)
+ * @param timeout Transfer timeout in milliseconds
+ * @return false if a read is still queued or length is too large
+ */
+bool I2Cdev::readBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t timeout) {
+    if (asyncQueue == NULL || length == 0 || length > I2CDEV_ASYNC_MAX_LENGTH) return false;
+
+    AsyncRequest req = {devAddr, regAddr, length, timeout, ++asyncSeq, xTaskGetCurrentTaskHandle()};
+    return xQueueSend(asyncQueue, &req, 0) == pdTRUE;
+}
+
+/** Wait for the last queued read and copy its data.
+ * A read that misses the deadline is dropped; its late completion is
+ * ignored by the next wait.
+ * @param data Buffer for the bytes read
+ * @param length Number of bytes to copy
+ * @param waitMs Deadline in milliseconds
+ * @return ESP_OK, the transfer error, or ESP_ERR_TIMEOUT
+ */
+esp_err_t I2Cdev::waitAsync(uint8_t *data, uint8_t length, uint32_t waitMs) {
+    TickType_t start = xTaskGetTickCount();
+    TickType_t limit = pdMS_TO_TICKS(waitMs);
+    if (limit == 0) limit = 1;
+
+    while (asyncDoneSeq != asyncSeq) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= limit || ulTaskNotifyTake(pdTRUE, limit - elapsed) == 0) {
+            if (asyncDoneSeq == asyncSeq) break;
+            portENTER_CRITICAL(&statsMux);
+            stats.timeouts++;
+            portEXIT_CRITICAL(&statsMux);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    if (asyncResult == ESP_OK) memcpy(data, asyncData, length);
+    return asyncResult;
+}
+
 /** Enable or disable I2C
  * @param isEnabled true = enable, false = disable
  */
@@ -65,6 +240,82 @@ void I2Cdev::enable(bool isEnabled) {
 /** Default timeout value for read operations.
  */
 uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
+
+/** Copy the bus traffic counters.
+ * @param out Container for the counters
+ */
+void I2Cdev::getStats(I2CdevStats *out) {
+    portENTER_CRITICAL(&statsMux);
+    *out = stats;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+/** Zero the bus traffic counters.
+ */
+void I2Cdev::resetStats() {
+    portENTER_CRITICAL(&statsMux);
+    stats = I2CdevStats();
+    portEXIT_CRITICAL(&statsMux);
+}
+
+/** Run one bus transaction and account for its traffic.
+ * All bus access goes through here. Write-then-read uses a repeated start,
+ * so a register read is a single transaction. After I2CDEV_RECOVERY_ERRORS
+ * consecutive failures the bus is reset (SCL clocked to free a stuck SDA).
+ * @param devAddr I2C slave device address
+ * @param writeData Bytes to send (register address first), or NULL
+ * @param writeLength Number of bytes to send
+ * @param readData Buffer for the bytes read, or NULL
+ * @param readLength Number of bytes to read
+ * @param timeout Transfer timeout in milliseconds
+ * @return Result of the i2c_master call
+ */
+esp_err_t I2Cdev::transfer(uint8_t devAddr, const uint8_t *writeData, size_t writeLength, uint8_t *readData, size_t readLength, uint16_t timeout) {
+	if (busMutex == NULL) return ESP_ERR_INVALID_STATE;
+	xSemaphoreTake(busMutex, portMAX_DELAY);
+
+	i2c_master_dev_handle_t dev = deviceHandle(devAddr);
+	if (dev == NULL) {
+		xSemaphoreGive(busMutex);
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	esp_err_t rc;
+	uint32_t written;
+	if (readLength == 0) {
+		rc = i2c_master_transmit(dev, writeData, writeLength, timeout);
+		written = 1 + writeLength;
+	} else if (writeLength == 0) {
+		rc = i2c_master_receive(dev, readData, readLength, timeout);
+		written = 1;
+	} else {
+		rc = i2c_master_transmit_receive(dev, writeData, writeLength, readData, readLength, timeout);
+		written = 2 + writeLength;
+	}
+
+	bool reset = false;
+	if (rc == ESP_OK) {
+		consecutiveErrors = 0;
+	} else if (++consecutiveErrors >= I2CDEV_RECOVERY_ERRORS) {
+		consecutiveErrors = 0;
+		reset = true;
+		i2c_master_bus_reset(bus);
+	}
+	xSemaphoreGive(busMutex);
+
+	portENTER_CRITICAL(&statsMux);
+	stats.transactions++;
+	stats.bytesWritten += written;
+	stats.bytesRead += readLength;
+	if (rc != ESP_OK) stats.errors++;
+	if (rc == ESP_ERR_TIMEOUT) stats.timeouts++;
+	if (reset) stats.busResets++;
+	portEXIT_CRITICAL(&statsMux);
+
+	if (reset) ESP_LOGW(TAG, "Bus error (%s), resetting bus", esp_err_to_name(rc));
+	return rc;
+}
+
 /** Read a single bit from an 8-bit device register.
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to read from
@@ -127,42 +378,17 @@ int8_t I2Cdev::readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_
  * @return I2C_TransferReturn_TypeDef http://downloads.energymicro.com/documentation/doxygen/group__I2C.html
  */
 int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
-	i2c_cmd_handle_t cmd;
-	SelectRegister(devAddr, regAddr);
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_READ, 1));
-
-	if(length>1)
-		ESP_ERROR_CHECK(i2c_master_read(cmd, data, length-1, I2C_MASTER_ACK));
-
-	ESP_ERROR_CHECK(i2c_master_read_byte(cmd, data+length-1, I2C_MASTER_NACK));
-
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
-
-	return length;
+	return (transfer(devAddr, &regAddr, 1, data, length, timeout) == ESP_OK) ? length : 0;
 }
 
 bool I2Cdev::writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data){
 
 	uint8_t data1[] = {(uint8_t)(data>>8), (uint8_t)(data & 0xff)};
-	writeBytes(devAddr, regAddr, 2, data1);
-	return true;
+	return writeBytes(devAddr, regAddr, 2, data1);
 }
 
 void I2Cdev::SelectRegister(uint8_t dev, uint8_t reg){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (dev << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, reg, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+	transfer(dev, &reg, 1, NULL, 0, readTimeout);
 }
 
 /** write a single bit in an 8-bit device register.
@@ -174,7 +400,7 @@ void I2Cdev::SelectRegister(uint8_t dev, uint8_t reg){
  */
 bool I2Cdev::writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data) {
     uint8_t b;
-    readByte(devAddr, regAddr, &b);
+    if (readByte(devAddr, regAddr, &b) == 0) return false;
     b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
     return writeByte(devAddr, regAddr, b);
 }
@@ -215,18 +441,8 @@ bool I2Cdev::writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8
  * @return Status of operation (true = success)
  */
 bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
-
-	return true;
+	uint8_t buf[2] = {regAddr, data};
+	return transfer(devAddr, buf, 2, NULL, 0, readTimeout) == ESP_OK;
 }
 
 /** Write single byte to an 8-bit device register.
@@ -237,18 +453,10 @@ bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
  * @return Status of operation (true = success)
  */
 bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write(cmd, data, length-1, 0));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data[length-1], 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
-	return true;
+	uint8_t buf[1 + 255];
+	buf[0] = regAddr;
+	memcpy(buf + 1, data, length);
+	return transfer(devAddr, buf, 1 + length, NULL, 0, readTimeout) == ESP_OK;
 }
 
 
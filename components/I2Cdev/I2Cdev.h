@@ -34,7 +34,7 @@ THE SOFTWARE.
 #ifndef _I2CDEV_H_
 #define _I2CDEV_H_
 
-#include <driver/i2c.h>
+#include <driver/i2c_master.h>
 
 #define I2C_SDA_PORT gpioPortA
 #define I2C_SDA_PIN 0
@@ -46,7 +46,22 @@ THE SOFTWARE.
 #define I2C_SCL_MODE gpioModeWiredAnd
 #define I2C_SCL_DOUT 1
 
-#define I2CDEV_DEFAULT_READ_TIMEOUT 1000
+#define I2CDEV_DEFAULT_READ_TIMEOUT 10    // ms per transfer
+#define I2CDEV_ASYNC_MAX_LENGTH     32
+
+/** Bus traffic counters (one transaction = one i2c_master_transmit, _receive
+ * or _transmit_receive call; a register read is a single write-then-read
+ * transaction with a repeated start).
+ * Bytes include the address and register bytes sent on the wire.
+ */
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytesWritten;
+    uint32_t bytesRead;
+    uint32_t errors;
+    uint32_t timeouts;      // transfer timeouts and missed async deadlines
+    uint32_t busResets;
+} I2CdevStats;
 
 class I2Cdev {
     public:
@@ -54,6 +69,12 @@ class I2Cdev {
 
         static void initialize();
         static void enable(bool isEnabled);
+        static esp_err_t begin(gpio_num_t sda, gpio_num_t scl, uint32_t speedHz);
+        static esp_err_t setSpeed(uint8_t devAddr, uint32_t speedHz);
+        static uint32_t getSpeed();
+
+        static bool readBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t timeout=I2Cdev::readTimeout);
+        static esp_err_t waitAsync(uint8_t *data, uint8_t length, uint32_t waitMs);
 
         static int8_t readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
         //TODO static int8_t readBitW(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
@@ -75,9 +96,13 @@ class I2Cdev {
 
         static uint16_t readTimeout;
 
+        static void getStats(I2CdevStats *stats);
+        static void resetStats();
+
     //private:
         static void SelectRegister(uint8_t dev, uint8_t reg);
         //static I2C_TransferReturn_TypeDef transfer(I2C_TransferSeq_TypeDef *seq, uint16_t timeout=I2Cdev::readTimeout);
+        static esp_err_t transfer(uint8_t devAddr, const uint8_t *writeData, size_t writeLength, uint8_t *readData, size_t readLength, uint16_t timeout);
 };
 
 #endif /* _I2CDEV_H_ */
@@ -431,6 +431,13 @@ THE SOFTWARE.
 #define MPU6050_DMP_MEMORY_BANK_SIZE    256
 #define MPU6050_DMP_MEMORY_CHUNK_SIZE   16
 
+// Shadowed configuration registers: SMPLRT_DIV..ACCEL_CONFIG and USER_CTRL..PWR_MGMT_2
+#define MPU6050_SHADOW_CONFIG_SIZE      4
+#define MPU6050_SHADOW_POWER_SIZE       3
+
+// MeanFromFIFO gives up after this many ~70 ms batches with an empty FIFO
+#define MPU6050_FIFO_MAX_EMPTY_BATCHES  5
+
 // note: DMP code memory blocks defined at end of header file
 
 class MPU6050 {
@@ -443,6 +450,12 @@ class MPU6050 {
         void initialize();
         bool testConnection();
 
+        // Shadow registers
+        void refresh();
+        bool sync();
+        void setAutoSync(bool enabled);
+        bool getAutoSync();
+
         // AUX_VDDIO register
         uint8_t getAuxVDDIOLevel();
         void setAuxVDDIOLevel(uint8_t level);
@@ -1028,11 +1041,26 @@ class MPU6050 {
 
     void CalibrateGyro(uint8_t Loops = 15); // Fine tune after setting offsets with less Loops.
     void CalibrateAccel(uint8_t Loops = 15);// Fine tune after setting offsets with less Loops.
+    bool CalibrateFast(bool Accel = true, uint8_t Refinements = 1); // FIFO average + closed-form offsets, burst writes
+    bool MeanFromFIFO(float *Mean, uint16_t Samples);
     void PID(uint8_t ReadAddress, float kP,float kI, uint8_t Loops);  // Does the
 
     private:
         uint8_t devAddr;
         uint8_t buffer[14];
+
+        uint8_t shadow[MPU6050_SHADOW_CONFIG_SIZE + MPU6050_SHADOW_POWER_SIZE];
+        uint8_t shadowDirty;    // bit i = shadow[i] not yet written
+        bool shadowValid;
+        bool autoSync;
+
+        uint8_t shadowIndex(uint8_t regAddr);
+        int8_t shadowReadByte(uint8_t regAddr, uint8_t *data);
+        int8_t shadowReadBit(uint8_t regAddr, uint8_t bitNum, uint8_t *data);
+        int8_t shadowReadBits(uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data);
+        bool shadowWriteByte(uint8_t regAddr, uint8_t data);
+        bool shadowWriteBit(uint8_t regAddr, uint8_t bitNum, uint8_t data);
+        bool shadowWriteBits(uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data);
 };
 
 #endif /* _MPU6050_H_ */
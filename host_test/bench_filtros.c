@@ -0,0 +1,46 @@
+// host_test/bench_filtros.c
+// Custo por amostra da cadeia de biquads (DF2T) com 1, 2 e 3 estágios.
+// No PC serve para comparar versões do kernel; o valor no ESP32 é medido pelo perfil da task_mpu.
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "filtros.h"
+
+#define AMOSTRAS    (1 << 16)
+#define REPETICOES  200
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(void) {
+    static float entrada[AMOSTRAS];
+    for (int i = 0; i < AMOSTRAS; i++) {
+        entrada[i] = sinf(0.01f * i) + 0.3f * sinf(0.7f * i);
+    }
+
+    for (int estagios = 1; estagios <= FILTRO_MAX_ESTAGIOS; estagios++) {
+        for (int i = 0; i < FILTRO_MAX_ESTAGIOS; i++) {
+            filtros_definir_estagio(FILTRO_GIRO, i, i < estagios ? FILTRO_NOTCH : FILTRO_DESLIGADO,
+                                    100.0f + 50.0f * i, 4.0f);
+        }
+        cadeia_filtros_t c;
+        cadeia_iniciar(&c);
+        cadeia_sincronizar(&c, FILTRO_GIRO, 1000.0f);
+
+        volatile float dreno = 0.0f;    // Impede o compilador de descartar o laço
+        double t0 = agora_ns();
+        for (int r = 0; r < REPETICOES; r++) {
+            float acc = 0.0f;
+            for (int i = 0; i < AMOSTRAS; i++) acc += cadeia_aplicar(&c, entrada[i]);
+            dreno += acc;
+        }
+        double ns = (agora_ns() - t0) / ((double)AMOSTRAS * REPETICOES);
+        printf("%d estágio(s): %.2f ns/amostra (%.2f ns/biquad)\n", estagios, ns, ns / estagios);
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+// host_test/bench_i2c.cpp
+// Tráfego por chamada de alto nível do MPU6050: transações, bytes no fio e tempo de
+// fio a 400 kHz e 1 MHz (contadores do I2Cdev e do modelo de registradores).
+// Serve para medir mudanças no driver sem placa; não inclui a latência do periférico do ESP32.
+// A segunda tabela é o ciclo de leitura da task_mpu (giroscópio X/Y todo ciclo, bloco completo
+// a cada N), em média por ciclo.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos_host.h"
+#include "modelo_mpu6050.h"
+#include "MPU6050.h"
+
+#define ENDERECO    MPU6050_DEFAULT_ADDRESS
+#define CICLOS_TASK 840         // Múltiplo de todos os divisores medidos
+#define TAM_GIRO    4           // SensorMPU6050.cpp: TAM_LEITURA_GIRO / TAM_LEITURA_COMPLETA
+#define TAM_BLOCO   12
+
+static MPU6050 mpu;
+static uint8_t bloco[256];
+
+typedef struct {
+    const char *nome;
+    void (*chamar)(void);
+} chamada_t;
+
+static void motion6(void) {
+    int16_t ax, ay, az, gx, gy, gz;
+    mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+}
+static void rotacao(void) {
+    int16_t x, y, z;
+    mpu.getRotation(&x, &y, &z);
+}
+static void aceleracao(void) {
+    int16_t x, y, z;
+    mpu.getAcceleration(&x, &y, &z);
+}
+static void giro_assincrono(void) {
+    uint8_t dados[4];
+    I2Cdev::readBytesAsync(ENDERECO, MPU6050_RA_GYRO_XOUT_H, 4);
+    I2Cdev::waitAsync(dados, 4, 2);
+}
+static void int_status(void) { mpu.getIntStatus(); }
+static void contagem_fifo(void) { mpu.getFIFOCount(); }
+static void pacote_fifo(void) { mpu.getFIFOBytes(bloco, 12); }
+static void taxa(void) { mpu.setRate(4); }
+static void config_em_lote(void) {
+    mpu.setAutoSync(false);
+    mpu.setRate(0);
+    mpu.setDLPFMode(MPU6050_DLPF_BW_98);
+    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
+    mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_4);
+    mpu.setAutoSync(true);
+}
+static void config_bit_a_bit(void) {
+    I2Cdev::writeByte(ENDERECO, MPU6050_RA_SMPLRT_DIV, 0);
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, 2);
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, 1);
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, 1);
+}
+static void inicializar(void) { mpu.initialize(); }
+// initialize() de antes da sombra de registradores: um read-modify-write por campo
+static void inicializar_bit_a_bit(void) {
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH,
+                      MPU6050_CLOCK_PLL_XGYRO);
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH,
+                      MPU6050_GYRO_FS_250);
+    I2Cdev::writeBits(ENDERECO, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH,
+                      MPU6050_ACCEL_FS_2);
+    I2Cdev::writeBit(ENDERECO, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT, false);
+}
+static void escrever_dmp(void) { mpu.writeMemoryBlock(bloco, sizeof(bloco), 0, 0, false); }
+static void ler_dmp(void) { mpu.readMemoryBlock(bloco, sizeof(bloco), 0, 0); }
+static void calibrar_giro(void) { mpu.CalibrateFast(false, 0); }
+
+static const chamada_t CHAMADAS[] = {
+    { "getMotion6",                 motion6 },
+    { "getRotation",                rotacao },
+    { "getAcceleration",            aceleracao },
+    { "readBytesAsync(giro X/Y)",   giro_assincrono },
+    { "getIntStatus",               int_status },
+    { "getFIFOCount",               contagem_fifo },
+    { "getFIFOBytes(12)",           pacote_fifo },
+    { "setRate (auto-sync)",        taxa },
+    { "4 configs, sync em lote",    config_em_lote },
+    { "4 configs, I2Cdev direto",   config_bit_a_bit },
+    { "initialize",                 inicializar },
+    { "initialize, I2Cdev direto",  inicializar_bit_a_bit },
+    { "writeMemoryBlock(256)",      escrever_dmp },
+    { "readMemoryBlock(256)",       ler_dmp },
+    { "CalibrateFast(giro)",        calibrar_giro },
+};
+#define NUM_CHAMADAS (sizeof(CHAMADAS) / sizeof(CHAMADAS[0]))
+
+static void medir(const chamada_t *c, uint32_t hz, I2CdevStats *est, mpu_barramento_t *fio) {
+    modelo_mpu_iniciar(ENDERECO);
+    mpu = MPU6050(ENDERECO);
+    mpu.initialize();
+    I2Cdev::setSpeed(ENDERECO, hz);
+    I2Cdev::resetStats();
+    modelo_mpu_zerar_barramento();
+    c->chamar();
+    I2Cdev::getStats(est);
+    modelo_mpu_obter_barramento(fio);
+}
+
+// Leituras da task_mpu com o divisor do acelerômetro dado (1 = bloco completo todo ciclo)
+static void ciclos_task_mpu(uint8_t divisor, uint32_t hz, I2CdevStats *est, mpu_barramento_t *fio) {
+    modelo_mpu_iniciar(ENDERECO);
+    mpu = MPU6050(ENDERECO);
+    mpu.initialize();
+    I2Cdev::setSpeed(ENDERECO, hz);
+    I2Cdev::resetStats();
+    modelo_mpu_zerar_barramento();
+    uint8_t dados[TAM_BLOCO];
+    for (int i = 1; i <= CICLOS_TASK; i++) {
+        bool completa = (i % divisor) == 0;
+        uint8_t reg = completa ? MPU6050_RA_ACCEL_XOUT_H : MPU6050_RA_GYRO_XOUT_H;
+        uint8_t tamanho = completa ? TAM_BLOCO : TAM_GIRO;
+        I2Cdev::readBytesAsync(ENDERECO, reg, tamanho);
+        I2Cdev::waitAsync(dados, tamanho, 2);
+    }
+    I2Cdev::getStats(est);
+    modelo_mpu_obter_barramento(fio);
+}
+
+int main(void) {
+    I2Cdev::begin((gpio_num_t)21, (gpio_num_t)22, 400000);
+
+    printf("%-28s %6s %8s %8s %12s %12s\n", "chamada", "trans.", "escritos", "lidos", "fio 400k(us)", "fio 1M(us)");
+    for (size_t i = 0; i < NUM_CHAMADAS; i++) {
+        I2CdevStats est;
+        mpu_barramento_t fio_400k, fio_1m;
+        medir(&CHAMADAS[i], 1000000, &est, &fio_1m);
+        medir(&CHAMADAS[i], 400000, &est, &fio_400k);
+        printf("%-28s %6u %8u %8u %12lld %12lld\n", CHAMADAS[i].nome, (unsigned)est.transactions,
+               (unsigned)est.bytesWritten, (unsigned)est.bytesRead, (long long)fio_400k.tempo_us,
+               (long long)fio_1m.tempo_us);
+    }
+
+    static const uint8_t DIVISORES[] = { 1, 2, 4, 8 };
+    printf("\n%-28s %6s %8s %8s %12s %12s\n", "ciclo da task_mpu", "trans.", "escritos", "lidos", "fio 400k(us)",
+           "fio 1M(us)");
+    for (size_t i = 0; i < sizeof(DIVISORES); i++) {
+        I2CdevStats est;
+        mpu_barramento_t fio_400k, fio_1m;
+        ciclos_task_mpu(DIVISORES[i], 1000000, &est, &fio_1m);
+        ciclos_task_mpu(DIVISORES[i], 400000, &est, &fio_400k);
+        char nome[40];
+        snprintf(nome, sizeof(nome), "divisor %u (média/ciclo)", DIVISORES[i]);
+        printf("%-28s %6.2f %8.2f %8.2f %12.1f %12.1f\n", nome, (double)est.transactions / CICLOS_TASK,
+               (double)est.bytesWritten / CICLOS_TASK, (double)est.bytesRead / CICLOS_TASK,
+               (double)fio_400k.tempo_us / CICLOS_TASK, (double)fio_1m.tempo_us / CICLOS_TASK);
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+// host_test/bench_kalman.cpp
+// Custo de um ciclo da task_mpu no Kalman (predict + update dos dois eixos): KalmanBank<2>
+// contra dois KalmanFilter escalares, nos modos fixo e adaptativo.
+// No PC serve para comparar as duas formas; o valor no ESP32 é o perfil de ciclos da task_mpu.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "KalmanBank.h"
+#include "kalman_escalar.h"
+
+#define AMOSTRAS    (1 << 12)
+#define REPETICOES  2000
+#define DT          0.001f
+
+static float taxa[AMOSTRAS][2];
+static float medido[AMOSTRAS][2];
+static float desvio[AMOSTRAS];
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// Contador de ciclos da CPU, quando houver (0 nas outras arquiteturas)
+static uint64_t ciclos(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void medir(const char *nome, bool adaptativo, bool banco) {
+    KalmanBank<2> b;
+    KalmanFilter e[2];
+    b.adaptativo = e[0].adaptativo = e[1].adaptativo = adaptativo;
+
+    volatile float dreno = 0.0f;    // Impede o compilador de descartar o laço
+    double t0 = agora_ns();
+    uint64_t c0 = ciclos();
+    for (int r = 0; r < REPETICOES; r++) {
+        for (int i = 0; i < AMOSTRAS; i++) {
+            if (banco) {
+                b.predict(taxa[i], DT);
+                b.update(medido[i], desvio[i]);
+            } else {
+                for (int k = 0; k < 2; k++) {
+                    e[k].predict(taxa[i][k], DT);
+                    e[k].update(medido[i][k], desvio[i]);
+                }
+            }
+        }
+        dreno += banco ? b.angle[0] + b.angle[1] : e[0].angle + e[1].angle;
+    }
+    double n = (double)AMOSTRAS * REPETICOES;
+    double ns = (agora_ns() - t0) / n;
+    double cic = (ciclos() - c0) / n;
+    printf("%-24s %8.2f ns/ciclo %8.1f ciclos/ciclo\n", nome, ns, cic);
+}
+
+int main(void) {
+    for (int i = 0; i < AMOSTRAS; i++) {
+        taxa[i][0] = 0.3f * sinf(0.01f * i);
+        taxa[i][1] = 0.2f * cosf(0.013f * i);
+        medido[i][0] = 0.1f * sinf(0.002f * i) + 0.01f * sinf(0.9f * i);
+        medido[i][1] = 0.1f * cosf(0.003f * i) + 0.01f * sinf(1.3f * i);
+        desvio[i] = 0.05f * fabsf(sinf(0.05f * i));
+    }
+
+    // Um "ciclo" = predict + update nos dois eixos
+    medir("2x escalar, fixo", false, false);
+    medir("banco, fixo", false, true);
+    medir("2x escalar, adaptativo", true, false);
+    medir("banco, adaptativo", true, true);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// host_test/freertos_host.c
+// Tarefas, filas e notificações do FreeRTOS sobre pthreads, para os módulos que criam
+// tarefas (I2Cdev). O tempo é simulado: vTaskDelay só avança o relógio, então o teste
+// roda na velocidade da CPU e o resultado não depende da carga da máquina.
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos_host.h"
+
+#define PRIORIDADE_PRINCIPAL    5
+#define FOLGA_REAL_MS           250     // A outra thread roda em tempo real: sob carga (ctest -j) ela
+                                        // pode levar mais que o prazo simulado para ser escalonada
+
+struct tarefa_host_t {
+    TaskFunction_t funcao;
+    void *parametro;
+    UBaseType_t prioridade;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t notificacoes;
+};
+
+struct fila_host_t {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    UBaseType_t tamanho, tam_item, ocupados, inicio;
+    uint8_t *itens;
+};
+
+static int64_t s_agora_us = 0;
+static __thread struct tarefa_host_t *s_atual = NULL;
+
+int64_t freertos_host_agora_us(void) {
+    return __atomic_load_n(&s_agora_us, __ATOMIC_RELAXED);
+}
+
+void freertos_host_avancar_us(int64_t us) {
+    __atomic_add_fetch(&s_agora_us, us, __ATOMIC_RELAXED);
+}
+
+static struct tarefa_host_t *nova_tarefa(TaskFunction_t funcao, void *parametro, UBaseType_t prioridade) {
+    struct tarefa_host_t *t = calloc(1, sizeof(*t));
+    t->funcao = funcao;
+    t->parametro = parametro;
+    t->prioridade = prioridade;
+    pthread_mutex_init(&t->mutex, NULL);
+    pthread_cond_init(&t->cond, NULL);
+    return t;
+}
+
+static void *rodar_tarefa(void *arg) {
+    s_atual = arg;
+    s_atual->funcao(s_atual->parametro);
+    return NULL;
+}
+
+// Prazo absoluto em tempo real para as esperas com timeout (1 tick = 1 ms, mais a folga)
+static struct timespec prazo_ms(TickType_t ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ms += FOLGA_REAL_MS;
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// Espera na condição até o prazo; devolve false se o prazo venceu (e o relógio simulado anda o prazo)
+static int esperar(pthread_cond_t *cond, pthread_mutex_t *mutex, TickType_t espera, const struct timespec *prazo) {
+    if (espera == portMAX_DELAY) {
+        pthread_cond_wait(cond, mutex);
+        return 1;
+    }
+    if (pthread_cond_timedwait(cond, mutex, prazo) == ETIMEDOUT) {
+        freertos_host_avancar_us((int64_t)espera * 1000);
+        return 0;
+    }
+    return 1;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *parametro,
+                                   UBaseType_t prioridade, TaskHandle_t *criada, BaseType_t nucleo) {
+    struct tarefa_host_t *t = nova_tarefa(funcao, parametro, prioridade);
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, rodar_tarefa, t) != 0) {
+        free(t);
+        return pdFALSE;
+    }
+    pthread_detach(thread);
+    if (criada) *criada = t;
+    return pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    // A thread principal do teste vira tarefa no primeiro uso
+    if (!s_atual) s_atual = nova_tarefa(NULL, NULL, PRIORIDADE_PRINCIPAL);
+    return s_atual;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarefa) {
+    return (tarefa ? tarefa : xTaskGetCurrentTaskHandle())->prioridade;
+}
+
+BaseType_t xPortGetCoreID(void) {
+    return 0;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    freertos_host_avancar_us((int64_t)ticks * 1000);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(freertos_host_agora_us() / 1000);
+}
+
+void xTaskNotifyGive(TaskHandle_t tarefa) {
+    pthread_mutex_lock(&tarefa->mutex);
+    tarefa->notificacoes++;
+    pthread_cond_signal(&tarefa->cond);
+    pthread_mutex_unlock(&tarefa->mutex);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t zerar, TickType_t espera) {
+    struct tarefa_host_t *t = xTaskGetCurrentTaskHandle();
+    struct timespec prazo = prazo_ms(espera);
+    pthread_mutex_lock(&t->mutex);
+    while (t->notificacoes == 0 && espera != 0) {
+        if (!esperar(&t->cond, &t->mutex, espera, &prazo)) break;
+    }
+    uint32_t valor = t->notificacoes;
+    if (valor) t->notificacoes = zerar ? 0 : valor - 1;
+    pthread_mutex_unlock(&t->mutex);
+    return valor;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t tamanho, UBaseType_t tam_item) {
+    struct fila_host_t *f = calloc(1, sizeof(*f));
+    f->tamanho = tamanho;
+    f->tam_item = tam_item;
+    f->itens = calloc(tamanho, tam_item);
+    pthread_mutex_init(&f->mutex, NULL);
+    pthread_cond_init(&f->cond, NULL);
+    return f;
+}
+
+BaseType_t xQueueSend(QueueHandle_t f, const void *item, TickType_t espera) {
+    struct timespec prazo = prazo_ms(espera);
+    pthread_mutex_lock(&f->mutex);
+    while (f->ocupados == f->tamanho) {
+        if (espera == 0 || !esperar(&f->cond, &f->mutex, espera, &prazo)) {
+            pthread_mutex_unlock(&f->mutex);
+            return pdFALSE;
+        }
+    }
+    memcpy(f->itens + ((f->inicio + f->ocupados) % f->tamanho) * f->tam_item, item, f->tam_item);
+    f->ocupados++;
+    pthread_cond_broadcast(&f->cond);
+    pthread_mutex_unlock(&f->mutex);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t f, void *item, TickType_t espera) {
+    struct timespec prazo = prazo_ms(espera);
+    pthread_mutex_lock(&f->mutex);
+    while (f->ocupados == 0) {
+        if (espera == 0 || !esperar(&f->cond, &f->mutex, espera, &prazo)) {
+            pthread_mutex_unlock(&f->mutex);
+            return pdFALSE;
+        }
+    }
+    memcpy(item, f->itens + f->inicio * f->tam_item, f->tam_item);
+    f->inicio = (f->inicio + 1) % f->tamanho;
+    f->ocupados--;
+    pthread_cond_broadcast(&f->cond);
+    pthread_mutex_unlock(&f->mutex);
+    return pdTRUE;
+}
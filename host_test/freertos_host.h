@@ -0,0 +1,27 @@
+// host_test/freertos_host.h
+// Relógio simulado por trás do vTaskDelay/xTaskGetTickCount dos testes no PC.
+
+#ifndef FREERTOS_HOST_H
+#define FREERTOS_HOST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tempo simulado desde o início do teste (us).
+ */
+int64_t freertos_host_agora_us(void);
+
+/**
+ * @brief Avança o relógio simulado (ex.: tempo de fio de uma transação I2C).
+ */
+void freertos_host_avancar_us(int64_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FREERTOS_HOST_H
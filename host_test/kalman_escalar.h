@@ -0,0 +1,68 @@
+// host_test/kalman_escalar.h
+// Filtro de Kalman escalar (um objeto por eixo) como estava no SensorMPU6050.cpp antes do
+// KalmanBank; fica aqui como referência para o test_kalman e o bench_kalman.
+// Mudanças na matemática do banco têm de ser repetidas aqui (hoje: a média da vibração).
+
+#ifndef KALMAN_ESCALAR_H
+#define KALMAN_ESCALAR_H
+
+#include <math.h>
+#include "KalmanBank.h"     // DESVIO_G_REF, ALFA_NIS, FATOR_R_MAX
+
+class KalmanFilter {
+public:
+    float angle = 0.0f;
+    float bias  = 0.0f;
+    float P[2][2] = {{0,0},{0,0}};
+
+    float Q_angle = 0.001f;
+    float Q_bias  = 0.005f;
+    float R_measure = 0.03f;
+
+    // Modo adaptativo: R cresce quando o acelerômetro não é confiável
+    // (|a| longe de 1 g ou inovações maiores que o previsto) e Q_bias cai
+    // na mesma proporção, para o bias não aprender com vibração.
+    bool adaptativo = false;
+    float nis_medio = 1.0f;     // Média móvel de y²/S (1 = filtro consistente)
+    float fator_r = 1.0f;       // Fator aplicado a R_measure (e divisor de Q_bias)
+    float vibracao_media = 0.0f;
+
+    void predict(float gyro_rate, float dt) {
+        angle += dt * (gyro_rate - bias);
+        P[0][0] += dt * (dt*P[1][1] - P[0][1] - P[1][0] + Q_angle);
+        P[0][1] -= dt * P[1][1];
+        P[1][0] -= dt * P[1][1];
+        P[1][1] += Q_bias * dt / fator_r;
+    }
+
+    void update(float measured_angle, float desvio_g = 0.0f) {
+        float y = measured_angle - angle;
+
+        if (adaptativo) {
+            nis_medio += ALFA_NIS * (y*y / (P[0][0] + R_measure*fator_r) - nis_medio);
+            float fg = desvio_g / DESVIO_G_REF;
+            vibracao_media += ALFA_NIS * (fg*fg - vibracao_media);
+            fator_r = fminf((1.0f + vibracao_media) * fmaxf(1.0f, nis_medio), FATOR_R_MAX);
+        } else {
+            fator_r = 1.0f;
+        }
+
+        float S = P[0][0] + R_measure * fator_r;
+
+        float K0 = P[0][0] / S;
+        float K1 = P[1][0] / S;
+
+        angle += K0 * y;
+        bias  += K1 * y;
+
+        float P00_temp = P[0][0];
+        float P01_temp = P[0][1];
+
+        P[0][0] -= K0 * P00_temp;
+        P[0][1] -= K0 * P01_temp;
+        P[1][0] -= K1 * P00_temp;
+        P[1][1] -= K1 * P01_temp;
+    }
+};
+
+#endif // KALMAN_ESCALAR_H
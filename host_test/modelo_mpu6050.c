@@ -0,0 +1,499 @@
+// host_test/modelo_mpu6050.c
+// Modelo do MPU6050 e driver i2c_master falso que o expõe (ver modelo_mpu6050.h).
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "driver/i2c_master.h"
+#include "freertos_host.h"
+#include "modelo_mpu6050.h"
+
+// --- Registradores usados pelo modelo ---
+#define REG_XA_OFFS_H       0x06
+#define REG_XG_OFFS_USRH    0x13
+#define REG_SMPLRT_DIV      0x19
+#define REG_CONFIG          0x1A
+#define REG_GYRO_CONFIG     0x1B
+#define REG_ACCEL_CONFIG    0x1C
+#define REG_FIFO_EN         0x23
+#define REG_INT_STATUS      0x3A
+#define REG_ACCEL_XOUT_H    0x3B
+#define REG_EXT_SENS_FIM    0x60
+#define REG_SIGNAL_RESET    0x68
+#define REG_USER_CTRL       0x6A
+#define REG_PWR_MGMT_1      0x6B
+#define REG_BANK_SEL        0x6D
+#define REG_MEM_START_ADDR  0x6E
+#define REG_MEM_R_W         0x6F
+#define REG_FIFO_COUNTH     0x72
+#define REG_FIFO_COUNTL     0x73
+#define REG_FIFO_R_W        0x74
+#define REG_WHO_AM_I        0x75
+#define NUM_REGISTRADORES   0x76
+
+#define INT_DATA_RDY        0x01
+#define INT_FIFO_OFLOW      0x10
+#define USER_FIFO_EN        0x40
+#define USER_RESETS         0x0F    // DMP, FIFO, I2C_MST e SIG_COND: voltam a 0 sozinhos
+#define USER_FIFO_RESET     0x04
+#define PWR1_RESET          0x80
+#define PWR1_SLEEP          0x40
+#define FIFO_EN_TEMP        0x80
+#define FIFO_EN_XG          0x40
+#define FIFO_EN_YG          0x20
+#define FIFO_EN_ZG          0x10
+#define FIFO_EN_ACCEL       0x08
+
+#define WHO_AM_I_VALOR      0x68
+#define LSB_POR_DPS         131.0f      // +/-250 grau/s
+#define LSB_POR_G           16384.0f    // +/-2 g
+#define PENDENTES_MAX       2048        // Amostras geradas de uma vez após um salto longo do relógio
+
+struct i2c_master_bus_t {
+    int reservado;
+};
+
+struct i2c_master_dev_t {
+    uint16_t endereco;
+    uint32_t hz;
+};
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_destravar = PTHREAD_COND_INITIALIZER;
+static struct i2c_master_bus_t s_barramento;
+
+static uint8_t s_endereco;
+static uint8_t s_reg[NUM_REGISTRADORES];
+static uint8_t s_ponteiro;
+static uint8_t s_memoria[MODELO_MPU_BANCOS_DMP][256];
+static uint8_t s_mem_endereco;
+
+static uint8_t s_fifo[MODELO_MPU_FIFO_TAM];
+static uint16_t s_fifo_inicio, s_fifo_ocupado;
+static uint8_t s_fifo_ultimo;
+
+static int64_t s_proxima_us;        // Instante da próxima amostra
+static const mpu_movimento_t *s_movimento;
+static size_t s_movimento_n;
+static bool s_repetir;
+static int64_t s_movimento_inicio_us;
+
+static float s_bias_acel[3], s_bias_giro[3];
+static int16_t s_ruido;
+static uint32_t s_semente;
+
+static uint32_t s_falhas;
+static esp_err_t s_erro_falha;
+static bool s_travado;
+
+static mpu_barramento_t s_trafego;
+static int64_t s_fio_ns;            // Tempo de fio acumulado em s_trafego
+static int64_t s_resto_ns;          // Fração de us do tempo de fio ainda não passada ao relógio
+
+// --- Dispositivo ---
+
+static void reset_registradores(void) {
+    memset(s_reg, 0, sizeof(s_reg));
+    memset(s_memoria, 0, sizeof(s_memoria));
+    s_reg[REG_PWR_MGMT_1] = PWR1_SLEEP;
+    s_reg[REG_WHO_AM_I] = WHO_AM_I_VALOR;
+    s_fifo_inicio = s_fifo_ocupado = 0;
+    s_mem_endereco = 0;
+}
+
+// Taxa de amostragem: 8 kHz sem DLPF (CFG 0 ou 7), 1 kHz com, dividida por 1 + SMPLRT_DIV
+static int64_t periodo_amostra_us(void) {
+    uint8_t dlpf = s_reg[REG_CONFIG] & 0x07;
+    int64_t base_ns = (dlpf == 0 || dlpf == 7) ? 125000 : 1000000;
+    return base_ns * (1 + s_reg[REG_SMPLRT_DIV]) / 1000;
+}
+
+static mpu_movimento_t movimento_em(int64_t t_us) {
+    mpu_movimento_t m = { 0, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, 25.0f };
+    if (!s_movimento || s_movimento_n == 0) return m;
+
+    int64_t t = t_us - s_movimento_inicio_us;
+    const mpu_movimento_t *ultima = &s_movimento[s_movimento_n - 1];
+    if (s_repetir) {
+        int64_t passo = (s_movimento_n > 1) ? ultima->t_us - s_movimento[s_movimento_n - 2].t_us : 1000;
+        int64_t duracao = ultima->t_us + passo;
+        if (duracao > 0) t %= duracao;
+    }
+
+    // Última amostra com t_us <= t
+    size_t lo = 0, hi = s_movimento_n;
+    while (hi - lo > 1) {
+        size_t meio = (lo + hi) / 2;
+        if (s_movimento[meio].t_us <= t) lo = meio;
+        else hi = meio;
+    }
+    return s_movimento[lo];
+}
+
+static int16_t saturar(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lroundf(v);
+}
+
+static float ruido(void) {
+    if (s_ruido == 0) return 0.0f;
+    s_semente = s_semente * 1664525u + 1013904223u;
+    return (float)((int32_t)(s_semente >> 16) % (2 * s_ruido + 1) - s_ruido);
+}
+
+static int16_t ler_palavra(uint8_t reg) {
+    return (int16_t)((s_reg[reg] << 8) | s_reg[reg + 1]);
+}
+
+static void escrever_palavra(uint8_t reg, int16_t v) {
+    s_reg[reg] = (uint8_t)((uint16_t)v >> 8);
+    s_reg[reg + 1] = (uint8_t)(v & 0xFF);
+}
+
+static void fifo_empilhar(uint8_t byte) {
+    if (s_fifo_ocupado == MODELO_MPU_FIFO_TAM) {
+        // Cheia: o byte mais antigo se perde (os pacotes desalinham, como no sensor)
+        s_fifo_inicio = (s_fifo_inicio + 1) % MODELO_MPU_FIFO_TAM;
+        s_fifo_ocupado--;
+        s_reg[REG_INT_STATUS] |= INT_FIFO_OFLOW;
+    }
+    s_fifo[(s_fifo_inicio + s_fifo_ocupado) % MODELO_MPU_FIFO_TAM] = byte;
+    s_fifo_ocupado++;
+}
+
+static uint8_t fifo_retirar(void) {
+    // Vazia: repete o último byte lido
+    if (s_fifo_ocupado == 0) return s_fifo_ultimo;
+    s_fifo_ultimo = s_fifo[s_fifo_inicio];
+    s_fifo_inicio = (s_fifo_inicio + 1) % MODELO_MPU_FIFO_TAM;
+    s_fifo_ocupado--;
+    return s_fifo_ultimo;
+}
+
+// Registradores de dados, data-ready e FIFO para uma amostra no instante t_us
+static void gerar_amostra(int64_t t_us) {
+    mpu_movimento_t m = movimento_em(t_us);
+    uint8_t fs_giro = (s_reg[REG_GYRO_CONFIG] >> 3) & 0x03;
+    uint8_t fs_acel = (s_reg[REG_ACCEL_CONFIG] >> 3) & 0x03;
+
+    for (int i = 0; i < 3; i++) {
+        // Offset do acelerômetro em 2048 LSB/g (bit 0 reservado); do giroscópio em 32.8 LSB/(grau/s)
+        float offs_acel = (float)(ler_palavra(REG_XA_OFFS_H + 2 * i) & ~1) * 8.0f;
+        float offs_giro = (float)ler_palavra(REG_XG_OFFS_USRH + 2 * i) * 4.0f;
+        float acel = ((m.acel_g[i] + s_bias_acel[i]) * LSB_POR_G + offs_acel) / (float)(1 << fs_acel);
+        float giro = ((m.giro_dps[i] + s_bias_giro[i]) * LSB_POR_DPS + offs_giro) / (float)(1 << fs_giro);
+        escrever_palavra(REG_ACCEL_XOUT_H + 2 * i, saturar(acel + ruido()));
+        escrever_palavra(REG_ACCEL_XOUT_H + 8 + 2 * i, saturar(giro + ruido()));
+    }
+    escrever_palavra(REG_ACCEL_XOUT_H + 6, saturar((m.temp_c - 36.53f) * 340.0f));
+    s_reg[REG_INT_STATUS] |= INT_DATA_RDY;
+
+    if (!(s_reg[REG_USER_CTRL] & USER_FIFO_EN)) return;
+    uint8_t habilitados = s_reg[REG_FIFO_EN];
+    // Ordem dos registradores: acelerômetro, temperatura, giroscópio X/Y/Z
+    if (habilitados & FIFO_EN_ACCEL) {
+        for (int b = 0; b < 6; b++) fifo_empilhar(s_reg[REG_ACCEL_XOUT_H + b]);
+    }
+    if (habilitados & FIFO_EN_TEMP) {
+        fifo_empilhar(s_reg[REG_ACCEL_XOUT_H + 6]);
+        fifo_empilhar(s_reg[REG_ACCEL_XOUT_H + 7]);
+    }
+    const uint8_t giro[3] = { FIFO_EN_XG, FIFO_EN_YG, FIFO_EN_ZG };
+    for (int i = 0; i < 3; i++) {
+        if (!(habilitados & giro[i])) continue;
+        fifo_empilhar(s_reg[REG_ACCEL_XOUT_H + 8 + 2 * i]);
+        fifo_empilhar(s_reg[REG_ACCEL_XOUT_H + 9 + 2 * i]);
+    }
+}
+
+// Gera as amostras vencidas até agora (parado enquanto dorme)
+static void atualizar(void) {
+    int64_t agora = freertos_host_agora_us();
+    int64_t periodo = periodo_amostra_us();
+    if (s_reg[REG_PWR_MGMT_1] & PWR1_SLEEP) {
+        s_proxima_us = agora + periodo;
+        return;
+    }
+    if (s_proxima_us <= agora) {
+        int64_t pendentes = (agora - s_proxima_us) / periodo + 1;
+        if (pendentes > PENDENTES_MAX) s_proxima_us += (pendentes - PENDENTES_MAX) * periodo;
+    }
+    while (s_proxima_us <= agora) {
+        gerar_amostra(s_proxima_us);
+        s_proxima_us += periodo;
+    }
+}
+
+static uint8_t ler_registrador(uint8_t reg) {
+    switch (reg) {
+    case REG_FIFO_R_W:
+        return fifo_retirar();
+    case REG_MEM_R_W:
+        return s_memoria[s_reg[REG_BANK_SEL] % MODELO_MPU_BANCOS_DMP][s_mem_endereco++];
+    case REG_FIFO_COUNTH:
+        return (uint8_t)(s_fifo_ocupado >> 8);
+    case REG_FIFO_COUNTL:
+        return (uint8_t)(s_fifo_ocupado & 0xFF);
+    case REG_INT_STATUS: {
+        uint8_t v = s_reg[REG_INT_STATUS];
+        s_reg[REG_INT_STATUS] = 0;      // Limpo na leitura (INT_RD_CLEAR = 0)
+        return v;
+    }
+    default:
+        return (reg < NUM_REGISTRADORES) ? s_reg[reg] : 0;
+    }
+}
+
+static void escrever_registrador(uint8_t reg, uint8_t v) {
+    if (reg >= NUM_REGISTRADORES) return;
+    if (reg >= REG_INT_STATUS && reg <= REG_EXT_SENS_FIM) return;   // Só leitura
+    if (reg == REG_FIFO_COUNTH || reg == REG_FIFO_COUNTL || reg == REG_WHO_AM_I) return;
+
+    switch (reg) {
+    case REG_FIFO_R_W:
+        fifo_empilhar(v);
+        return;
+    case REG_MEM_R_W:
+        s_memoria[s_reg[REG_BANK_SEL] % MODELO_MPU_BANCOS_DMP][s_mem_endereco++] = v;
+        return;
+    case REG_BANK_SEL:
+        s_reg[reg] = v & 0x1F;      // Prefetch e banco de usuário não mudam o acesso à memória
+        return;
+    case REG_MEM_START_ADDR:
+        s_reg[reg] = v;
+        s_mem_endereco = v;
+        return;
+    case REG_SIGNAL_RESET:
+        return;
+    case REG_USER_CTRL:
+        if (v & USER_FIFO_RESET) s_fifo_inicio = s_fifo_ocupado = 0;
+        s_reg[reg] = v & ~USER_RESETS;
+        return;
+    case REG_PWR_MGMT_1:
+        if (v & PWR1_RESET) {
+            reset_registradores();
+            return;
+        }
+        s_reg[reg] = v;
+        return;
+    case REG_SMPLRT_DIV:
+    case REG_CONFIG:
+        // Nova taxa vale a partir de agora
+        s_reg[reg] = v;
+        s_proxima_us = freertos_host_agora_us() + periodo_amostra_us();
+        return;
+    default:
+        s_reg[reg] = v;
+    }
+}
+
+// FIFO_R_W e MEM_R_W não avançam o ponteiro de registrador numa rajada
+static void avancar_ponteiro(void) {
+    if (s_ponteiro != REG_FIFO_R_W && s_ponteiro != REG_MEM_R_W) s_ponteiro++;
+}
+
+// --- Barramento ---
+
+// Uma transação: START, endereço+escrita e bytes, [START repetido, endereço+leitura e bytes], STOP.
+// Devolve o erro injetado, NACK para outro endereço ou ESP_OK.
+static esp_err_t transacao(i2c_master_dev_handle_t dev, const uint8_t *escrita, size_t n_escrita,
+                           uint8_t *leitura, size_t n_leitura) {
+    pthread_mutex_lock(&s_mutex);
+    while (s_travado) pthread_cond_wait(&s_destravar, &s_mutex);
+
+    uint32_t bytes = (n_escrita ? 1 + n_escrita : 0) + (n_leitura ? 1 + n_leitura : 0);
+    uint32_t bits = bytes * 9 + ((n_escrita && n_leitura) ? 4 : 2);
+    int64_t fio_ns = (int64_t)bits * 1000000000LL / dev->hz;
+    int64_t ns = s_resto_ns + fio_ns;
+    s_resto_ns = ns % 1000;
+    freertos_host_avancar_us(ns / 1000);
+    s_fio_ns += fio_ns;
+    s_trafego.transacoes++;
+    s_trafego.bytes += bytes;
+    s_trafego.tempo_us = s_fio_ns / 1000;
+
+    esp_err_t rc = ESP_OK;
+    if (s_falhas) {
+        s_falhas--;
+        rc = s_erro_falha;
+    } else if (dev->endereco != s_endereco) {
+        rc = ESP_FAIL;      // NACK
+    } else {
+        atualizar();
+        if (n_escrita) {
+            s_ponteiro = escrita[0];
+            for (size_t i = 1; i < n_escrita; i++) {
+                escrever_registrador(s_ponteiro, escrita[i]);
+                avancar_ponteiro();
+            }
+        }
+        for (size_t i = 0; i < n_leitura; i++) {
+            leitura[i] = ler_registrador(s_ponteiro);
+            avancar_ponteiro();
+        }
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return rc;
+}
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *config, i2c_master_bus_handle_t *ret_bus_handle) {
+    *ret_bus_handle = &s_barramento;
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus_handle) {
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle) {
+    if (dev_config->scl_speed_hz == 0) return ESP_ERR_INVALID_ARG;
+    struct i2c_master_dev_t *dev = calloc(1, sizeof(*dev));
+    if (!dev) return ESP_ERR_NO_MEM;
+    dev->endereco = dev_config->device_address;
+    dev->hz = dev_config->scl_speed_hz;
+    *ret_handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle) {
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms) {
+    return transacao(i2c_dev, write_buffer, write_size, NULL, 0);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size,
+                             int xfer_timeout_ms) {
+    return transacao(i2c_dev, NULL, 0, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                                      uint8_t *read_buffer, size_t read_size, int xfer_timeout_ms) {
+    return transacao(i2c_dev, write_buffer, write_size, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus_handle) {
+    pthread_mutex_lock(&s_mutex);
+    s_trafego.resets++;
+    pthread_mutex_unlock(&s_mutex);
+    return ESP_OK;
+}
+
+// --- Controle pelo teste ---
+
+void modelo_mpu_iniciar(uint8_t endereco) {
+    pthread_mutex_lock(&s_mutex);
+    s_endereco = endereco;
+    reset_registradores();
+    s_ponteiro = 0;
+    s_fifo_ultimo = 0;
+    s_proxima_us = freertos_host_agora_us();
+    s_movimento = NULL;
+    s_movimento_n = 0;
+    memset(s_bias_acel, 0, sizeof(s_bias_acel));
+    memset(s_bias_giro, 0, sizeof(s_bias_giro));
+    s_ruido = 0;
+    s_semente = 1;
+    s_falhas = 0;
+    s_travado = false;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void modelo_mpu_reproduzir(const mpu_movimento_t *amostras, size_t n, bool repetir) {
+    pthread_mutex_lock(&s_mutex);
+    atualizar();    // Amostras até agora ainda são do movimento anterior
+    s_movimento = amostras;
+    s_movimento_n = n;
+    s_repetir = repetir;
+    s_movimento_inicio_us = freertos_host_agora_us();
+    pthread_mutex_unlock(&s_mutex);
+}
+
+size_t modelo_mpu_carregar_csv(const char *caminho, mpu_movimento_t *amostras, size_t max) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) return 0;
+    char linha[256];
+    size_t n = 0;
+    while (n < max && fgets(linha, sizeof(linha), f)) {
+        mpu_movimento_t *m = &amostras[n];
+        long long t;
+        if (sscanf(linha, "%lld,%f,%f,%f,%f,%f,%f,%f", &t, &m->acel_g[0], &m->acel_g[1], &m->acel_g[2],
+                   &m->giro_dps[0], &m->giro_dps[1], &m->giro_dps[2], &m->temp_c) != 8) {
+            continue;
+        }
+        m->t_us = t;
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+void modelo_mpu_definir_bias(const float acel_g[3], const float giro_dps[3]) {
+    pthread_mutex_lock(&s_mutex);
+    atualizar();
+    memcpy(s_bias_acel, acel_g, sizeof(s_bias_acel));
+    memcpy(s_bias_giro, giro_dps, sizeof(s_bias_giro));
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void modelo_mpu_definir_ruido(int16_t amplitude_lsb) {
+    pthread_mutex_lock(&s_mutex);
+    s_ruido = amplitude_lsb;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void modelo_mpu_falhar(uint32_t n, esp_err_t erro) {
+    pthread_mutex_lock(&s_mutex);
+    s_falhas = n;
+    s_erro_falha = erro;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void modelo_mpu_travar(bool travado) {
+    pthread_mutex_lock(&s_mutex);
+    s_travado = travado;
+    if (!travado) pthread_cond_broadcast(&s_destravar);
+    pthread_mutex_unlock(&s_mutex);
+}
+
+uint8_t modelo_mpu_registrador(uint8_t reg) {
+    pthread_mutex_lock(&s_mutex);
+    uint8_t v = (reg < NUM_REGISTRADORES) ? s_reg[reg] : 0;
+    pthread_mutex_unlock(&s_mutex);
+    return v;
+}
+
+uint8_t modelo_mpu_memoria(uint8_t banco, uint8_t endereco) {
+    pthread_mutex_lock(&s_mutex);
+    uint8_t v = s_memoria[banco % MODELO_MPU_BANCOS_DMP][endereco];
+    pthread_mutex_unlock(&s_mutex);
+    return v;
+}
+
+uint16_t modelo_mpu_fifo_ocupado(void) {
+    pthread_mutex_lock(&s_mutex);
+    atualizar();
+    uint16_t n = s_fifo_ocupado;
+    pthread_mutex_unlock(&s_mutex);
+    return n;
+}
+
+void modelo_mpu_obter_barramento(mpu_barramento_t *saida) {
+    pthread_mutex_lock(&s_mutex);
+    *saida = s_trafego;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void modelo_mpu_zerar_barramento(void) {
+    pthread_mutex_lock(&s_mutex);
+    memset(&s_trafego, 0, sizeof(s_trafego));
+    s_fio_ns = 0;
+    pthread_mutex_unlock(&s_mutex);
+}
@@ -0,0 +1,97 @@
+// host_test/modelo_mpu6050.h
+// MPU6050 em nível de registrador atrás do driver i2c_master falso, para rodar
+// components/I2Cdev e components/MPU6050 no PC.
+//
+// Modela: banco de registradores com reset, offsets de acelerômetro e giroscópio,
+// divisor de taxa (SMPLRT_DIV + DLPF), data-ready e overflow em INT_STATUS, FIFO de
+// 1024 bytes (o mais antigo sai no overflow), memória do DMP (8 bancos de 256 bytes
+// via BANK_SEL/MEM_START_ADDR/MEM_R_W) e reprodução de um movimento gravado.
+// As amostras seguem o relógio simulado (freertos_host.h); cada transação avança o
+// relógio pelo seu tempo de fio na velocidade do dispositivo.
+
+#ifndef MODELO_MPU6050_H
+#define MODELO_MPU6050_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MODELO_MPU_FIFO_TAM         1024
+#define MODELO_MPU_BANCOS_DMP       8
+
+// Uma amostra do movimento gravado (t_us relativo ao início da gravação)
+typedef struct {
+    int64_t t_us;
+    float acel_g[3];
+    float giro_dps[3];
+    float temp_c;
+} mpu_movimento_t;
+
+// Tráfego visto pelo dispositivo
+typedef struct {
+    uint32_t transacoes;
+    uint32_t bytes;         // No fio, incluindo os bytes de endereço
+    int64_t tempo_us;       // No fio, na velocidade de cada transação
+    uint32_t resets;        // i2c_master_bus_reset
+} mpu_barramento_t;
+
+/**
+ * @brief Power-on reset no endereço dado, parado e nivelado (1 g em Z) a 25 °C,
+ * sem bias, ruído ou falhas.
+ */
+void modelo_mpu_iniciar(uint8_t endereco);
+
+/**
+ * @brief Reproduz o movimento a partir de agora (as amostras seguram o valor até a próxima).
+ * @param repetir Recomeça ao fim; senão fica na última amostra.
+ * O vetor precisa viver enquanto for reproduzido.
+ */
+void modelo_mpu_reproduzir(const mpu_movimento_t *amostras, size_t n, bool repetir);
+
+/**
+ * @brief Lê um movimento gravado em CSV: t_us,ax,ay,az,gx,gy,gz,temp (g, grau/s, °C).
+ * Linhas que não começam por número (cabeçalho, #) são ignoradas.
+ * @return Amostras lidas (0 se o arquivo não abriu).
+ */
+size_t modelo_mpu_carregar_csv(const char *caminho, mpu_movimento_t *amostras, size_t max);
+
+/**
+ * @brief Erro do sensor somado ao movimento (o que a calibração deve cancelar).
+ */
+void modelo_mpu_definir_bias(const float acel_g[3], const float giro_dps[3]);
+
+/**
+ * @brief Ruído uniforme de +/- amplitude LSB em cada eixo (pseudoaleatório, repetível).
+ */
+void modelo_mpu_definir_ruido(int16_t amplitude_lsb);
+
+/**
+ * @brief As próximas n transações falham com o erro dado, sem tocar nos registradores.
+ */
+void modelo_mpu_falhar(uint32_t n, esp_err_t erro);
+
+/**
+ * @brief Segura as transações até destravar (barramento preso, para os prazos do modo assíncrono).
+ */
+void modelo_mpu_travar(bool travado);
+
+/**
+ * @brief Leitura direta, sem passar pelo barramento nem pelos efeitos de leitura.
+ */
+uint8_t modelo_mpu_registrador(uint8_t reg);
+uint8_t modelo_mpu_memoria(uint8_t banco, uint8_t endereco);
+uint16_t modelo_mpu_fifo_ocupado(void);
+
+void modelo_mpu_obter_barramento(mpu_barramento_t *saida);
+void modelo_mpu_zerar_barramento(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODELO_MPU6050_H
@@ -0,0 +1,176 @@
+// host_test/nvs_host.c
+// NVS em memória para os testes no PC: blobs por (namespace, chave), gravados na hora
+// (nvs_commit não faz nada). Protegida por mutex porque ModeloTermico grava de outra tarefa.
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "nvs.h"
+#include "nvs_host.h"
+
+#define MAX_ENTRADAS    32
+#define MAX_HANDLES     16
+#define TAM_NOME        16      // 15 caracteres + '\0', como na NVS
+
+typedef struct {
+    char ns[TAM_NOME];
+    char chave[TAM_NOME];
+    void *dados;
+    size_t tamanho;
+} entrada_t;
+
+typedef struct {
+    char ns[TAM_NOME];
+    nvs_open_mode_t modo;
+    int aberto;
+} handle_t;
+
+static entrada_t s_entradas[MAX_ENTRADAS];
+static handle_t s_handles[MAX_HANDLES];
+static uint32_t s_falhas = 0;
+static esp_err_t s_erro_falha = ESP_FAIL;
+static uint32_t s_gravacoes = 0;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static entrada_t *procurar(const char *ns, const char *chave) {
+    for (int i = 0; i < MAX_ENTRADAS; i++) {
+        if (s_entradas[i].dados && strcmp(s_entradas[i].ns, ns) == 0 && strcmp(s_entradas[i].chave, chave) == 0) {
+            return &s_entradas[i];
+        }
+    }
+    return NULL;
+}
+
+static handle_t *obter_handle(nvs_handle_t h) {
+    return (h >= 1 && h <= MAX_HANDLES && s_handles[h - 1].aberto) ? &s_handles[h - 1] : NULL;
+}
+
+void nvs_host_apagar(void) {
+    pthread_mutex_lock(&s_mutex);
+    for (int i = 0; i < MAX_ENTRADAS; i++) {
+        free(s_entradas[i].dados);
+        s_entradas[i].dados = NULL;
+    }
+    s_falhas = 0;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void nvs_host_falhar_escritas(uint32_t n, esp_err_t erro) {
+    pthread_mutex_lock(&s_mutex);
+    s_falhas = n;
+    s_erro_falha = erro;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+uint32_t nvs_host_gravacoes(void) {
+    pthread_mutex_lock(&s_mutex);
+    uint32_t n = s_gravacoes;
+    pthread_mutex_unlock(&s_mutex);
+    return n;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t modo, nvs_handle_t *handle) {
+    if (strlen(namespace_name) >= TAM_NOME) return ESP_ERR_INVALID_ARG;
+    pthread_mutex_lock(&s_mutex);
+    esp_err_t err = ESP_ERR_NO_MEM;
+    for (int i = 0; i < MAX_HANDLES; i++) {
+        if (!s_handles[i].aberto) {
+            strcpy(s_handles[i].ns, namespace_name);
+            s_handles[i].modo = modo;
+            s_handles[i].aberto = 1;
+            *handle = (nvs_handle_t)(i + 1);
+            err = ESP_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    pthread_mutex_lock(&s_mutex);
+    handle_t *h = obter_handle(handle);
+    if (h) h->aberto = 0;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *chave, void *valor, size_t *tamanho) {
+    pthread_mutex_lock(&s_mutex);
+    esp_err_t err = ESP_OK;
+    handle_t *h = obter_handle(handle);
+    entrada_t *e = h ? procurar(h->ns, chave) : NULL;
+    if (!h) {
+        err = ESP_ERR_INVALID_ARG;
+    } else if (!e) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (valor == NULL) {
+        *tamanho = e->tamanho;      // Consulta do tamanho
+    } else if (*tamanho < e->tamanho) {
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        memcpy(valor, e->dados, e->tamanho);
+        *tamanho = e->tamanho;
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return err;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *chave, const void *valor, size_t tamanho) {
+    if (strlen(chave) >= TAM_NOME) return ESP_ERR_INVALID_ARG;
+    pthread_mutex_lock(&s_mutex);
+    esp_err_t err = ESP_OK;
+    handle_t *h = obter_handle(handle);
+    if (!h) {
+        err = ESP_ERR_INVALID_ARG;
+    } else if (h->modo != NVS_READWRITE) {
+        err = ESP_ERR_NVS_READ_ONLY;
+    } else if (s_falhas > 0) {
+        s_falhas--;
+        err = s_erro_falha;
+    } else {
+        entrada_t *e = procurar(h->ns, chave);
+        for (int i = 0; !e && i < MAX_ENTRADAS; i++) {
+            if (!s_entradas[i].dados) {
+                e = &s_entradas[i];
+                strcpy(e->ns, h->ns);
+                strcpy(e->chave, chave);
+            }
+        }
+        if (!e) {
+            err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        } else {
+            void *novo = malloc(tamanho ? tamanho : 1);
+            memcpy(novo, valor, tamanho);
+            free(e->dados);
+            e->dados = novo;
+            e->tamanho = tamanho;
+            s_gravacoes++;
+        }
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *chave) {
+    pthread_mutex_lock(&s_mutex);
+    esp_err_t err = ESP_OK;
+    handle_t *h = obter_handle(handle);
+    entrada_t *e = h ? procurar(h->ns, chave) : NULL;
+    if (!h) err = ESP_ERR_INVALID_ARG;
+    else if (h->modo != NVS_READWRITE) err = ESP_ERR_NVS_READ_ONLY;
+    else if (!e) err = ESP_ERR_NVS_NOT_FOUND;
+    else {
+        free(e->dados);
+        e->dados = NULL;
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return err;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    pthread_mutex_lock(&s_mutex);
+    esp_err_t err = obter_handle(handle) ? ESP_OK : ESP_ERR_INVALID_ARG;
+    pthread_mutex_unlock(&s_mutex);
+    return err;
+}
@@ -0,0 +1,33 @@
+// host_test/nvs_host.h
+// Controle da NVS em memória dos testes no PC (stubs/nvs.h).
+
+#ifndef NVS_HOST_H
+#define NVS_HOST_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Apaga todas as chaves (flash "nova").
+ */
+void nvs_host_apagar(void);
+
+/**
+ * @brief As próximas n chamadas de nvs_set_blob falham com o erro dado.
+ */
+void nvs_host_falhar_escritas(uint32_t n, esp_err_t erro);
+
+/**
+ * @brief Gravações (nvs_set_blob) bem-sucedidas desde o início.
+ */
+uint32_t nvs_host_gravacoes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NVS_HOST_H
@@ -0,0 +1,20 @@
+// host_test/stubs/esp_log.h
+
+#ifndef ESP_LOG_H_STUB
+#define ESP_LOG_H_STUB
+
+#include <stdio.h>
+
+// Logs silenciosos por padrão; -DTESTE_LOG_VERBOSO mostra no stdout
+#ifdef TESTE_LOG_VERBOSO
+#define ESP_LOG_STUB(nivel, tag, fmt, ...) printf("%s (%s) " fmt "\n", nivel, tag, ##__VA_ARGS__)
+#else
+#define ESP_LOG_STUB(nivel, tag, fmt, ...) do { if (0) printf(fmt, ##__VA_ARGS__); (void)(tag); } while (0)
+#endif
+
+#define ESP_LOGE(tag, fmt, ...) ESP_LOG_STUB("E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_STUB("W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_STUB("I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_STUB("D", tag, fmt, ##__VA_ARGS__)
+
+#endif // ESP_LOG_H_STUB
@@ -0,0 +1,18 @@
+// host_test/stubs/esp_rom_crc.h
+
+#ifndef ESP_ROM_CRC_H_STUB
+#define ESP_ROM_CRC_H_STUB
+
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, refletido), mesma convenção do ROM: crc = 0 no início
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+#endif // ESP_ROM_CRC_H_STUB
@@ -0,0 +1,19 @@
+// host_test/stubs/esp_timer.h
+
+#ifndef ESP_TIMER_H_STUB
+#define ESP_TIMER_H_STUB
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Relógio controlado pelo teste: cada teste que usa esp_timer_get_time o implementa
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESP_TIMER_H_STUB
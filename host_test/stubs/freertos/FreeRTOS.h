@@ -0,0 +1,23 @@
+// host_test/stubs/freertos/FreeRTOS.h
+// FreeRTOS mínimo para os testes no PC. Seções críticas viram no-op: os módulos com
+// tarefas (I2Cdev) rodam sobre host_test/freertos_host.c, que usa pthreads.
+
+#ifndef FREERTOS_H_STUB
+#define FREERTOS_H_STUB
+
+#include <stdint.h>
+
+typedef int portMUX_TYPE;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)     ((void)(mux))
+#define portEXIT_CRITICAL(mux)      ((void)(mux))
+#define portMAX_DELAY               ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(ms))
+#define pdTRUE                      1
+#define pdFALSE                     0
+
+#endif // FREERTOS_H_STUB
@@ -0,0 +1,23 @@
+// host_test/stubs/freertos/queue.h
+// Implementado em host_test/freertos_host.c.
+
+#ifndef QUEUE_H_STUB
+#define QUEUE_H_STUB
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct fila_host_t *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t tamanho, UBaseType_t tam_item);
+BaseType_t xQueueSend(QueueHandle_t fila, const void *item, TickType_t espera);
+BaseType_t xQueueReceive(QueueHandle_t fila, void *item, TickType_t espera);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUEUE_H_STUB
@@ -0,0 +1,32 @@
+// host_test/stubs/freertos/semphr.h
+
+#ifndef SEMPHR_H_STUB
+#define SEMPHR_H_STUB
+
+#include <sched.h>
+#include "freertos/FreeRTOS.h"
+
+// Mutex por espera ativa: serve à thread de leitura assíncrona do I2Cdev e, numa thread
+// só, uma segunda tomada trava como no mutex do FreeRTOS (sem recursão)
+typedef struct { int tomado; } semaforo_stub_t;
+typedef semaforo_stub_t *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    static semaforo_stub_t s[8];
+    static int n;
+    return &s[n++ % 8];
+}
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t espera) {
+    // Prazo finito contado em tentativas: os testes só usam portMAX_DELAY ou 0
+    for (TickType_t t = 0; __atomic_exchange_n(&s->tomado, 1, __ATOMIC_ACQUIRE); t++) {
+        if (espera != portMAX_DELAY && t >= espera) return pdFALSE;
+        sched_yield();
+    }
+    return pdTRUE;
+}
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    __atomic_store_n(&s->tomado, 0, __ATOMIC_RELEASE);
+    return pdTRUE;
+}
+
+#endif // SEMPHR_H_STUB
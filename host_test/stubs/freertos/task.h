@@ -0,0 +1,35 @@
+// host_test/stubs/freertos/task.h
+// Implementado em host_test/freertos_host.c (só os testes que usam tarefas o linkam).
+
+#ifndef TASK_H_STUB
+#define TASK_H_STUB
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tarefa_host_t *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define tskNO_AFFINITY  0x7FFFFFFF
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *parametro,
+                                   UBaseType_t prioridade, TaskHandle_t *criada, BaseType_t nucleo);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarefa);
+BaseType_t xPortGetCoreID(void);
+
+// Ticks de 1 ms no relógio simulado: vTaskDelay avança o relógio sem dormir
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+
+void xTaskNotifyGive(TaskHandle_t tarefa);
+uint32_t ulTaskNotifyTake(BaseType_t zerar, TickType_t espera);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_H_STUB
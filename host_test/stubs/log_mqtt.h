@@ -0,0 +1,13 @@
+// host_test/stubs/log_mqtt.h
+// Substitui main/LOGGER/log_mqtt.h: no PC os logs não vão para o MQTT.
+
+#ifndef LOG_MQTT_H
+#define LOG_MQTT_H
+
+#include "esp_log.h"
+
+#define LOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define LOGW(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define LOGE(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+
+#endif
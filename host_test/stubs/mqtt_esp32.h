@@ -0,0 +1,11 @@
+// host_test/stubs/mqtt_esp32.h
+// Substitui main/WIFI_MQTT/mqtt_esp32.h: o teste implementa o que o módulo testado usa.
+
+#ifndef MQTT_ESP32_H
+#define MQTT_ESP32_H
+
+#include <stdbool.h>
+
+void mqtt_publish_power_mode(const char *modo, bool forcado, float vbat);
+
+#endif
@@ -0,0 +1,39 @@
+// host_test/stubs/nvs.h
+// NVS em memória (host_test/nvs_host.c): só blobs, que é o que os módulos usam.
+
+#ifndef NVS_H_STUB
+#define NVS_H_STUB
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode_t;
+
+#define ESP_ERR_NVS_BASE            0x1100
+#define ESP_ERR_NVS_NOT_FOUND       (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_READ_ONLY       (ESP_ERR_NVS_BASE + 0x04)
+#define ESP_ERR_NVS_NOT_ENOUGH_SPACE (ESP_ERR_NVS_BASE + 0x05)
+#define ESP_ERR_NVS_INVALID_LENGTH  (ESP_ERR_NVS_BASE + 0x0c)
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t modo, nvs_handle_t *handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *chave, void *valor, size_t *tamanho);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *chave, const void *valor, size_t tamanho);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *chave);
+esp_err_t nvs_commit(nvs_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NVS_H_STUB
@@ -0,0 +1,2 @@
+// host_test/stubs/sdkconfig.h
+// Nenhuma opção do menuconfig é usada pelos módulos testados no PC.
@@ -0,0 +1,13 @@
+// host_test/stubs/wifi_sta.h
+// Substitui main/WIFI_MQTT/wifi_sta.h: o teste implementa o que o módulo testado usa.
+
+#ifndef WIFI_STA_H
+#define WIFI_STA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void wifi_definir_economia(bool ativo);
+int8_t wifi_rssi_atual(void);
+
+#endif
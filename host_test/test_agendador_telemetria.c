@@ -0,0 +1,146 @@
+// host_test/test_agendador_telemetria.c
+// Agendador de telemetria (main/TELEMETRIA/agendador_telemetria.c) contra um enlace simulado:
+// a task_mpu enfileira na taxa pedida, o enlace esvazia a fila a uma vazão fixa.
+// Verifica a sequência sob congestionamento: conteúdo mínimo primeiro, depois um degrau de
+// taxa, espera enquanto a fila esvazia, e a rajada da GUI encerrada pelo congestionamento.
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "teste.h"
+#include "esp_timer.h"
+#include "agendador_telemetria.h"
+
+#define CICLO_MS            1           // task_mpu a 1 kHz
+#define BYTES_COMPLETA      200
+#define BYTES_MINIMA        60
+#define FILA_MAX            65536       // Outbox do cliente MQTT
+#define IDADE_US            2000        // Amostra enfileirada 2 ms depois de medida
+#define LATENCIA_MAX_MS     150         // agendador_telemetria.c
+
+static int64_t s_agora_us = 0;
+
+int64_t esp_timer_get_time(void) {
+    return s_agora_us;
+}
+
+typedef struct {
+    uint32_t vazao_bps;     // Bytes/s que o enlace tira da fila
+    uint32_t fila;
+    int8_t rssi;
+} enlace_t;
+
+// Roda até a próxima janela avaliada e devolve o estado publicado
+static agendador_estado_t proxima_janela(enlace_t *e) {
+    static uint32_t ciclo = 0;
+    static uint32_t resto = 0;     // Bytes da vazão abaixo de 1 ms, acumulados
+    agendador_estado_t estado;
+    for (;;) {
+        s_agora_us += CICLO_MS * 1000;
+        ciclo++;
+
+        if (ciclo % agendador_telemetria_divisor(CICLO_MS) == 0) {
+            size_t bytes = agendador_telemetria_minimo() ? BYTES_MINIMA : BYTES_COMPLETA;
+            bool ok = e->fila + bytes <= FILA_MAX;
+            if (ok) e->fila += (uint32_t)bytes;
+            agendador_telemetria_registrar_envio(bytes, ok, IDADE_US);
+        }
+
+        resto += e->vazao_bps * CICLO_MS;
+        uint32_t saida = resto / 1000;
+        resto %= 1000;
+        e->fila = saida >= e->fila ? 0 : e->fila - saida;
+
+        if (agendador_telemetria_atualizar(s_agora_us, e->fila, e->rssi)) break;
+    }
+    agendador_telemetria_obter_estado(&estado);
+    return estado;
+}
+
+// Enlace folgado: sobe um nível a cada 3 janelas boas até 100 Hz; RSSI fraco limita a 20 Hz
+static void teste_subida(enlace_t *e) {
+    agendador_estado_t est = proxima_janela(e);
+    VERIFICAR(est.taxa_hz == 20 && !est.minimo, "início: %u Hz, mínimo %d", est.taxa_hz, est.minimo);
+
+    for (int i = 0; i < 12; i++) est = proxima_janela(e);
+    VERIFICAR(est.taxa_hz == 100 && !est.minimo, "enlace folgado: %u Hz, mínimo %d", est.taxa_hz, est.minimo);
+    VERIFICAR(est.latencia_ms < 50, "latência %u ms com enlace folgado", (unsigned)est.latencia_ms);
+
+    e->rssi = -85;
+    est = proxima_janela(e);
+    VERIFICAR(est.taxa_hz == 20, "RSSI fraco: %u Hz", est.taxa_hz);
+    e->rssi = -60;
+    for (int i = 0; i < 6; i++) est = proxima_janela(e);
+    VERIFICAR(est.taxa_hz == 100, "RSSI bom de novo: %u Hz", est.taxa_hz);
+}
+
+// A vazão cai para 4 kB/s com 100 Hz completos (20 kB/s) na fila
+static void teste_congestionamento(enlace_t *e) {
+    e->vazao_bps = 4000;
+
+    // 1ª janela congestionada: só enxuga o conteúdo (100 Hz mínimos = 6 kB/s, ainda acima da vazão)
+    agendador_estado_t est = proxima_janela(e);
+    printf("congestiona: %u Hz, mínimo %d, fila %u B, %u ms\n", est.taxa_hz, est.minimo,
+           (unsigned)est.outbox_bytes, (unsigned)est.latencia_ms);
+    VERIFICAR(est.minimo, "primeira reação deveria ser o conteúdo mínimo");
+    VERIFICAR(est.taxa_hz == 100, "taxa mudou junto com o conteúdo: %u Hz", est.taxa_hz);
+    VERIFICAR(est.outbox_crescimento > 0, "fila deveria estar crescendo");
+
+    // 2ª: a fila ainda cresce, então desce um nível (50 Hz mínimos = 3 kB/s)
+    est = proxima_janela(e);
+    printf("reduz:       %u Hz, mínimo %d, fila %u B, %u ms\n", est.taxa_hz, est.minimo,
+           (unsigned)est.outbox_bytes, (unsigned)est.latencia_ms);
+    VERIFICAR(est.taxa_hz == 50 && est.minimo, "segunda reação: %u Hz, mínimo %d", est.taxa_hz, est.minimo);
+
+    // Fila encolhendo mas com latência alta: segura a taxa enquanto esvazia
+    int janelas = 0;
+    while (est.latencia_ms > LATENCIA_MAX_MS && janelas < 60) {
+        est = proxima_janela(e);
+        janelas++;
+        VERIFICAR(est.taxa_hz == 50 && est.minimo, "janela %d esvaziando: %u Hz, mínimo %d (%u ms na fila)",
+                  janelas, est.taxa_hz, est.minimo, (unsigned)est.latencia_ms);
+    }
+    printf("esvazia:     %d janelas a %u Hz, fila %u B\n", janelas, est.taxa_hz, (unsigned)e->fila);
+    VERIFICAR(janelas > 3 && est.latencia_ms <= LATENCIA_MAX_MS, "fila não esvaziou (%d janelas, %u ms)",
+              janelas, (unsigned)est.latencia_ms);
+
+    // Depois disso o agendador só testa o conteúdo completo (que não cabe) e volta ao mínimo:
+    // a taxa fica em 50 Hz, que cabe na vazão
+    for (int i = 0; i < 30; i++) {
+        est = proxima_janela(e);
+        VERIFICAR(est.taxa_hz == 50, "janela %d depois de esvaziar: %u Hz", i, est.taxa_hz);
+    }
+}
+
+// Rajada a 200 Hz completa; o congestionamento a encerra antes do prazo sem mexer no nível
+static void teste_rajada(enlace_t *e) {
+    e->vazao_bps = 100000;
+    for (int i = 0; i < 3; i++) proxima_janela(e);   // Fila vazia, nível estável
+
+    agendador_estado_t antes;
+    agendador_telemetria_obter_estado(&antes);
+    agendador_telemetria_rajada(20.0f);
+    VERIFICAR(!agendador_telemetria_minimo(), "rajada deveria levar o conteúdo completo");
+    VERIFICAR(agendador_telemetria_divisor(CICLO_MS) == 5, "divisor %u na rajada",
+              agendador_telemetria_divisor(CICLO_MS));
+
+    agendador_estado_t est = proxima_janela(e);
+    VERIFICAR(est.rajada && est.taxa_hz == 200 && !est.minimo, "rajada: %u Hz, rajada %d, mínimo %d",
+              est.taxa_hz, est.rajada, est.minimo);
+
+    e->vazao_bps = 4000;
+    est = proxima_janela(e);
+    VERIFICAR(!est.rajada, "congestionamento deveria encerrar a rajada");
+    VERIFICAR(est.taxa_hz <= antes.taxa_hz, "depois da rajada: %u Hz, antes %u Hz", est.taxa_hz, antes.taxa_hz);
+    VERIFICAR(agendador_telemetria_divisor(CICLO_MS) > 5, "task_mpu ainda na taxa da rajada");
+    printf("rajada:      encerrada com %u B na fila, volta a %u Hz\n", (unsigned)est.outbox_bytes, est.taxa_hz);
+}
+
+int main(void) {
+    s_agora_us = 1000000;
+    enlace_t enlace = { .vazao_bps = 30000, .fila = 0, .rssi = -60 };
+    teste_subida(&enlace);
+    teste_congestionamento(&enlace);
+    teste_rajada(&enlace);
+    return teste_resultado("test_agendador_telemetria");
+}
@@ -0,0 +1,183 @@
+// host_test/test_codec_telemetria.c
+// Ida e volta do codec binário (main/TELEMETRIA/codec_telemetria.c) com um decodificador em C
+// equivalente ao de Interface/MQTT/codec_telemetria.py, incluindo perda de lote e troca de configuração.
+
+#include <string.h>
+#include <stdint.h>
+
+#include "codec_telemetria.h"
+#include "teste.h"
+
+// --- Decodificador de referência ---
+typedef struct {
+    bool tem_proximo;
+    uint32_t proximo;
+    bool sincronizado;
+    int64_t t, dt;
+    int64_t q[2];
+    uint32_t perdidas, descartadas;
+} decodificador_t;
+
+static uint64_t ler_varint(const uint8_t *d, size_t tam, size_t *i) {
+    uint64_t v = 0;
+    for (int desloc = 0; *i < tam && desloc < 64; desloc += 7) {
+        uint8_t b = d[(*i)++];
+        v |= (uint64_t)(b & 0x7F) << desloc;
+        if (b < 0x80) return v;
+    }
+    VERIFICAR(0, "varint truncado");
+    return v;
+}
+
+static int64_t des_zigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Amostras decodificadas em saida; devolve quantas (as descartadas até o keyframe não entram)
+static int decodificar(decodificador_t *dec, const uint8_t *d, size_t tam, telemetria_amostra_t *saida) {
+    VERIFICAR(tam >= 6 && d[0] == CODEC_VERSAO, "cabeçalho inválido");
+    uint8_t flags = d[1], keyframe = d[2];
+    float res = (d[3] | d[4] << 8) / 1000.0f;
+    size_t i = 5;
+    uint32_t contador = (uint32_t)ler_varint(d, tam, &i);
+    uint8_t n = d[i++];
+
+    if (dec->tem_proximo && contador != dec->proximo) {
+        dec->perdidas += contador - dec->proximo;
+        dec->sincronizado = false;
+    }
+    dec->tem_proximo = true;
+    dec->proximo = contador + n;
+
+    int saidas = 0;
+    for (int k = 0; k < n; k++) {
+        bool eh_keyframe = (k == 0 && (flags & CODEC_FLAG_KEYFRAME)) || (uint32_t)(contador + k) % keyframe == 0;
+        uint64_t a = ler_varint(d, tam, &i);
+        uint64_t b = ler_varint(d, tam, &i);
+        uint64_t c = ler_varint(d, tam, &i);
+        if (eh_keyframe) {
+            dec->t = (int64_t)a;
+            dec->dt = 0;
+            dec->q[0] = des_zigzag(b);
+            dec->q[1] = des_zigzag(c);
+            dec->sincronizado = true;
+        } else {
+            dec->dt += des_zigzag(a);
+            dec->t += dec->dt;
+            dec->q[0] += des_zigzag(b);
+            dec->q[1] += des_zigzag(c);
+        }
+        if (!dec->sincronizado) {
+            dec->descartadas++;
+            continue;
+        }
+        saida[saidas++] = (telemetria_amostra_t){ .t_us = dec->t, .pitch = dec->q[0] * res, .roll = dec->q[1] * res };
+    }
+    VERIFICAR(i == tam, "sobraram %zu bytes no lote", tam - i);
+    return saidas;
+}
+
+// --- Gerador de amostras (movimento + jitter de período) ---
+static uint32_t s_semente = 12345u;
+
+static uint32_t aleatorio(void) {
+    s_semente ^= s_semente << 13;
+    s_semente ^= s_semente >> 17;
+    s_semente ^= s_semente << 5;
+    return s_semente;
+}
+
+static telemetria_amostra_t gerar(int64_t *t_us, int k) {
+    *t_us += 50000 + (int64_t)(aleatorio() % 2001) - 1000;     // 20 Hz com ±1 ms
+    float pitch = 30.0f * sinf(k * 0.05f) + (aleatorio() % 100) * 0.001f;
+    float roll = -170.0f + (k % 400) * 0.85f;                  // Rampa larga
+    return (telemetria_amostra_t){ .t_us = *t_us, .pitch = pitch, .roll = roll };
+}
+
+// Codifica "total" amostras (fechando lotes como a task de telemetria) e compara com o decodificado.
+// descartar_lote: índice de um lote que "se perde" na rede (-1 = nenhum).
+static void ida_e_volta(int total, float resolucao, int keyframe, int descartar_lote, size_t *bytes) {
+    codec_telemetria_configurar(true, resolucao, keyframe, 1000);
+    VERIFICAR(codec_telemetria_ativo(), "codec não ativou");
+
+    static telemetria_amostra_t enviadas[4096];
+    telemetria_amostra_t recebidas[CODEC_LOTE_MAX_AMOSTRAS];
+    decodificador_t dec = { 0 };
+    int64_t t_us = 1000000;
+    int lote = 0, primeira_do_lote = 0, comparadas = 0, n_perdidas = 0;
+    bool perdeu = false;
+    *bytes = 0;
+
+    for (int k = 0; k < total; k++) {
+        enviadas[k] = gerar(&t_us, k);
+        bool pronto = codec_telemetria_adicionar(&enviadas[k]) || k == total - 1;
+        if (!pronto) continue;
+
+        const uint8_t *dados;
+        uint8_t n;
+        size_t tam = codec_telemetria_fechar(&dados, &n);
+        VERIFICAR(tam > 0 && tam <= CODEC_LOTE_MAX_BYTES, "lote de %zu bytes", tam);
+        VERIFICAR(n == k + 1 - primeira_do_lote, "n = %u", n);
+        *bytes += tam;
+
+        if (lote++ == descartar_lote) {
+            perdeu = true;
+            n_perdidas = n;
+        } else {
+            int m = decodificar(&dec, dados, tam, recebidas);
+            // Depois da perda só o fim do lote (a partir do keyframe) é decodificado
+            int inicio = k + 1 - m;
+            VERIFICAR(perdeu || m == n, "lote %d: %d de %u amostras", lote - 1, m, n);
+            for (int j = 0; j < m; j++) {
+                const telemetria_amostra_t *e = &enviadas[inicio + j];
+                VERIFICAR(recebidas[j].t_us == e->t_us, "t_us %lld != %lld", (long long)recebidas[j].t_us,
+                          (long long)e->t_us);
+                VERIFICAR_PERTO(recebidas[j].pitch, e->pitch, resolucao * 0.5 + 1e-4);
+                VERIFICAR_PERTO(recebidas[j].roll, e->roll, resolucao * 0.5 + 1e-4);
+                comparadas++;
+            }
+        }
+        primeira_do_lote = k + 1;
+        codec_telemetria_ativo();
+        if (s_teste_falhas > 20) return;
+    }
+
+    if (descartar_lote >= 0) {
+        VERIFICAR(dec.perdidas == (uint32_t)n_perdidas, "perdidas %u de %d", dec.perdidas, n_perdidas);
+        VERIFICAR(dec.descartadas > 0 && dec.descartadas < (uint32_t)keyframe, "descartadas %u", dec.descartadas);
+        VERIFICAR(comparadas == total - (int)dec.perdidas - (int)dec.descartadas, "comparadas %d", comparadas);
+    } else {
+        VERIFICAR(comparadas == total, "comparadas %d de %d", comparadas, total);
+    }
+}
+
+int main(void) {
+    size_t bytes;
+
+    ida_e_volta(2000, 0.01f, 50, -1, &bytes);
+    printf("0,01°, keyframe 50: %.2f bytes/amostra\n", bytes / 2000.0);
+    VERIFICAR(bytes / 2000.0 < 8.0, "%.2f bytes/amostra", bytes / 2000.0);
+
+    ida_e_volta(2000, 0.001f, 1, -1, &bytes);     // Só keyframes, resolução máxima
+    ida_e_volta(2000, 0.1f, 255, -1, &bytes);
+
+    // Lote perdido: o decodificador conta a perda e volta no próximo keyframe
+    ida_e_volta(2000, 0.01f, 50, 5, &bytes);
+
+    // Configuração nova só vale entre lotes e força keyframe na primeira amostra
+    codec_telemetria_configurar(true, 0.05f, 200, 1000);
+    int64_t t_us = 0;
+    telemetria_amostra_t a = gerar(&t_us, 0);
+    VERIFICAR(codec_telemetria_ativo(), "ativo");
+    codec_telemetria_adicionar(&a);
+    codec_telemetria_configurar(false, 0.01f, 50, 100);
+    VERIFICAR(codec_telemetria_ativo(), "desligou com lote aberto");
+    const uint8_t *dados;
+    uint8_t n;
+    size_t tam = codec_telemetria_fechar(&dados, &n);
+    VERIFICAR(n == 1 && dados[1] == CODEC_FLAG_KEYFRAME && dados[2] == 200, "flags %u keyframe %u", dados[1], dados[2]);
+    VERIFICAR(tam > 0, "tam");
+    VERIFICAR(!codec_telemetria_ativo(), "não desligou entre lotes");
+
+    return teste_resultado("test_codec_telemetria");
+}
@@ -0,0 +1,148 @@
+// host_test/test_energia.c
+// Autonomia por carga com e sem o gerenciador de energia (main/ENERGIA), numa curva de descarga
+// simulada de bateria 2S: tensão de circuito aberto pelo estado de carga, resistência interna e
+// corrente que depende do perfil aplicado. A leitura passa pela mesma média exponencial da
+// task da bateria (100 ms, alfa 0,2).
+//
+// Correntes estimadas para o hardware do gimbal (2 BLDC em malha aberta de tensão):
+//   motores: 0,45 A cada com Uq nominal; a corrente no enrolamento segue Uq e a potência Uq²,
+//            então do lado da bateria escala com fator_vlimit²
+//   ESP32:   ~40 mA a 1 kHz de controle, ~25 mA a 500 Hz, ~15 mA a 100 Hz
+//   Wi-Fi:   ~100 mA ativo, ~30 mA médio com modem sleep
+
+#include <string.h>
+
+#include "gerenciador_energia.h"
+#include "teste.h"
+
+#define CAPACIDADE_MAH      1000.0
+#define R_INTERNA_OHM       0.2         // Pack 2S
+#define CORTE_V             6.0         // Proteção do pack (fim da descarga)
+#define PASSO_S             0.1
+#define ALFA_SNAPSHOT       0.2
+
+// --- Stubs das dependências ---
+static bool s_wifi_economia;
+static int s_publicacoes;
+
+void wifi_definir_economia(bool ativo) {
+    s_wifi_economia = ativo;
+}
+
+void mqtt_publish_power_mode(const char *modo, bool forcado, float vbat) {
+    s_publicacoes++;
+}
+
+// --- Modelo da bateria ---
+// OCV de uma célula Li-ion/LiPo por estado de carga (0 a 100%, passos de 10%)
+static const double s_ocv_celula[11] = { 3.00, 3.45, 3.60, 3.68, 3.74, 3.78, 3.84, 3.92, 4.00, 4.08, 4.20 };
+
+static double ocv_pack(double soc) {
+    if (soc <= 0.0) return 2.0 * s_ocv_celula[0];
+    if (soc >= 1.0) return 2.0 * s_ocv_celula[10];
+    double x = soc * 10.0;
+    int i = (int)x;
+    return 2.0 * (s_ocv_celula[i] + (x - i) * (s_ocv_celula[i + 1] - s_ocv_celula[i]));
+}
+
+static double corrente_a(const energia_perfil_t *p) {
+    double i = p->wifi_economia ? 0.030 : 0.100;
+    i += p->periodo_controle_ms <= 1 ? 0.040 : (p->periodo_controle_ms <= 2 ? 0.025 : 0.015);
+    if (p->motores_ativos) i += 2.0 * 0.45 * p->fator_vlimit * p->fator_vlimit;
+    return i;
+}
+
+typedef struct {
+    double estabilizado_s;      // Tempo com os motores ligados
+    double total_s;             // Até o corte do pack
+    double tempo_modo_s[ENERGIA_NUM_MODOS];
+    int trocas;
+} resultado_t;
+
+// Descarrega do cheio até o corte. Sem gerenciador: perfil normal até o alerta de 6,4 V (antigo
+// LED piscando), quando o usuário desliga o gimbal.
+static resultado_t descarregar(bool gerenciado) {
+    static const energia_perfil_t normal = { 1.0f, 1, 50, false, true };
+    resultado_t r = { 0 };
+    double soc = 1.0, filtrada = 0.0;
+    energia_modo_t anterior = energia_obter_modo();
+
+    for (double t = 0.0; t < 48 * 3600.0; t += PASSO_S) {
+        const energia_perfil_t *p = gerenciado ? energia_obter_perfil() : &normal;
+        double i = corrente_a(p);
+        double vbat = ocv_pack(soc) - i * R_INTERNA_OHM;
+        if (vbat <= CORTE_V) break;
+
+        filtrada = (filtrada == 0.0) ? vbat : filtrada + ALFA_SNAPSHOT * (vbat - filtrada);
+        if (gerenciado) {
+            energia_atualizar_vbat((float)filtrada);
+            energia_modo_t modo = energia_obter_modo();
+            if (modo != anterior) r.trocas++;
+            VERIFICAR(modo >= anterior, "voltou de %s para %s a %.2f V durante a descarga",
+                      energia_nome_modo(anterior), energia_nome_modo(modo), filtrada);
+            anterior = modo;
+            r.tempo_modo_s[modo] += PASSO_S;
+        } else if (filtrada <= 6.4) {
+            // O gimbal sem gerenciador desliga no alerta; o ESP32 segue até o corte
+            static const energia_perfil_t desligado = { 0.0f, 1, 50, false, false };
+            p = &desligado;
+            i = corrente_a(p);
+        }
+        if (p->motores_ativos && (gerenciado || filtrada > 6.4)) r.estabilizado_s += PASSO_S;
+
+        soc -= i * PASSO_S / 3600.0 / (CAPACIDADE_MAH / 1000.0);
+        r.total_s = t;
+    }
+    return r;
+}
+
+static void teste_autonomia(void) {
+    energia_iniciar();
+    energia_forcar_modo(-1);
+
+    resultado_t base = descarregar(false);
+    resultado_t ger = descarregar(true);
+
+    printf("sem gerenciador: %.1f min estabilizado\n", base.estabilizado_s / 60.0);
+    printf("com gerenciador: %.1f min estabilizado (%+.1f%%), %d trocas de modo\n", ger.estabilizado_s / 60.0,
+           100.0 * (ger.estabilizado_s / base.estabilizado_s - 1.0), ger.trocas);
+    for (int m = 0; m < ENERGIA_NUM_MODOS; m++) {
+        printf("  %-9s %6.1f min\n", energia_nome_modo((energia_modo_t)m), ger.tempo_modo_s[m] / 60.0);
+    }
+
+    // Os modos degradados precisam estender a estabilização, não só adiar o alerta
+    VERIFICAR(ger.estabilizado_s > base.estabilizado_s * 1.05, "ganho de %.1f%%",
+              100.0 * (ger.estabilizado_s / base.estabilizado_s - 1.0));
+    // Cada modo é visitado uma vez: a queda de corrente na troca não pode fazer o modo oscilar
+    VERIFICAR(ger.trocas == ENERGIA_NUM_MODOS - 1, "%d trocas", ger.trocas);
+    VERIFICAR(energia_obter_modo() == ENERGIA_CRITICO, "terminou em %s", energia_nome_modo(energia_obter_modo()));
+    VERIFICAR(s_wifi_economia, "modem sleep não ativado");
+    VERIFICAR(s_publicacoes == ger.trocas, "%d publicações", s_publicacoes);
+}
+
+static void teste_critico_travado(void) {
+    // Com os motores desligados a tensão sobe: só sai do crítico com a bateria recarregada
+    energia_atualizar_vbat(6.3f);
+    VERIFICAR(energia_obter_modo() == ENERGIA_CRITICO, "%s", energia_nome_modo(energia_obter_modo()));
+    energia_atualizar_vbat(7.2f);
+    VERIFICAR(energia_obter_modo() == ENERGIA_CRITICO, "saiu do crítico sem recarga");
+    energia_atualizar_vbat(8.2f);
+    VERIFICAR(energia_obter_modo() == ENERGIA_NORMAL, "%s", energia_nome_modo(energia_obter_modo()));
+    VERIFICAR(!s_wifi_economia, "modem sleep continuou ativo");
+
+    // Modo forçado ignora a tensão até voltar ao automático
+    energia_forcar_modo(ENERGIA_RESERVA);
+    energia_atualizar_vbat(8.2f);
+    VERIFICAR(energia_obter_modo() == ENERGIA_RESERVA, "%s", energia_nome_modo(energia_obter_modo()));
+    energia_forcar_modo(-1);
+    VERIFICAR(energia_obter_modo() == ENERGIA_NORMAL, "%s", energia_nome_modo(energia_obter_modo()));
+
+    VERIFICAR(energia_modo_por_nome("auto") == -1 && energia_modo_por_nome("critico") == ENERGIA_CRITICO
+              && energia_modo_por_nome("x") == -2, "nomes");
+}
+
+int main(void) {
+    teste_autonomia();
+    teste_critico_travado();
+    return teste_resultado("test_energia");
+}
@@ -0,0 +1,129 @@
+// host_test/test_filtros.c
+// Resposta em frequência da cadeia de biquads (main/FILTROS): mede o ganho em regime com senoides.
+
+#include <string.h>
+#include <math.h>
+
+#include "filtros.h"
+#include "teste.h"
+
+#define FS_HZ   1000.0f
+
+// Ganho em regime (RMS saída / RMS entrada) de uma senoide em f_hz
+static float ganho(cadeia_filtros_t *c, float f_hz) {
+    for (int i = 0; i < c->n; i++) c->estagio[i].z1 = c->estagio[i].z2 = 0.0f;
+
+    int transitorio = (int)(2.0f * FS_HZ);      // Notch de Q alto demora a assentar
+    int medidas = (int)(2.0f * FS_HZ);
+    double soma_x = 0.0, soma_y = 0.0;
+    for (int n = 0; n < transitorio + medidas; n++) {
+        float x = sinf(2.0f * (float)M_PI * f_hz * n / FS_HZ);
+        float y = cadeia_aplicar(c, x);
+        if (n >= transitorio) {
+            soma_x += (double)x * x;
+            soma_y += (double)y * y;
+        }
+    }
+    return (float)sqrt(soma_y / soma_x);
+}
+
+static float db(float g) {
+    return 20.0f * log10f(g);
+}
+
+static void limpar(filtro_alvo_t alvo) {
+    for (int i = 0; i < FILTRO_MAX_ESTAGIOS; i++) filtros_definir_estagio(alvo, i, FILTRO_DESLIGADO, 0.0f, 0.0f);
+}
+
+static void teste_passa_baixa(void) {
+    cadeia_filtros_t c;
+    cadeia_iniciar(&c);
+    limpar(FILTRO_GIRO);
+    filtros_definir_estagio(FILTRO_GIRO, 0, FILTRO_PASSA_BAIXA, 50.0f, 0.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+
+    VERIFICAR(c.n == 1, "n = %d", c.n);
+    VERIFICAR_PERTO(db(ganho(&c, 1.0f)), 0.0, 0.05);
+    VERIFICAR_PERTO(db(ganho(&c, 50.0f)), -3.01, 0.2);       // Butterworth: -3 dB no corte
+    // 2ª ordem: -12 dB/oitava longe do corte (a transformação bilinear só atenua mais)
+    VERIFICAR(db(ganho(&c, 200.0f)) < -22.0f, "200 Hz: %.1f dB", db(ganho(&c, 200.0f)));
+    VERIFICAR(db(ganho(&c, 400.0f)) < -34.0f, "400 Hz: %.1f dB", db(ganho(&c, 400.0f)));
+}
+
+static void teste_notch(void) {
+    cadeia_filtros_t c;
+    cadeia_iniciar(&c);
+    limpar(FILTRO_SAIDA);
+    filtros_definir_estagio(FILTRO_SAIDA, 1, FILTRO_NOTCH, 120.0f, 4.0f);
+    cadeia_sincronizar(&c, FILTRO_SAIDA, FS_HZ);
+
+    // Estágio 0 desligado no meio da cadeia: identidade, mas conta em n
+    VERIFICAR(c.n == 2, "n = %d", c.n);
+    VERIFICAR(db(ganho(&c, 120.0f)) < -40.0f, "centro: %.1f dB", db(ganho(&c, 120.0f)));
+    // Banda de -3 dB = fc/Q = 30 Hz em torno do centro
+    VERIFICAR_PERTO(db(ganho(&c, 120.0f + 15.5f)), -3.0, 0.6);
+    VERIFICAR_PERTO(db(ganho(&c, 10.0f)), 0.0, 0.05);
+    VERIFICAR_PERTO(db(ganho(&c, 400.0f)), 0.0, 0.1);
+}
+
+static void teste_notch_dinamico(void) {
+    cadeia_filtros_t c;
+    cadeia_iniciar(&c);
+    limpar(FILTRO_GIRO);
+    filtros_definir_estagio(FILTRO_GIRO, 0, FILTRO_NOTCH_DINAMICO, 0.0f, 6.0f);
+
+    // Sem pico conhecido: identidade
+    filtros_definir_pico(0.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR_PERTO(db(ganho(&c, 80.0f)), 0.0, 0.01);
+
+    filtros_definir_pico(80.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR(db(ganho(&c, 80.0f)) < -40.0f, "80 Hz: %.1f dB", db(ganho(&c, 80.0f)));
+
+    // Dentro da histerese (1 Hz) não recalcula; fora dela segue o pico
+    uint32_t versao = c.versao;
+    filtros_definir_pico(80.5f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR(c.versao == versao, "recalculou dentro da histerese");
+
+    filtros_definir_pico(150.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR(db(ganho(&c, 150.0f)) < -40.0f, "150 Hz: %.1f dB", db(ganho(&c, 150.0f)));
+    VERIFICAR_PERTO(db(ganho(&c, 80.0f)), 0.0, 1.0);
+    filtros_definir_pico(0.0f);
+}
+
+static void teste_limites(void) {
+    cadeia_filtros_t c;
+    cadeia_iniciar(&c);
+    limpar(FILTRO_GIRO);
+
+    VERIFICAR(!filtros_definir_estagio(FILTRO_NUM_ALVOS, 0, FILTRO_NOTCH, 50.0f, 4.0f), "alvo inválido aceito");
+    VERIFICAR(!filtros_definir_estagio(FILTRO_GIRO, FILTRO_MAX_ESTAGIOS, FILTRO_NOTCH, 50.0f, 4.0f), "estágio inválido aceito");
+
+    // Corte perto de Nyquist vira identidade em vez de um filtro instável
+    filtros_definir_estagio(FILTRO_GIRO, 0, FILTRO_PASSA_BAIXA, 460.0f, 0.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR_PERTO(db(ganho(&c, 100.0f)), 0.0, 0.01);
+
+    // Mudança de fs recalcula sem nova configuração
+    filtros_definir_estagio(FILTRO_GIRO, 0, FILTRO_PASSA_BAIXA, 50.0f, 0.0f);
+    cadeia_sincronizar(&c, FILTRO_GIRO, 500.0f);
+    float b0_500 = c.estagio[0].b0;
+    cadeia_sincronizar(&c, FILTRO_GIRO, FS_HZ);
+    VERIFICAR(c.estagio[0].b0 != b0_500, "fs mudou e os coeficientes não");
+
+    VERIFICAR(filtros_alvo_por_nome("saida") == FILTRO_SAIDA, "alvo por nome");
+    VERIFICAR(filtros_tipo_por_nome("notch_dinamico") == FILTRO_NOTCH_DINAMICO, "tipo por nome");
+    VERIFICAR(filtros_tipo_por_nome("xyz") == -1, "nome desconhecido");
+    limpar(FILTRO_GIRO);
+}
+
+int main(void) {
+    teste_passa_baixa();
+    teste_notch();
+    teste_notch_dinamico();
+    teste_limites();
+    return teste_resultado("test_filtros");
+}
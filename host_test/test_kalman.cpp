@@ -0,0 +1,71 @@
+// host_test/test_kalman.cpp
+// KalmanBank<2> contra dois KalmanFilter escalares (a implementação anterior) na mesma entrada:
+// ângulo e bias têm de coincidir nos modos fixo e adaptativo, ao longo de 100 s a 1 kHz.
+// A diferença esperada é só de arredondamento (o banco multiplica por 1/S e guarda Q_bias/fator_r).
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "teste.h"
+#include "KalmanBank.h"
+#include "kalman_escalar.h"
+
+#define PASSOS      100000
+#define DT          0.001f
+#define DIVISOR     4           // Update a cada 4 predicts, como o DIVISOR_ACEL_PADRAO
+#define TOL_RAD     1e-6f
+
+static uint32_t semente;
+static float ruido(float amplitude) {
+    semente = semente * 1664525u + 1013904223u;
+    return amplitude * ((semente >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+static void comparar(bool adaptativo) {
+    KalmanBank<2> banco;
+    KalmanFilter escalar[2];
+    banco.adaptativo = adaptativo;
+    for (int e = 0; e < 2; e++) escalar[e].adaptativo = adaptativo;
+
+    semente = 1;
+    float dif_angulo = 0.0f, dif_bias = 0.0f, dif_fator = 0.0f;
+    for (int i = 0; i < PASSOS; i++) {
+        float t = i * DT;
+        float real[2] = { 0.3f * sinf(1.1f * t), 0.2f * sinf(0.7f * t + 1.0f) };
+        float taxa[2] = { 0.33f * cosf(1.1f * t) + 0.02f + ruido(0.05f),
+                          0.14f * cosf(0.7f * t + 1.0f) - 0.01f + ruido(0.05f) };
+
+        banco.predict(taxa, DT);
+        for (int e = 0; e < 2; e++) escalar[e].predict(taxa[e], DT);
+
+        if (i % DIVISOR == 0) {
+            // Vibração em rajadas: |a| sai de 1 g e o ângulo do acelerômetro piora
+            bool vibrando = (i / 5000) % 2 == 1;
+            float desvio_g = vibrando ? fabsf(ruido(0.3f)) : fabsf(ruido(0.01f));
+            float medido[2];
+            for (int e = 0; e < 2; e++) medido[e] = real[e] + ruido(vibrando ? 0.2f : 0.01f);
+
+            banco.update(medido, desvio_g);
+            for (int e = 0; e < 2; e++) escalar[e].update(medido[e], desvio_g);
+        }
+
+        for (int e = 0; e < 2; e++) {
+            dif_angulo = fmaxf(dif_angulo, fabsf(banco.angle[e] - escalar[e].angle));
+            dif_bias = fmaxf(dif_bias, fabsf(banco.bias[e] - escalar[e].bias));
+            dif_fator = fmaxf(dif_fator, fabsf(banco.fator_r[e] - escalar[e].fator_r) / escalar[e].fator_r);
+        }
+    }
+
+    printf("%-11s máx |banco - escalar|: ângulo %.2e rad, bias %.2e rad/s, fator_r %.2e (relativo)\n",
+           adaptativo ? "adaptativo" : "fixo", dif_angulo, dif_bias, dif_fator);
+    VERIFICAR(dif_angulo < TOL_RAD, "ângulo difere %.3e rad", dif_angulo);
+    VERIFICAR(dif_bias < TOL_RAD, "bias difere %.3e rad/s", dif_bias);
+    VERIFICAR(dif_fator < 1e-4f, "fator_r difere %.3e", dif_fator);
+}
+
+int main(void) {
+    comparar(false);
+    comparar(true);
+    return teste_resultado("test_kalman");
+}
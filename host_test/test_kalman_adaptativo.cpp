@@ -0,0 +1,136 @@
+// host_test/test_kalman_adaptativo.cpp
+// Kalman adaptativo (mpu_definir_kalman_adaptativo) contra o R/Q fixo com vibração injetada
+// no acelerômetro: 10 s parado, 10 s vibrando (aceleração linear de 0.3 g em 37/53/71 Hz) e
+// 10 s parado, com o gimbal oscilando devagar e um bias constante no giroscópio.
+// O erro de ângulo adaptativo não pode passar do fixo, e um ciclo (predict + update nos dois
+// eixos) tem de caber com folga no ciclo de 1 ms da task_mpu.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "teste.h"
+#include "KalmanBank.h"
+
+#define DT              0.001f
+#define DIVISOR         4               // DIVISOR_ACEL_PADRAO
+#define DURACAO_S       30
+#define VIBRACAO_INI_S  10
+#define VIBRACAO_FIM_S  20
+#define VIBRACAO_G      0.3f
+#define ORCAMENTO_US    1000.0          // Um ciclo da task_mpu a 1 kHz
+#define FRACAO_MAX      0.01            // O Kalman pode usar até 1% dele (no PC)
+
+static uint32_t semente;
+static float ruido(float amplitude) {
+    semente = semente * 1664525u + 1013904223u;
+    return amplitude * ((semente >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+typedef struct {
+    double rms_vibrando;
+    double rms_parado;
+    float bias_final[2];
+} resultado_t;
+
+static resultado_t simular(bool adaptativo) {
+    KalmanBank<2> k;
+    k.adaptativo = adaptativo;
+    semente = 7;
+
+    const float bias_giro[2] = { 0.02f, -0.015f };     // rad/s
+    double soma_vib = 0.0, soma_par = 0.0;
+    int n_vib = 0, n_par = 0;
+    const int passos = (int)(DURACAO_S / DT);
+
+    for (int i = 0; i < passos; i++) {
+        float t = i * DT;
+        float pitch = 0.2f * sinf(0.5f * t);
+        float roll  = 0.15f * sinf(0.3f * t + 0.5f);
+        float taxa[2] = { 0.1f * cosf(0.5f * t) + bias_giro[0] + ruido(0.02f),
+                          0.045f * cosf(0.3f * t + 0.5f) + bias_giro[1] + ruido(0.02f) };
+        k.predict(taxa, DT);
+
+        bool vibrando = t >= VIBRACAO_INI_S && t < VIBRACAO_FIM_S;
+        if (i % DIVISOR == 0) {
+            // Gravidade no referencial do sensor + aceleração linear da vibração (em g)
+            float ax = -sinf(pitch), ay = sinf(roll) * cosf(pitch), az = cosf(roll) * cosf(pitch);
+            if (vibrando) {
+                ax += VIBRACAO_G * sinf(2.0f * (float)M_PI * 37.0f * t);
+                ay += VIBRACAO_G * sinf(2.0f * (float)M_PI * 53.0f * t);
+                az += VIBRACAO_G * sinf(2.0f * (float)M_PI * 71.0f * t);
+            }
+            ax += ruido(0.005f);
+            ay += ruido(0.005f);
+            az += ruido(0.005f);
+
+            // Como na task_mpu
+            float medido[2] = { atan2f(-ax, sqrtf(ay*ay + az*az)), atan2f(ay, az) };
+            float desvio_g = fabsf(sqrtf(ax*ax + ay*ay + az*az) - 1.0f);
+            k.update(medido, desvio_g);
+        }
+
+        float e0 = k.angle[0] - pitch, e1 = k.angle[1] - roll;
+        if (vibrando) { soma_vib += e0*e0 + e1*e1; n_vib += 2; }
+        else if (t >= 2.0f) { soma_par += e0*e0 + e1*e1; n_par += 2; }  // Sem a convergência inicial
+    }
+
+    resultado_t r;
+    r.rms_vibrando = sqrt(soma_vib / n_vib);
+    r.rms_parado = sqrt(soma_par / n_par);
+    r.bias_final[0] = k.bias[0] - bias_giro[0];
+    r.bias_final[1] = k.bias[1] - bias_giro[1];
+    return r;
+}
+
+static void teste_erro(void) {
+    resultado_t fixo = simular(false);
+    resultado_t adap = simular(true);
+    printf("erro RMS (grau)   vibrando   parado   erro de bias final (rad/s)\n");
+    printf("fixo              %8.3f %8.3f   %+.4f %+.4f\n", fixo.rms_vibrando * 180 / M_PI,
+           fixo.rms_parado * 180 / M_PI, fixo.bias_final[0], fixo.bias_final[1]);
+    printf("adaptativo        %8.3f %8.3f   %+.4f %+.4f\n", adap.rms_vibrando * 180 / M_PI,
+           adap.rms_parado * 180 / M_PI, adap.bias_final[0], adap.bias_final[1]);
+
+    VERIFICAR(adap.rms_vibrando <= fixo.rms_vibrando, "vibrando: adaptativo %.4f > fixo %.4f rad",
+              adap.rms_vibrando, fixo.rms_vibrando);
+    // Sem vibração o adaptativo volta ao R nominal: no máximo 10% pior que o fixo
+    VERIFICAR(adap.rms_parado <= 1.1 * fixo.rms_parado, "parado: adaptativo %.4f, fixo %.4f rad",
+              adap.rms_parado, fixo.rms_parado);
+}
+
+// Custo de um ciclo no pior caso (update em todo ciclo, modo adaptativo)
+static void teste_custo(void) {
+    KalmanBank<2> k;
+    k.adaptativo = true;
+    const int ciclos = 200000;
+    float taxa[2] = { 0.01f, -0.02f };
+    float medido[2] = { 0.1f, -0.1f };
+
+    double t0 = agora_ns();
+    for (int i = 0; i < ciclos; i++) {
+        taxa[0] = -taxa[0];
+        k.predict(taxa, DT);
+        k.update(medido, 0.01f * (i & 7));
+    }
+    double us = (agora_ns() - t0) / 1000.0 / ciclos;
+    volatile float dreno = k.angle[0] + k.angle[1];
+    (void)dreno;
+
+    printf("custo: %.3f us por ciclo (%.3f%% do ciclo de 1 kHz)\n", us, 100.0 * us / ORCAMENTO_US);
+    VERIFICAR(us <= FRACAO_MAX * ORCAMENTO_US, "%.3f us por ciclo, máximo %.1f us", us,
+              FRACAO_MAX * ORCAMENTO_US);
+}
+
+int main(void) {
+    teste_erro();
+    teste_custo();
+    return teste_resultado("test_kalman_adaptativo");
+}
@@ -0,0 +1,211 @@
+// host_test/test_modelo_termico.c
+// Modelo bias x temperatura do giroscópio (main/MPU6050/ModeloTermico.cpp) com deriva sintética:
+// rampa de aquecimento com e sem compensação, esquecimento do ajuste, limite de inclinação,
+// rebase na recalibração e persistência na NVS em memória.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "teste.h"
+#include "nvs_host.h"
+#include "ModeloTermico.h"
+
+#define AMOSTRA_S           1.0f            // termico_amostrar a 1 Hz, como na task_mpu
+#define INCLINACAO_MAXIMA   0.005f          // ModeloTermico.cpp
+#define MINUTOS_US          (60 * 1000000LL)
+
+static uint32_t semente = 1;
+static float ruido(float amplitude) {
+    semente = semente * 1664525u + 1013904223u;
+    return amplitude * ((semente >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+// Deriva do giroscópio: bias = base + inclinação·(T - 25)
+typedef struct {
+    float base;
+    float inclinacao;
+} deriva_t;
+
+static float bias_real(const deriva_t *d, float temp_c) {
+    return d->base + d->inclinacao * (temp_c - 25.0f);
+}
+
+static float inclinacao_modelo(termico_eixo_t eixo) {
+    float b25, b35;
+    if (!termico_prever(eixo, 25.0f, &b25) || !termico_prever(eixo, 35.0f, &b35)) return NAN;
+    return (b35 - b25) / 10.0f;
+}
+
+// Modelo vazio: NVS apagada antes de carregar
+static void reiniciar_vazio(void) {
+    nvs_host_apagar();
+    termico_iniciar();
+}
+
+// Temperatura oscilando entre 25 e 35 grau C (período de 20 min); o bias amostrado é o do Kalman
+static void treinar(termico_eixo_t eixo, const deriva_t *d, int amostras, float ruido_bias) {
+    for (int i = 0; i < amostras; i++) {
+        float temp = 30.0f + 5.0f * sinf(2.0f * (float)M_PI * i / 1200.0f);
+        termico_amostrar(eixo, temp, bias_real(d, temp) + ruido(ruido_bias));
+    }
+}
+
+// Sem faixa de temperatura ou com poucas amostras o modelo não é usado
+static void teste_validade(void) {
+    reiniciar_vazio();
+    float b;
+    VERIFICAR(!termico_prever(TERMICO_PITCH, 30.0f, &b), "modelo vazio não deveria prever");
+
+    for (int i = 0; i < 200; i++) termico_amostrar(TERMICO_PITCH, 30.0f + ruido(0.2f), 0.01f);
+    VERIFICAR(!termico_prever(TERMICO_PITCH, 30.0f, &b), "temperatura constante não deveria bastar");
+
+    for (int i = 0; i < 20; i++) termico_amostrar(TERMICO_ROLL, 25.0f + i, 0.01f);
+    VERIFICAR(!termico_prever(TERMICO_ROLL, 30.0f, &b), "20 amostras não deveriam bastar");
+    for (int i = 0; i < 20; i++) termico_amostrar(TERMICO_ROLL, 25.0f + i, 0.01f);
+    VERIFICAR(termico_prever(TERMICO_ROLL, 30.0f, &b), "40 amostras em 20 grau C deveriam bastar");
+}
+
+// Aquecimento de 25 a 45 grau C em 1 h: bias residual e ângulo integrado com e sem o modelo.
+// Treina numa rampa, religa com offsets novos (rebase no boot) e compara na rampa seguinte.
+static void teste_rampa(void) {
+    reiniciar_vazio();
+    deriva_t d = { 0.010f, 0.0008f };
+    for (int i = 0; i < 3600; i++) {
+        float temp = 25.0f + 20.0f * i / 3600.0f;
+        termico_amostrar(TERMICO_PITCH, temp, bias_real(&d, temp) + ruido(0.002f));
+    }
+
+    // Novo boot: a calibração mudou o offset e o bias medido no boot realinha o modelo
+    d.base -= 0.004f;
+    float bias_boot = bias_real(&d, 25.0f);
+    termico_rebasear(TERMICO_PITCH, 25.0f, bias_boot);
+
+    double soma_sem = 0.0, soma_com = 0.0, angulo_sem = 0.0, angulo_com = 0.0;
+    for (int i = 0; i < 3600; i++) {
+        float temp = 25.0f + 20.0f * i / 3600.0f;
+        float real = bias_real(&d, temp);
+        float previsto;
+        VERIFICAR(termico_prever(TERMICO_PITCH, temp, &previsto), "modelo deveria estar válido");
+        float r_sem = real - bias_boot;         // Bias congelado no valor do boot
+        float r_com = real - previsto;
+        soma_sem += r_sem * r_sem;
+        soma_com += r_com * r_com;
+        angulo_sem += r_sem * AMOSTRA_S;
+        angulo_com += r_com * AMOSTRA_S;
+        termico_amostrar(TERMICO_PITCH, temp, real + ruido(0.002f));
+    }
+    double rms_sem = sqrt(soma_sem / 3600), rms_com = sqrt(soma_com / 3600);
+    printf("rampa 25->45 grau C: bias residual RMS %.5f -> %.5f rad/s, ângulo integrado %.1f -> %.2f rad\n",
+           rms_sem, rms_com, angulo_sem, angulo_com);
+    VERIFICAR(rms_com < 0.1 * rms_sem, "bias residual %.5f com modelo, %.5f sem", rms_com, rms_sem);
+    VERIFICAR(fabs(angulo_com) < 0.1 * fabs(angulo_sem), "ângulo integrado %.3f com modelo, %.3f sem",
+              angulo_com, angulo_sem);
+}
+
+// Fator de esquecimento: depois de ~4 memórias (0.9999 -> 10000 amostras) vale a inclinação nova
+static void teste_esquecimento(void) {
+    reiniciar_vazio();
+    deriva_t antes = { 0.0f, 0.0010f };
+    deriva_t depois = { 0.0f, -0.0010f };
+    treinar(TERMICO_ROLL, &antes, 20000, 0.001f);
+    float i0 = inclinacao_modelo(TERMICO_ROLL);
+    VERIFICAR_PERTO(i0, antes.inclinacao, 5e-5);
+
+    treinar(TERMICO_ROLL, &depois, 1200, 0.001f);
+    float i1 = inclinacao_modelo(TERMICO_ROLL);
+    VERIFICAR(i1 > 0.0f, "20 min depois ainda deveria lembrar a inclinação antiga (%.5f)", i1);
+
+    treinar(TERMICO_ROLL, &depois, 40000, 0.001f);
+    float i2 = inclinacao_modelo(TERMICO_ROLL);
+    printf("esquecimento: inclinação %.5f -> %.5f (20 min) -> %.5f (11 h), real %.5f\n", i0, i1, i2,
+           depois.inclinacao);
+    VERIFICAR_PERTO(i2, depois.inclinacao, 1e-4);
+}
+
+// Inclinação fora do plausível fica no limite
+static void teste_limite(void) {
+    reiniciar_vazio();
+    deriva_t d = { 0.0f, 0.02f };
+    treinar(TERMICO_PITCH, &d, 2400, 0.0f);
+    VERIFICAR_PERTO(inclinacao_modelo(TERMICO_PITCH), INCLINACAO_MAXIMA, 1e-6);
+
+    reiniciar_vazio();
+    d.inclinacao = -0.02f;
+    treinar(TERMICO_PITCH, &d, 2400, 0.0f);
+    VERIFICAR_PERTO(inclinacao_modelo(TERMICO_PITCH), -INCLINACAO_MAXIMA, 1e-6);
+}
+
+// Recalibração: o modelo passa pelo bias novo e mantém a inclinação; o outro eixo não muda
+static void teste_rebase(void) {
+    reiniciar_vazio();
+    deriva_t d = { 0.005f, 0.0015f };
+    treinar(TERMICO_PITCH, &d, 2400, 0.0f);
+    treinar(TERMICO_ROLL, &d, 2400, 0.0f);
+    float incl = inclinacao_modelo(TERMICO_PITCH);
+    float roll_antes;
+    termico_prever(TERMICO_ROLL, 32.0f, &roll_antes);
+
+    termico_rebasear(TERMICO_PITCH, 32.0f, -0.003f);
+    float b;
+    VERIFICAR(termico_prever(TERMICO_PITCH, 32.0f, &b), "modelo deveria continuar válido");
+    VERIFICAR_PERTO(b, -0.003f, 1e-6);
+    VERIFICAR_PERTO(inclinacao_modelo(TERMICO_PITCH), incl, 1e-6);
+    float roll_depois;
+    termico_prever(TERMICO_ROLL, 32.0f, &roll_depois);
+    VERIFICAR(roll_depois == roll_antes, "rebase do pitch mudou o roll");
+
+    // Sem amostras não há o que deslocar
+    reiniciar_vazio();
+    termico_rebasear(TERMICO_PITCH, 30.0f, 0.01f);
+    VERIFICAR(!termico_prever(TERMICO_PITCH, 30.0f, &b), "rebase não deveria validar um modelo vazio");
+}
+
+// A task de gravação roda em outra thread: espera (tempo real) a contagem de gravações
+static bool esperar_gravacoes(uint32_t n) {
+    for (int i = 0; i < 1000 && nvs_host_gravacoes() < n; i++) usleep(1000);
+    return nvs_host_gravacoes() >= n;
+}
+
+// Gravação com intervalo mínimo, nova tentativa após falha e recarga no boot
+static void teste_persistencia(void) {
+    reiniciar_vazio();
+    deriva_t d = { 0.002f, 0.001f };
+    treinar(TERMICO_PITCH, &d, 2400, 0.0f);
+    uint32_t g = nvs_host_gravacoes();
+
+    // Primeira gravação falha: o modelo continua marcado e sai no próximo intervalo
+    nvs_host_falhar_escritas(1, ESP_FAIL);
+    termico_persistir(100 * MINUTOS_US);
+    usleep(20000);
+    VERIFICAR(nvs_host_gravacoes() == g, "gravação com falha contou");
+
+    termico_persistir(105 * MINUTOS_US);
+    usleep(20000);
+    VERIFICAR(nvs_host_gravacoes() == g, "gravou antes do intervalo mínimo");
+
+    termico_persistir(111 * MINUTOS_US);
+    VERIFICAR(esperar_gravacoes(g + 1), "nova tentativa não gravou");
+
+    float antes, depois;
+    termico_prever(TERMICO_PITCH, 40.0f, &antes);
+    termico_iniciar();
+    VERIFICAR(termico_prever(TERMICO_PITCH, 40.0f, &depois), "modelo não recarregado da NVS");
+    VERIFICAR(antes == depois, "previsão recarregada %.6f, antes %.6f", depois, antes);
+
+    // Sem amostras novas não grava de novo
+    termico_persistir(200 * MINUTOS_US);
+    usleep(20000);
+    VERIFICAR(nvs_host_gravacoes() == g + 1, "gravou sem amostras novas");
+}
+
+int main(void) {
+    teste_validade();
+    teste_rampa();
+    teste_esquecimento();
+    teste_limite();
+    teste_rebase();
+    teste_persistencia();
+    return teste_resultado("test_modelo_termico");
+}
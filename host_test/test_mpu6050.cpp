@@ -0,0 +1,329 @@
+// host_test/test_mpu6050.cpp
+// components/I2Cdev e components/MPU6050 contra o modelo de registradores (modelo_mpu6050.c).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "teste.h"
+#include "freertos_host.h"
+#include "modelo_mpu6050.h"
+#include "MPU6050.h"
+
+#define ENDERECO        MPU6050_DEFAULT_ADDRESS
+#define LSB_POR_DPS     131.0f
+#define LSB_POR_G       16384.0f
+
+static MPU6050 mpu;
+
+// Sensor novo, acordado e configurado como no boot do firmware
+static void religar(void) {
+    modelo_mpu_iniciar(ENDERECO);
+    mpu = MPU6050(ENDERECO);
+    mpu.initialize();
+    I2Cdev::resetStats();
+    modelo_mpu_zerar_barramento();
+}
+
+static void teste_conexao_e_inicializacao(void) {
+    modelo_mpu_iniciar(ENDERECO);
+    mpu = MPU6050(ENDERECO);
+    VERIFICAR(mpu.testConnection(), "WHO_AM_I deveria identificar o MPU6050");
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_PWR_MGMT_1) & 0x40, "sensor deveria ligar dormindo");
+
+    mpu.initialize();
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_PWR_MGMT_1) == MPU6050_CLOCK_PLL_XGYRO,
+              "PWR_MGMT_1 = 0x%02x, esperado acordado com PLL do giro X",
+              modelo_mpu_registrador(MPU6050_RA_PWR_MGMT_1));
+
+    // Outro endereço não responde
+    MPU6050 ausente(MPU6050_ADDRESS_AD0_HIGH);
+    VERIFICAR(!ausente.testConnection(), "0x69 não deveria responder");
+}
+
+// O I2Cdev conta o mesmo tráfego que o dispositivo vê no fio
+static void teste_contadores(void) {
+    religar();
+    int16_t ax, ay, az, gx, gy, gz;
+    mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+    mpu.setXGyroOffset(10);
+    mpu.getFIFOCount();
+
+    I2CdevStats est;
+    mpu_barramento_t fio;
+    I2Cdev::getStats(&est);
+    modelo_mpu_obter_barramento(&fio);
+    VERIFICAR(est.transactions == 3, "transações = %u, esperado 3", (unsigned)est.transactions);
+    VERIFICAR(est.transactions == fio.transacoes, "I2Cdev %u x fio %u", (unsigned)est.transactions,
+              (unsigned)fio.transacoes);
+    VERIFICAR(est.bytesWritten + est.bytesRead == fio.bytes, "I2Cdev %u + %u bytes x fio %u",
+              (unsigned)est.bytesWritten, (unsigned)est.bytesRead, (unsigned)fio.bytes);
+    VERIFICAR(est.bytesRead == 14 + 2, "bytes lidos = %u", (unsigned)est.bytesRead);
+}
+
+// Com auto-sync desligado as mudanças de configuração saem numa rajada só
+static void teste_sombra(void) {
+    religar();
+    mpu.setAutoSync(false);
+    mpu.setRate(9);
+    mpu.setDLPFMode(MPU6050_DLPF_BW_42);
+    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
+    VERIFICAR(mpu.getRate() == 9, "leitura deveria vir da sombra");
+
+    I2CdevStats est;
+    I2Cdev::getStats(&est);
+    VERIFICAR(est.transactions == 0, "%u transações antes do sync", (unsigned)est.transactions);
+
+    VERIFICAR(mpu.sync(), "sync falhou");
+    I2Cdev::getStats(&est);
+    VERIFICAR(est.transactions == 1, "%u transações no sync, esperado 1", (unsigned)est.transactions);
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_SMPLRT_DIV) == 9, "SMPLRT_DIV não escrito");
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_GYRO_CONFIG) == (MPU6050_GYRO_FS_500 << 3), "GYRO_CONFIG não escrito");
+
+    // Falha de escrita mantém a sombra suja para o próximo sync
+    mpu.setRate(4);
+    modelo_mpu_falhar(1, ESP_ERR_TIMEOUT);
+    VERIFICAR(!mpu.sync(), "sync deveria falhar");
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_SMPLRT_DIV) == 9, "registrador não deveria mudar");
+    VERIFICAR(mpu.sync(), "segundo sync deveria escrever");
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_SMPLRT_DIV) == 4, "SMPLRT_DIV = %u",
+              modelo_mpu_registrador(MPU6050_RA_SMPLRT_DIV));
+    mpu.setAutoSync(true);
+}
+
+// Divisor de taxa, data-ready e FIFO
+static void teste_taxa_e_fifo(void) {
+    religar();
+    mpu.setDLPFMode(MPU6050_DLPF_BW_42);    // 1 kHz
+    mpu.setRate(9);                         // 100 Hz
+    I2Cdev::writeByte(ENDERECO, MPU6050_RA_FIFO_EN, 0x78);
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
+    mpu.getIntStatus();                     // Limpa data-ready e overflow
+
+    vTaskDelay(pdMS_TO_TICKS(100));
+    uint16_t contagem = mpu.getFIFOCount();
+    VERIFICAR(contagem >= 9 * 12 && contagem <= 11 * 12, "FIFO com %u bytes, esperado ~10 pacotes", contagem);
+    VERIFICAR(contagem % 12 == 0, "pacote incompleto: %u bytes", contagem);
+
+    VERIFICAR(mpu.getIntDataReadyStatus(), "data-ready deveria estar ativo");
+    VERIFICAR(!mpu.getIntDataReadyStatus(), "leitura de INT_STATUS deveria limpar data-ready");
+    vTaskDelay(pdMS_TO_TICKS(10));
+    VERIFICAR(mpu.getIntDataReadyStatus(), "nova amostra em 10 ms a 100 Hz");
+
+    // 1 kHz enche os 1024 bytes em ~85 ms
+    mpu.setRate(0);
+    mpu.getIntStatus();
+    vTaskDelay(pdMS_TO_TICKS(200));
+    VERIFICAR(mpu.getFIFOCount() == MODELO_MPU_FIFO_TAM, "FIFO = %u bytes, esperado cheia", mpu.getFIFOCount());
+    VERIFICAR(mpu.getIntFIFOBufferOverflowStatus(), "overflow deveria estar sinalizado");
+    mpu.resetFIFO();
+    VERIFICAR(mpu.getFIFOCount() == 0, "resetFIFO deveria esvaziar a FIFO");
+
+    // Dormindo não há amostras
+    mpu.setSleepEnabled(true);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    VERIFICAR(mpu.getFIFOCount() == 0, "FIFO encheu com o sensor dormindo");
+    mpu.setSleepEnabled(false);
+}
+
+// Offsets entram na saída na escala de cada faixa
+static void teste_offsets(void) {
+    religar();
+    const float bias_acel[3] = { 0.05f, -0.03f, 0.02f };
+    const float bias_giro[3] = { 2.0f, -1.5f, 0.5f };
+    modelo_mpu_definir_bias(bias_acel, bias_giro);
+    vTaskDelay(1);
+
+    int16_t gx, gy, gz;
+    mpu.getRotation(&gx, &gy, &gz);
+    VERIFICAR_PERTO(gx, 2.0f * LSB_POR_DPS, 1);
+
+    // Offset de giro em 32.8 LSB/(grau/s): -65 cancela quase 2 grau/s a 250 grau/s
+    mpu.setXGyroOffset(-65);
+    VERIFICAR(mpu.getXGyroOffset() == -65, "offset lido = %d", mpu.getXGyroOffset());
+    vTaskDelay(1);
+    mpu.getRotation(&gx, &gy, &gz);
+    VERIFICAR_PERTO(gx, 2.0f * LSB_POR_DPS - 65 * 4, 1);
+
+    // Em 500 grau/s a contribuição do offset cai pela metade, junto com a escala
+    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
+    vTaskDelay(1);
+    mpu.getRotation(&gx, &gy, &gz);
+    VERIFICAR_PERTO(gx, (2.0f * LSB_POR_DPS - 65 * 4) / 2, 1);
+    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_250);
+
+    // Calibração rápida pela FIFO cancela o bias de todos os eixos
+    mpu.setXGyroOffset(0);
+    modelo_mpu_definir_ruido(4);
+    VERIFICAR(mpu.CalibrateFast(true, 1), "CalibrateFast falhou");
+    float media[6];
+    mpu.setDLPFMode(MPU6050_DLPF_BW_188);
+    mpu.setFIFOEnabled(true);   // CalibrateFast devolve o USER_CTRL de antes (FIFO desligada)
+    VERIFICAR(mpu.MeanFromFIFO(media, 200), "MeanFromFIFO falhou");
+    for (int i = 0; i < 3; i++) {
+        VERIFICAR_PERTO(media[3 + i], 0.0f, 4.0f);
+    }
+    // Offset do acelerômetro anda de 2 em 2 (bit 0 reservado) = 16 LSB a 2 g, truncado pelo driver
+    VERIFICAR_PERTO(media[0], 0.0f, 16.0f);
+    VERIFICAR_PERTO(media[1], 0.0f, 16.0f);
+    VERIFICAR_PERTO(media[2], LSB_POR_G, 16.0f);
+    modelo_mpu_definir_ruido(0);
+
+    // FIFO que nunca enche (sensor dormindo): desiste sem travar
+    mpu.setSleepEnabled(true);
+    VERIFICAR(!mpu.MeanFromFIFO(media, 10), "MeanFromFIFO deveria desistir");
+    mpu.setSleepEnabled(false);
+}
+
+// Movimento gravado: senoide no giro X e inclinação no acelerômetro, num CSV
+static void teste_reproducao(void) {
+    religar();
+    char caminho[] = "/tmp/movimento_mpuXXXXXX";
+    int fd = mkstemp(caminho);
+    VERIFICAR(fd >= 0, "sem arquivo temporário");
+    if (fd < 0) return;
+    FILE *f = fdopen(fd, "w");
+    fprintf(f, "t_us,ax,ay,az,gx,gy,gz,temp\n");
+    for (int i = 0; i < 100; i++) {
+        float t = i * 0.005f;
+        fprintf(f, "%d,%.4f,0,%.4f,%.3f,-1.0,0,%.2f\n", i * 5000, sinf(0.1f * i) * 0.5f,
+                cosf(0.1f * i) * 0.5f + 0.5f, 50.0f * sinf(2.0f * (float)M_PI * 4.0f * t), 30.0f + 0.01f * i);
+    }
+    fclose(f);
+
+    static mpu_movimento_t gravado[128];
+    size_t n = modelo_mpu_carregar_csv(caminho, gravado, 128);
+    remove(caminho);
+    VERIFICAR(n == 100, "%zu amostras lidas do CSV", n);
+    if (n != 100) return;
+
+    // 1 kHz: a amostra mais recente está a menos de 1 ms da leitura
+    mpu.setDLPFMode(MPU6050_DLPF_BW_188);
+    mpu.setRate(0);
+    modelo_mpu_reproduzir(gravado, n, true);
+    int64_t inicio = freertos_host_agora_us();
+
+    // Passa do fim da gravação (500 ms) para cobrir a repetição
+    for (int k = 0; k < 250; k += 7) {
+        // Lê no meio da amostra gravada k (5 ms cada) para não depender da borda
+        int64_t falta = (int64_t)k * 5000 + 2500 - (freertos_host_agora_us() - inicio);
+        vTaskDelay(pdMS_TO_TICKS(falta / 1000));
+
+        int16_t ax, ay, az, gx, gy, gz;
+        mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+        int16_t temp = mpu.getTemperature();
+        const mpu_movimento_t *g = &gravado[k % 100];
+        VERIFICAR_PERTO(ax, g->acel_g[0] * LSB_POR_G, 1);
+        VERIFICAR_PERTO(az, g->acel_g[2] * LSB_POR_G, 1);
+        VERIFICAR_PERTO(gx, g->giro_dps[0] * LSB_POR_DPS, 1);
+        VERIFICAR_PERTO(gy, -LSB_POR_DPS, 1);
+        VERIFICAR_PERTO(temp, (g->temp_c - 36.53f) * 340.0f, 1);
+    }
+
+    // Sem repetir, segura a última amostra
+    modelo_mpu_reproduzir(gravado, n, false);
+    vTaskDelay(pdMS_TO_TICKS(800));
+    int16_t gx, gy, gz;
+    mpu.getRotation(&gx, &gy, &gz);
+    VERIFICAR_PERTO(gx, gravado[99].giro_dps[0] * LSB_POR_DPS, 1);
+}
+
+// DMP: blocos que cruzam bancos de 256 bytes
+static void teste_memoria_dmp(void) {
+    religar();
+    static uint8_t escrito[600], lido[600];
+    for (int i = 0; i < 600; i++) escrito[i] = (uint8_t)(i * 7 + 3);
+
+    VERIFICAR(mpu.writeMemoryBlock(escrito, sizeof(escrito), 1, 200, false), "writeMemoryBlock falhou");
+    VERIFICAR(modelo_mpu_memoria(1, 200) == escrito[0], "início fora do lugar");
+    VERIFICAR(modelo_mpu_memoria(2, 0) == escrito[56], "virada do banco 1 para o 2");
+    VERIFICAR(modelo_mpu_memoria(4, 31) == escrito[599], "fim fora do lugar");
+
+    mpu.readMemoryBlock(lido, sizeof(lido), 1, 200);
+    VERIFICAR(memcmp(escrito, lido, sizeof(lido)) == 0, "leitura difere da escrita");
+
+    // Reset do dispositivo apaga a memória e os registradores
+    mpu.reset();
+    VERIFICAR(modelo_mpu_memoria(1, 200) == 0, "memória do DMP deveria zerar no reset");
+    VERIFICAR(mpu.getSleepEnabled(), "depois do reset o sensor volta a dormir");
+}
+
+// Leitura assíncrona: mesmo resultado da síncrona, prazo perdido e recuperação
+static void teste_assincrono(void) {
+    religar();
+    const float bias_acel[3] = { 0, 0, 0 };
+    const float bias_giro[3] = { 10.0f, -20.0f, 0 };
+    modelo_mpu_definir_bias(bias_acel, bias_giro);
+    vTaskDelay(1);
+
+    uint8_t sinc[4], assinc[4];
+    I2Cdev::readBytes(ENDERECO, MPU6050_RA_GYRO_XOUT_H, 4, sinc);
+    VERIFICAR(I2Cdev::readBytesAsync(ENDERECO, MPU6050_RA_GYRO_XOUT_H, 4), "pedido recusado");
+    VERIFICAR(I2Cdev::waitAsync(assinc, 4, 2) == ESP_OK, "leitura assíncrona falhou");
+    VERIFICAR(memcmp(sinc, assinc, 4) == 0, "assíncrona difere da síncrona");
+
+    // Barramento preso: o prazo vence e conta como timeout
+    modelo_mpu_travar(true);
+    VERIFICAR(I2Cdev::readBytesAsync(ENDERECO, MPU6050_RA_GYRO_XOUT_H, 4), "pedido recusado");
+    VERIFICAR(I2Cdev::waitAsync(assinc, 4, 2) == ESP_ERR_TIMEOUT, "deveria perder o prazo");
+    I2CdevStats est;
+    I2Cdev::getStats(&est);
+    VERIFICAR(est.timeouts == 1, "timeouts = %u", (unsigned)est.timeouts);
+    modelo_mpu_travar(false);
+
+    // A conclusão atrasada é descartada pela próxima espera
+    memset(assinc, 0, sizeof(assinc));
+    while (!I2Cdev::readBytesAsync(ENDERECO, MPU6050_RA_GYRO_XOUT_H, 4)) {
+    }
+    VERIFICAR(I2Cdev::waitAsync(assinc, 4, 10) == ESP_OK, "leitura depois do destravamento falhou");
+    VERIFICAR(memcmp(sinc, assinc, 4) == 0, "dados depois do destravamento");
+}
+
+// Falhas seguidas disparam o reset do barramento
+static void teste_recuperacao(void) {
+    religar();
+    modelo_mpu_falhar(3, ESP_ERR_TIMEOUT);
+    uint8_t id;
+    for (int i = 0; i < 3; i++) {
+        VERIFICAR(I2Cdev::readByte(ENDERECO, MPU6050_RA_WHO_AM_I, &id) == 0, "leitura %d deveria falhar", i);
+    }
+    VERIFICAR(I2Cdev::readByte(ENDERECO, MPU6050_RA_WHO_AM_I, &id) == 1 && id == 0x68, "sem recuperação");
+
+    I2CdevStats est;
+    mpu_barramento_t fio;
+    I2Cdev::getStats(&est);
+    modelo_mpu_obter_barramento(&fio);
+    VERIFICAR(est.errors == 3 && est.timeouts == 3, "erros %u, timeouts %u", (unsigned)est.errors,
+              (unsigned)est.timeouts);
+    VERIFICAR(est.busResets == 1 && fio.resets == 1, "resets: I2Cdev %u, fio %u", (unsigned)est.busResets,
+              (unsigned)fio.resets);
+
+    // Leitura falha no read-modify-write: nada é escrito com o byte não lido
+    religar();
+    uint8_t antes = modelo_mpu_registrador(MPU6050_RA_INT_ENABLE);
+    modelo_mpu_falhar(1, ESP_ERR_TIMEOUT);
+    VERIFICAR(!I2Cdev::writeBit(ENDERECO, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DATA_RDY_BIT, 1),
+              "writeBit deveria falhar");
+    I2Cdev::getStats(&est);
+    VERIFICAR(est.transactions == 1, "%u transações, esperado só a leitura", (unsigned)est.transactions);
+    VERIFICAR(modelo_mpu_registrador(MPU6050_RA_INT_ENABLE) == antes, "INT_ENABLE mudou");
+}
+
+int main(void) {
+    I2Cdev::begin((gpio_num_t)21, (gpio_num_t)22, 400000);
+
+    teste_conexao_e_inicializacao();
+    teste_contadores();
+    teste_sombra();
+    teste_taxa_e_fifo();
+    teste_offsets();
+    teste_reproducao();
+    teste_memoria_dmp();
+    teste_assincrono();
+    teste_recuperacao();
+    return teste_resultado("test_mpu6050");
+}
@@ -0,0 +1,161 @@
+// host_test/test_multitaxa.cpp
+// Caminho de leitura da task_mpu (giroscópio X/Y todo ciclo, bloco completo a cada N) sobre o
+// modelo de registradores: o mesmo movimento reproduzido com divisor 1 e 4 tem de dar ângulos
+// do Kalman equivalentes, com menos bytes no barramento.
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "teste.h"
+#include "freertos_host.h"
+#include "modelo_mpu6050.h"
+#include "MPU6050.h"
+#include "KalmanBank.h"
+
+#define ENDERECO        MPU6050_DEFAULT_ADDRESS
+#define PERIODO_US      1000
+#define DURACAO_S       20
+#define AMOSTRAS        (DURACAO_S * 1000000 / PERIODO_US)
+#define INICIO_ERRO_S   3           // Ignora a convergência do bias
+#define TAM_GIRO        4           // SensorMPU6050.cpp: TAM_LEITURA_GIRO / TAM_LEITURA_COMPLETA
+#define TAM_BLOCO       12
+#define LSB_POR_DPS     65.5f       // +/-500 grau/s, como na task_mpu
+#define DIF_MAX_GRAUS   0.05        // Diferença aceita no erro RMS entre divisor 1 e 4
+
+static MPU6050 mpu;
+static mpu_movimento_t movimento[AMOSTRAS];
+
+// Ângulos verdadeiros (rad) e derivadas (rad/s)
+static void verdade(float t, float angulo[2], float taxa[2]) {
+    const float w0 = 2.0f * (float)M_PI * 0.5f, w1 = 2.0f * (float)M_PI * 0.8f;
+    angulo[0] = 0.3f * sinf(w0 * t);                // Pitch
+    angulo[1] = 0.2f * sinf(w1 * t + 1.0f);         // Roll
+    taxa[0] = 0.3f * w0 * cosf(w0 * t);
+    taxa[1] = 0.2f * w1 * cosf(w1 * t + 1.0f);
+}
+
+static void gerar_movimento(void) {
+    for (int i = 0; i < AMOSTRAS; i++) {
+        float t = i * PERIODO_US * 1e-6f;
+        float ang[2], taxa[2];
+        verdade(t, ang, taxa);
+        mpu_movimento_t *m = &movimento[i];
+        m->t_us = (int64_t)i * PERIODO_US;
+        m->acel_g[0] = -sinf(ang[0]);
+        m->acel_g[1] = sinf(ang[1]) * cosf(ang[0]);
+        m->acel_g[2] = cosf(ang[1]) * cosf(ang[0]);
+        m->giro_dps[0] = taxa[1] * 180.0f / (float)M_PI;   // X: roll
+        m->giro_dps[1] = taxa[0] * 180.0f / (float)M_PI;   // Y: pitch
+        m->giro_dps[2] = 0.0f;
+        m->temp_c = 30.0f;
+    }
+}
+
+typedef struct {
+    double rms_graus;
+    uint32_t bytes_lidos;
+} resultado_t;
+
+// Reproduz o movimento com o laço de leitura e o Kalman da task_mpu
+static resultado_t rodar(uint8_t divisor) {
+    modelo_mpu_iniciar(ENDERECO);
+    const float bias_acel[3] = { 0, 0, 0 };
+    const float bias_giro[3] = { 0.5f, -0.4f, 0 };
+    modelo_mpu_definir_bias(bias_acel, bias_giro);
+    modelo_mpu_definir_ruido(8);
+
+    mpu = MPU6050(ENDERECO);
+    mpu.initialize();
+    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
+    mpu.setDLPFMode(MPU6050_DLPF_BW_42);    // 1 kHz
+    mpu.setRate(0);
+    I2Cdev::setSpeed(ENDERECO, 1000000);
+    I2Cdev::resetStats();
+
+    modelo_mpu_reproduzir(movimento, AMOSTRAS, false);
+    int64_t inicio = freertos_host_agora_us();
+
+    KalmanBank<2> kalman;
+    float taxa[2] = { 0.0f, 0.0f }, medido[2];
+    bool primeira = true;
+    int ciclo_acel = 0;
+    int64_t anterior = inicio;
+    double soma = 0.0;
+    int n = 0;
+    uint8_t bruto[TAM_BLOCO];
+
+    for (int i = 1; i < AMOSTRAS; i++) {
+        // Próximo ciclo de 1 ms (o fio já avançou parte dele)
+        int64_t falta = inicio + (int64_t)i * PERIODO_US - freertos_host_agora_us();
+        if (falta > 0) freertos_host_avancar_us(falta);
+        int64_t agora = freertos_host_agora_us();
+        float dt = (agora - anterior) * 1e-6f;
+        anterior = agora;
+
+        bool completa = primeira || (++ciclo_acel >= divisor);
+        uint8_t reg = completa ? MPU6050_RA_ACCEL_XOUT_H : MPU6050_RA_GYRO_XOUT_H;
+        uint8_t tamanho = completa ? TAM_BLOCO : TAM_GIRO;
+        if (!I2Cdev::readBytesAsync(ENDERECO, reg, tamanho) || I2Cdev::waitAsync(bruto, tamanho, 2) != ESP_OK) {
+            VERIFICAR(false, "leitura %d falhou", i);
+            break;
+        }
+
+        const uint8_t *giro = bruto + tamanho - TAM_GIRO;
+        int16_t gx = (int16_t)((giro[0] << 8) | giro[1]);
+        int16_t gy = (int16_t)((giro[2] << 8) | giro[3]);
+        taxa[1] = (gx / LSB_POR_DPS) * (float)M_PI / 180.0f;
+        taxa[0] = (gy / LSB_POR_DPS) * (float)M_PI / 180.0f;
+
+        if (!primeira) kalman.predict(taxa, dt);
+        if (completa) {
+            ciclo_acel = 0;
+            float ax = (int16_t)((bruto[0] << 8) | bruto[1]);
+            float ay = (int16_t)((bruto[2] << 8) | bruto[3]);
+            float az = (int16_t)((bruto[4] << 8) | bruto[5]);
+            medido[0] = atan2f(-ax, sqrtf(ay*ay + az*az));
+            medido[1] = atan2f(ay, az);
+            if (primeira) {
+                kalman.angle[0] = medido[0];
+                kalman.angle[1] = medido[1];
+                primeira = false;
+            } else {
+                kalman.update(medido);
+            }
+        }
+
+        float t = (agora - inicio) * 1e-6f;
+        if (t >= INICIO_ERRO_S) {
+            float ang[2], ignorada[2];
+            verdade(t, ang, ignorada);
+            float e0 = kalman.angle[0] - ang[0], e1 = kalman.angle[1] - ang[1];
+            soma += e0*e0 + e1*e1;
+            n += 2;
+        }
+    }
+
+    I2CdevStats est;
+    I2Cdev::getStats(&est);
+    resultado_t r;
+    r.rms_graus = sqrt(soma / (n ? n : 1)) * 180.0 / M_PI;
+    r.bytes_lidos = est.bytesRead;
+    return r;
+}
+
+int main(void) {
+    I2Cdev::begin((gpio_num_t)21, (gpio_num_t)22, 400000);
+    gerar_movimento();
+
+    resultado_t d1 = rodar(1);
+    resultado_t d4 = rodar(4);
+    printf("divisor 1: erro RMS %.3f grau, %u bytes lidos\n", d1.rms_graus, (unsigned)d1.bytes_lidos);
+    printf("divisor 4: erro RMS %.3f grau, %u bytes lidos\n", d4.rms_graus, (unsigned)d4.bytes_lidos);
+
+    VERIFICAR(d1.rms_graus < 1.0, "divisor 1: erro RMS %.3f grau", d1.rms_graus);
+    VERIFICAR(fabs(d4.rms_graus - d1.rms_graus) <= DIF_MAX_GRAUS, "divisor 4 %.3f x divisor 1 %.3f grau",
+              d4.rms_graus, d1.rms_graus);
+    // 6 bytes por ciclo em média contra 12 (a primeira leitura é sempre completa)
+    VERIFICAR(fabs(2.0 * d4.bytes_lidos / d1.bytes_lidos - 1.0) < 0.01,
+              "bytes lidos: %u com divisor 4, %u com divisor 1", (unsigned)d4.bytes_lidos, (unsigned)d1.bytes_lidos);
+    return teste_resultado("test_multitaxa");
+}
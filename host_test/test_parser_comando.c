@@ -0,0 +1,170 @@
+// host_test/test_parser_comando.c
+// Casos conhecidos e fuzz do parser de setpoint (main/WIFI_MQTT/parser_comando.c).
+// Cada entrada é copiada para um buffer do tamanho exato: o ASan acusa qualquer leitura além de len.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "parser_comando.h"
+#include "teste.h"
+
+#define ITERACOES_PADRAO    200000
+#define ENTRADA_MAX         256
+
+static uint32_t s_semente = 0x6d2b79f5u;
+
+static uint32_t aleatorio(void) {
+    // xorshift32: reprodutível entre plataformas
+    s_semente ^= s_semente << 13;
+    s_semente ^= s_semente >> 17;
+    s_semente ^= s_semente << 5;
+    return s_semente;
+}
+
+static parser_resultado_t analisar(const char *dados, int len, setpoint_t *sp, bool *tem_seq) {
+    char *copia = malloc(len > 0 ? (size_t)len : 1);
+    if (len > 0) memcpy(copia, dados, (size_t)len);
+    parser_resultado_t r = parser_setpoint(copia, len, sp, tem_seq);
+    free(copia);
+    return r;
+}
+
+static parser_resultado_t analisar_txt(const char *txt, setpoint_t *sp, bool *tem_seq) {
+    return analisar(txt, (int)strlen(txt), sp, tem_seq);
+}
+
+// Invariantes de qualquer resultado aceito
+static void verificar_aceito(parser_resultado_t r, const setpoint_t *sp, bool tem_seq, const char *entrada, int len) {
+    if (r != PARSER_SETPOINT && r != PARSER_STREAM) return;
+    VERIFICAR(isfinite(sp->pitch) && isfinite(sp->roll), "%.*s", len, entrada);
+    VERIFICAR(sp->velocidade >= 0.0f && sp->tempo_s >= 0.0f, "%.*s", len, entrada);
+    VERIFICAR(r != PARSER_STREAM || tem_seq, "stream sem seq: %.*s", len, entrada);
+}
+
+static void teste_casos(void) {
+    setpoint_t sp;
+    bool seq;
+
+    VERIFICAR(analisar_txt("{\"pitch\":10.5,\"roll\":-3}", &sp, &seq) == PARSER_SETPOINT, "básico");
+    VERIFICAR_PERTO(sp.pitch, 10.5, 1e-6);
+    VERIFICAR_PERTO(sp.roll, -3.0, 1e-6);
+    VERIFICAR(!seq, "seq sem \"seq\"");
+
+    VERIFICAR(analisar_txt(" {\n\"roll\" : 1e1 , \"pitch\":-0.25,\"vel\":30,\"tempo\":1.5,\"seq\":7,\"id\":9,\"th\":123} \r\n",
+                           &sp, &seq) == PARSER_SETPOINT, "espaços, ordem e opcionais");
+    VERIFICAR_PERTO(sp.roll, 10.0, 1e-6);
+    VERIFICAR_PERTO(sp.velocidade, 30.0, 1e-6);
+    VERIFICAR_PERTO(sp.tempo_s, 1.5, 1e-6);
+    VERIFICAR(seq && sp.seq == 7 && sp.id == 9 && sp.th_ms == 123, "seq %u id %u th %u", sp.seq, sp.id, sp.th_ms);
+
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"seq\":4294967295,\"t\":500}", &sp, &seq) == PARSER_STREAM, "stream");
+    VERIFICAR(sp.seq == 4294967295u && sp.t_ms == 500, "seq %u t %u", sp.seq, sp.t_ms);
+
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"t\":500}", &sp, &seq) == PARSER_INVALIDO, "t sem seq");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"seq\":4294967296}", &sp, &seq) == PARSER_INVALIDO, "seq > u32");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"seq\":-1}", &sp, &seq) == PARSER_INVALIDO, "seq negativo");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"seq\":1.5}", &sp, &seq) == PARSER_INVALIDO, "seq fracionário");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2,\"vel\":-1}", &sp, &seq) == PARSER_INVALIDO, "vel negativa");
+    VERIFICAR(analisar_txt("{\"pitch\":1}", &sp, &seq) == PARSER_INVALIDO, "sem roll");
+    VERIFICAR(analisar_txt("{\"pitch\":1e999,\"roll\":2}", &sp, &seq) == PARSER_INVALIDO, "infinito");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2E72}", &sp, &seq) == PARSER_INVALIDO, "finito em double, inf em float");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"roll\":2}x", &sp, &seq) == PARSER_INVALIDO, "lixo no fim");
+    VERIFICAR(analisar_txt("{\"pitch\":1,,\"roll\":2}", &sp, &seq) == PARSER_INVALIDO, "vírgula dupla");
+    VERIFICAR(analisar_txt("{\"pitch\":\"1\",\"roll\":2}", &sp, &seq) == PARSER_INVALIDO, "número em string");
+    VERIFICAR(analisar_txt("{\"pitch\":1.2.3,\"roll\":2}", &sp, &seq) == PARSER_INVALIDO, "número malformado");
+    VERIFICAR(analisar_txt("{\"pitch\":1234567890123456789012345678901234,\"roll\":2}", &sp, &seq) == PARSER_INVALIDO,
+              "número longo demais");
+    VERIFICAR(analisar_txt("{}", &sp, &seq) == PARSER_INVALIDO, "vazio");
+    VERIFICAR(analisar("", 0, &sp, &seq) == PARSER_INVALIDO, "len 0");
+    VERIFICAR(parser_setpoint(NULL, 5, &sp, &seq) == PARSER_INVALIDO, "NULL");
+
+    // Outras chaves vão para o cJSON, inclusive chaves longas ou com escape
+    VERIFICAR(analisar_txt("{\"filtro\":{\"alvo\":\"giro\"}}", &sp, &seq) == PARSER_OUTRO, "configuração");
+    VERIFICAR(analisar_txt("{\"pitch\":1,\"kp_pitch\":2}", &sp, &seq) == PARSER_OUTRO, "setpoint + configuração");
+    VERIFICAR(analisar_txt("{\"uma_chave_bem_mais_longa_que_16\":1}", &sp, &seq) == PARSER_OUTRO, "chave longa");
+    VERIFICAR(analisar_txt("{\"pi\\\"tch\":1}", &sp, &seq) == PARSER_OUTRO, "chave com escape");
+    VERIFICAR(analisar_txt("{\"uma_chave_bem_mais_longa_que_16", &sp, &seq) == PARSER_INVALIDO, "chave longa cortada");
+}
+
+// Todo prefixo próprio de um comando válido é incompleto
+static void teste_truncamentos(void) {
+    static const char *validos[] = {
+        "{\"pitch\":10.5,\"roll\":-3}",
+        "{\"pitch\":1,\"roll\":2,\"vel\":30,\"tempo\":1.5,\"seq\":7,\"id\":9,\"th\":123}",
+        "{\"pitch\":-1e-3,\"roll\":2E+2,\"seq\":42,\"t\":99}",
+    };
+    setpoint_t sp;
+    bool seq;
+    for (size_t i = 0; i < sizeof(validos) / sizeof(validos[0]); i++) {
+        int len = (int)strlen(validos[i]);
+        VERIFICAR(analisar(validos[i], len, &sp, &seq) != PARSER_INVALIDO, "%s", validos[i]);
+        for (int n = 1; n < len; n++) {
+            parser_resultado_t r = analisar(validos[i], n, &sp, &seq);
+            VERIFICAR(r == PARSER_INVALIDO, "prefixo %d de %s -> %d", n, validos[i], r);
+        }
+    }
+}
+
+// Mutações de comandos válidos e bytes aleatórios: sem leitura fora do buffer e invariantes mantidas
+static void teste_fuzz(long iteracoes) {
+    static const char *sementes[] = {
+        "{\"pitch\":10.5,\"roll\":-3}",
+        "{\"pitch\":1,\"roll\":2,\"vel\":30,\"tempo\":1.5,\"seq\":7,\"id\":9,\"th\":123}",
+        "{\"pitch\":-1e-3,\"roll\":2E+2,\"seq\":42,\"t\":99}",
+        "{\"kp_pitch\":1.2,\"filtro\":{\"alvo\":\"giro\",\"estagio\":0}}",
+    };
+    static const char alfabeto[] = "{}[]\":,.-+eE0123456789 \\\ttpirolchsqvemda\x00\xff";
+    const int num_sementes = sizeof(sementes) / sizeof(sementes[0]);
+
+    char entrada[ENTRADA_MAX];
+    setpoint_t sp;
+    bool seq;
+    long aceitos = 0;
+    for (long it = 0; it < iteracoes; it++) {
+        int len;
+        if (aleatorio() % 8 == 0) {
+            len = (int)(aleatorio() % ENTRADA_MAX);
+            for (int i = 0; i < len; i++) {
+                entrada[i] = (aleatorio() & 1) ? (char)aleatorio() : alfabeto[aleatorio() % (sizeof(alfabeto) - 1)];
+            }
+        } else {
+            const char *base = sementes[aleatorio() % num_sementes];
+            len = (int)strlen(base);
+            memcpy(entrada, base, (size_t)len);
+            int mutacoes = 1 + (int)(aleatorio() % 4);
+            for (int m = 0; m < mutacoes && len > 0; m++) {
+                int pos = (int)(aleatorio() % (uint32_t)len);
+                char novo = alfabeto[aleatorio() % (sizeof(alfabeto) - 1)];
+                switch (aleatorio() % 4) {
+                case 0: entrada[pos] = novo; break;                                     // troca
+                case 1: memmove(&entrada[pos], &entrada[pos + 1], (size_t)(len - pos - 1)); len--; break;  // remove
+                case 2:                                                                 // insere
+                    if (len < ENTRADA_MAX) {
+                        memmove(&entrada[pos + 1], &entrada[pos], (size_t)(len - pos));
+                        entrada[pos] = novo;
+                        len++;
+                    }
+                    break;
+                default: len = pos; break;                                              // corta
+                }
+            }
+        }
+
+        parser_resultado_t r = analisar(entrada, len, &sp, &seq);
+        VERIFICAR(r >= PARSER_SETPOINT && r <= PARSER_INVALIDO, "resultado %d", r);
+        verificar_aceito(r, &sp, seq, entrada, len);
+        if (r == PARSER_SETPOINT || r == PARSER_STREAM) aceitos++;
+        if (s_teste_falhas > 20) return;
+    }
+    printf("fuzz: %ld entradas, %ld aceitas como setpoint\n", iteracoes, aceitos);
+    VERIFICAR(aceitos > 0, "nenhuma mutação aceita: o fuzz não está exercitando o caminho válido");
+}
+
+int main(int argc, char **argv) {
+    long iteracoes = argc > 1 ? atol(argv[1]) : ITERACOES_PADRAO;
+    teste_casos();
+    teste_truncamentos();
+    teste_fuzz(iteracoes);
+    return teste_resultado("test_parser_comando");
+}
@@ -0,0 +1,127 @@
+// host_test/test_pid_tensao.c
+// Resposta ao degrau do laço de pitch (PID de main/PID/pid.c) numa planta simulada, da bateria
+// cheia à descarregada, com a compensação atual (voltage_power_supply = vbat) e com a antiga
+// alimentação fixa em 12 V.
+//
+// Planta: BLDC de gimbal em velocity_openloop (SimpleFOC). O campo gira na velocidade pedida pelo
+// PID e puxa o rotor como uma mola de rigidez pp * Kt/R * U: com U menor o rotor atrasa mais e
+// o laço muda. U real = Uq (cortado em driver_vlimit / 2 pela SinePWM) * vbat / voltage_power_supply.
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "pid.h"
+#include "teste.h"
+
+#define PARES_POLOS         7
+#define KT_NM_A             0.05    // Constante de torque
+#define R_FASE_OHM          10.0
+#define INERCIA             2.0e-4  // kg m² (rotor + câmera)
+#define ATRITO              1.8e-3  // N m s/rad
+#define DESBALANCO_NM       0.004   // Torque da gravidade com a câmera fora do eixo
+#define VELOCIDADE_LIMITE   20.0    // motor.velocity_limit (rad/s)
+#define DT_CONTROLE         0.001
+#define SUBPASSOS           10
+#define DEGRAU_RAD          0.2
+#define DURACAO_S           3.0
+
+typedef struct {
+    double subida_s;        // 10% a 90%
+    double sobressinal;     // Fração do degrau
+    double acomodacao_s;    // Até ficar em ±2%
+    double iae;             // Integral do erro absoluto
+} resposta_t;
+
+static resposta_t degrau(double vbat, bool compensado) {
+    tensoes_motor_t t;
+    pid_tensoes_para_vbat((float)vbat, 1.0f, &t);
+    if (!compensado) {
+        // Antes: alimentação fixa em 12 V e limites de bateria cheia
+        t.voltage_power_supply = 12.0f;
+        t.driver_vlimit = DRIVER_VLIMIT_MAX;
+        t.motor_vlimit = MOTOR_VLIMIT_NOMINAL;
+    }
+    double uq = fmin(t.motor_vlimit, t.driver_vlimit * 0.5);
+    double u_real = fmin(uq * vbat / t.voltage_power_supply, vbat * 0.5);
+    double torque_max = KT_NM_A * u_real / R_FASE_OHM * 1.5;   // Três fases
+
+    PID_t pid;
+    PID_Init(&pid, 8.0f, 0.01f, 1.0f);
+
+    // Parte do equilíbrio em 0: o rotor já atrasa o campo o suficiente para segurar o desbalanço
+    double theta = 0.0, omega = 0.0;
+    double campo = asin(fmin(1.0, DESBALANCO_NM / torque_max)) / PARES_POLOS;
+
+    resposta_t r = { 0 };
+    double t10 = -1.0, t90 = -1.0, pico = 0.0, ultima_fora = 0.0;
+    for (int k = 0; k < (int)(DURACAO_S / DT_CONTROLE); k++) {
+        double tempo = k * DT_CONTROLE;
+        float erro = (float)(DEGRAU_RAD - theta);
+        if (fabsf(erro) < 0.005f) erro = 0.0f;      // Deadzone da task_pid
+        double v = PID_Compute(&pid, erro, (float)theta, DT_CONTROLE);
+        v = fmax(-VELOCIDADE_LIMITE, fmin(VELOCIDADE_LIMITE, v));
+
+        for (int s = 0; s < SUBPASSOS; s++) {
+            double h = DT_CONTROLE / SUBPASSOS;
+            campo += v * h;
+            double torque = torque_max * sin(PARES_POLOS * (campo - theta)) - ATRITO * omega
+                            - DESBALANCO_NM * cos(theta);
+            omega += torque / INERCIA * h;
+            theta += omega * h;
+        }
+
+        if (t10 < 0.0 && theta >= 0.1 * DEGRAU_RAD) t10 = tempo;
+        if (t90 < 0.0 && theta >= 0.9 * DEGRAU_RAD) t90 = tempo;
+        if (theta > pico) pico = theta;
+        if (fabs(theta - DEGRAU_RAD) > 0.02 * DEGRAU_RAD) ultima_fora = tempo;
+        r.iae += fabs(DEGRAU_RAD - theta) * DT_CONTROLE;
+    }
+    r.subida_s = (t10 >= 0.0 && t90 >= 0.0) ? t90 - t10 : INFINITY;
+    r.sobressinal = fmax(0.0, pico / DEGRAU_RAD - 1.0);
+    r.acomodacao_s = ultima_fora + DT_CONTROLE;
+    return r;
+}
+
+static double desvio(double valor, double referencia) {
+    return fabs(valor / referencia - 1.0);
+}
+
+int main(void) {
+    static const double tensoes[] = { 8.4, 7.6, 7.0, 6.7, 6.4 };   // Cheia até o alerta (2S)
+    const int n = sizeof(tensoes) / sizeof(tensoes[0]);
+
+    resposta_t ref = degrau(tensoes[0], true);
+    resposta_t ref_fixo = degrau(tensoes[0], false);
+    double pior_compensado = 0.0, pior_fixo = 0.0;     // Variação do tempo de subida
+    printf(" vbat | compensado: subida  sobressinal  acomodação  IAE     | fixo 12 V: subida  sobressinal  acomodação  IAE\n");
+    for (int i = 0; i < n; i++) {
+        resposta_t c = degrau(tensoes[i], true);
+        resposta_t f = degrau(tensoes[i], false);
+        printf(" %.1f |   %6.0f ms  %8.1f%%  %8.0f ms  %.4f | %6.0f ms  %8.1f%%  %8.0f ms  %.4f\n", tensoes[i],
+               c.subida_s * 1e3, c.sobressinal * 100.0, c.acomodacao_s * 1e3, c.iae,
+               f.subida_s * 1e3, f.sobressinal * 100.0, f.acomodacao_s * 1e3, f.iae);
+
+        VERIFICAR(desvio(c.subida_s, ref.subida_s) < 0.05, "%.1f V: subida %.0f ms (ref %.0f)",
+                  tensoes[i], c.subida_s * 1e3, ref.subida_s * 1e3);
+        VERIFICAR(fabs(c.sobressinal - ref.sobressinal) < 0.02, "%.1f V: sobressinal %.1f%% (ref %.1f%%)",
+                  tensoes[i], c.sobressinal * 100.0, ref.sobressinal * 100.0);
+        VERIFICAR(desvio(c.iae, ref.iae) < 0.05, "%.1f V: IAE %.4f (ref %.4f)", tensoes[i], c.iae, ref.iae);
+        pior_compensado = fmax(pior_compensado, desvio(c.subida_s, ref.subida_s));
+        pior_fixo = fmax(pior_fixo, desvio(f.subida_s, ref_fixo.subida_s));
+    }
+    printf("maior variação do tempo de subida: %.1f%% compensado, %.1f%% com 12 V fixo\n",
+           pior_compensado * 100.0, pior_fixo * 100.0);
+
+    // O modelo precisa ser sensível à tensão, senão a comparação não prova nada
+    VERIFICAR(pior_fixo > 4.0 * pior_compensado && pior_fixo > 0.05, "fixo %.1f%%, compensado %.1f%%",
+              pior_fixo * 100.0, pior_compensado * 100.0);
+
+    // Limites: driver com margem e Uq sem corte da SinePWM
+    tensoes_motor_t t;
+    pid_tensoes_para_vbat(12.6f, 1.0f, &t);
+    VERIFICAR(t.driver_vlimit == DRIVER_VLIMIT_MAX && t.motor_vlimit == MOTOR_VLIMIT_NOMINAL, "12,6 V");
+    pid_tensoes_para_vbat(6.4f, 0.6f, &t);
+    VERIFICAR(t.motor_vlimit <= t.driver_vlimit * 0.5f * 0.6f + 1e-6f && t.voltage_power_supply == 6.4f, "6,4 V");
+
+    return teste_resultado("test_pid_tensao");
+}
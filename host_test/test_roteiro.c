@@ -0,0 +1,201 @@
+// host_test/test_roteiro.c
+// Sequenciador de pontos (main/ROTEIRO/roteiro.c) passo a passo, como na task_pid a 1 kHz:
+// validação, movimento de duração zero, modo velocidade, curvas, espera, voltas infinitas x
+// finitas e a cópia na NVS (em memória, nvs_host.c).
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "teste.h"
+#include "nvs.h"
+#include "nvs_host.h"
+#include "roteiro.h"
+
+#define DT          0.001f
+#define TOL_GRAUS   1e-3
+
+static float s_sp[2];       // Setpoint que a task_pid aplicaria
+
+static roteiro_ponto_t ponto(float pitch, float roll, uint16_t movimento, uint16_t espera_ms, uint8_t suavizacao,
+                             uint8_t flags) {
+    roteiro_ponto_t p = { (int16_t)lroundf(pitch * 100), (int16_t)lroundf(roll * 100), movimento, espera_ms,
+                          suavizacao, flags };
+    return p;
+}
+
+// Um ciclo da task_pid; false se o roteiro não está executando
+static bool passo(void) {
+    float p, r;
+    if (!roteiro_passo(DT, s_sp, &p, &r)) return false;
+    s_sp[0] = p;
+    s_sp[1] = r;
+    return true;
+}
+
+// Passos até o setpoint chegar ao alvo (ou o limite); devolve o tempo gasto (s)
+static float tempo_ate(float pitch, float roll, float limite_s) {
+    int n = 0;
+    while (n < limite_s / DT && passo()) {
+        n++;
+        if (fabsf(s_sp[0] - pitch) < TOL_GRAUS && fabsf(s_sp[1] - roll) < TOL_GRAUS) break;
+    }
+    return n * DT;
+}
+
+static void comecar(const roteiro_ponto_t *pontos, int n, uint16_t repeticoes, float pitch, float roll) {
+    s_sp[0] = pitch;
+    s_sp[1] = roll;
+    VERIFICAR(roteiro_carregar(pontos, n, repeticoes), "roteiro válido recusado");
+    VERIFICAR(roteiro_iniciar(), "roteiro não iniciou");
+}
+
+static void teste_validacao(void) {
+    roteiro_ponto_t ok = ponto(10, -10, 1000, 0, SUAVIZACAO_LINEAR, 0);
+    roteiro_ponto_t muitos[ROTEIRO_MAX_PONTOS + 1];
+    for (int i = 0; i <= ROTEIRO_MAX_PONTOS; i++) muitos[i] = ok;
+    VERIFICAR(roteiro_carregar(muitos, ROTEIRO_MAX_PONTOS, 0), "%d pontos deveriam caber", ROTEIRO_MAX_PONTOS);
+    VERIFICAR(!roteiro_carregar(muitos, ROTEIRO_MAX_PONTOS + 1, 0), "pontos demais aceitos");
+    VERIFICAR(!roteiro_carregar(muitos, 0, 0), "roteiro vazio aceito");
+
+    roteiro_ponto_t ruim = ponto(84.01f, 0, 1000, 0, SUAVIZACAO_LINEAR, 0);
+    VERIFICAR(!roteiro_carregar(&ruim, 1, 0), "pitch além de MAX_ANGLE aceito");
+    ruim = ponto(0, -84.01f, 1000, 0, SUAVIZACAO_LINEAR, 0);
+    VERIFICAR(!roteiro_carregar(&ruim, 1, 0), "roll além de MAX_ANGLE aceito");
+    ruim = ponto(0, 0, 1000, 0, SUAVIZACAO_NUM, 0);
+    VERIFICAR(!roteiro_carregar(&ruim, 1, 0), "suavização desconhecida aceita");
+    ruim = ponto(0, 0, 1000, 0, SUAVIZACAO_LINEAR, 0x02);
+    VERIFICAR(!roteiro_carregar(&ruim, 1, 0), "flag desconhecida aceita");
+
+    // Um roteiro recusado não substitui o carregado
+    roteiro_ponto_t dois[2] = { ponto(5, 5, 0, 0, SUAVIZACAO_LINEAR, 0), ponto(-5, -5, 0, 0, SUAVIZACAO_LINEAR, 0) };
+    comecar(dois, 2, 1, 0, 0);
+    VERIFICAR(!roteiro_carregar(&ruim, 1, 0), "flag desconhecida aceita");
+    VERIFICAR(passo() && s_sp[0] == 5.0f, "roteiro anterior deveria continuar (%.2f)", s_sp[0]);
+    roteiro_parar();
+    VERIFICAR(!passo(), "roteiro parado deveria parar de andar");
+}
+
+// Duração zero (por tempo ou velocidade zero): o primeiro passo já está no ponto
+static void teste_duracao_zero(void) {
+    roteiro_ponto_t pontos[2] = {
+        ponto(20, -10, 0, 0, SUAVIZACAO_MINIMO_JERK, 0),
+        ponto(-30, 15, 0, 0, SUAVIZACAO_COSSENO, ROTEIRO_FLAG_VELOCIDADE),
+    };
+    comecar(pontos, 2, 1, 0, 0);
+    VERIFICAR(passo(), "deveria executar");
+    VERIFICAR(s_sp[0] == 20.0f && s_sp[1] == -10.0f, "movimento de 0 ms em (%.3f, %.3f)", s_sp[0], s_sp[1]);
+    VERIFICAR(!isnan(s_sp[0]) && !isnan(s_sp[1]), "NaN no movimento de duração zero");
+    VERIFICAR(passo(), "deveria executar");
+    VERIFICAR(s_sp[0] == -30.0f && s_sp[1] == 15.0f, "velocidade 0 em (%.3f, %.3f)", s_sp[0], s_sp[1]);
+}
+
+// Velocidade em 0,1 grau/s pelo eixo que mais anda: de (0, 0) a (30, 10) a 10 grau/s leva 3 s
+static void teste_velocidade(void) {
+    roteiro_ponto_t p = ponto(30, 10, 100, 0, SUAVIZACAO_LINEAR, ROTEIRO_FLAG_VELOCIDADE);
+    comecar(&p, 1, 1, 0, 0);
+    for (int i = 0; i < 1500; i++) passo();
+    VERIFICAR_PERTO(s_sp[0], 15.0, 0.02);
+    VERIFICAR_PERTO(s_sp[1], 5.0, 0.02);
+    float t = 1.5f + tempo_ate(30, 10, 5.0f);
+    VERIFICAR_PERTO(t, 3.0, 0.005);
+}
+
+// Curvas: no meio todas passam por 50%; em 25% cada uma tem seu valor
+static void teste_curvas(void) {
+    static const float esperado_25[SUAVIZACAO_NUM] = { 0.25f, 0.15625f, 0.14645f, 0.103516f };
+    for (int tipo = 0; tipo < SUAVIZACAO_NUM; tipo++) {
+        roteiro_ponto_t p = ponto(40, 0, 1000, 0, (uint8_t)tipo, 0);
+        comecar(&p, 1, 1, 0, 0);
+        for (int i = 0; i < 250; i++) passo();
+        VERIFICAR(fabsf(s_sp[0] - 40.0f * esperado_25[tipo]) < 0.01f, "curva %d em 25%%: %.4f", tipo, s_sp[0]);
+        for (int i = 0; i < 250; i++) passo();
+        VERIFICAR(fabsf(s_sp[0] - 20.0f) < 0.01f, "curva %d em 50%%: %.4f", tipo, s_sp[0]);
+    }
+}
+
+// Espera no ponto antes de seguir para o próximo
+static void teste_espera(void) {
+    roteiro_ponto_t pontos[2] = {
+        ponto(10, 0, 200, 500, SUAVIZACAO_LINEAR, 0),
+        ponto(0, 0, 200, 0, SUAVIZACAO_LINEAR, 0),
+    };
+    comecar(pontos, 2, 1, 0, 0);
+    float chegada = tempo_ate(10, 0, 2.0f);
+    VERIFICAR_PERTO(chegada, 0.2, 0.002);
+
+    int parado = 0;
+    while (passo() && s_sp[0] == 10.0f) parado++;
+    VERIFICAR_PERTO(parado * DT, 0.5, 0.003);
+}
+
+// repeticoes = 0 repete para sempre; N termina parado no último ponto
+static void teste_voltas(void) {
+    roteiro_ponto_t pontos[3] = {
+        ponto(10, 0, 100, 0, SUAVIZACAO_LINEAR, 0),
+        ponto(20, 5, 100, 50, SUAVIZACAO_SUAVE, 0),
+        ponto(-10, -5, 100, 0, SUAVIZACAO_LINEAR, 0),
+    };
+    roteiro_progresso_t prog;
+
+    comecar(pontos, 3, 0, 0, 0);
+    for (int i = 0; i < 10000; i++) VERIFICAR(passo(), "roteiro infinito parou no passo %d", i);
+    VERIFICAR(roteiro_progresso_novo(&prog), "sem progresso");
+    VERIFICAR(prog.estado == ROTEIRO_EXECUTANDO && prog.volta >= 25, "infinito: estado %d, %u voltas",
+              prog.estado, prog.volta);
+    roteiro_parar();
+
+    comecar(pontos, 3, 2, 0, 0);
+    int n = 0;
+    while (passo() && n < 10000) n++;
+    VERIFICAR_PERTO(n * DT, 2 * (0.3 + 0.05), 0.01);
+    VERIFICAR(s_sp[0] == -10.0f && s_sp[1] == -5.0f, "terminou em (%.3f, %.3f), não no último ponto", s_sp[0],
+              s_sp[1]);
+    VERIFICAR(roteiro_progresso_novo(&prog), "sem progresso");
+    VERIFICAR(prog.estado == ROTEIRO_CONCLUIDO && prog.volta == 2 && prog.ponto == 2 && prog.n_pontos == 3,
+              "concluído: estado %d, volta %u, ponto %u", prog.estado, prog.volta, prog.ponto);
+    VERIFICAR(strcmp(roteiro_nome_estado(prog.estado), "concluido") == 0, "nome do estado");
+
+    // Concluído não anda mais nem mexe no setpoint
+    float antes[2] = { s_sp[0], s_sp[1] };
+    VERIFICAR(!passo(), "roteiro concluído ainda executa");
+    VERIFICAR(s_sp[0] == antes[0] && s_sp[1] == antes[1], "setpoint mudou depois de concluir");
+}
+
+// Cópia na NVS: volta no boot; blob inválido é ignorado
+static void teste_nvs(void) {
+    nvs_host_apagar();
+    roteiro_ponto_t a = ponto(12, 34, 0, 0, SUAVIZACAO_LINEAR, 0);
+    roteiro_ponto_t b = ponto(-12, -34, 0, 0, SUAVIZACAO_LINEAR, 0);
+    comecar(&a, 1, 1, 0, 0);
+
+    // b fica só na RAM (falha na gravação); o boot traz a de volta
+    nvs_host_falhar_escritas(1, ESP_FAIL);
+    VERIFICAR(roteiro_carregar(&b, 1, 1), "falha na NVS não deveria recusar o roteiro");
+    roteiro_iniciar_modulo();
+    VERIFICAR(roteiro_iniciar() && passo(), "roteiro da NVS não executou");
+    VERIFICAR(s_sp[0] == 12.0f && s_sp[1] == 34.0f, "roteiro da NVS em (%.2f, %.2f)", s_sp[0], s_sp[1]);
+
+    // Blob corrompido: mantém o que está na RAM
+    nvs_handle_t h;
+    uint8_t lixo[32];
+    memset(lixo, 0xA5, sizeof(lixo));
+    nvs_open("roteiro", NVS_READWRITE, &h);
+    nvs_set_blob(h, "pontos", lixo, sizeof(lixo));
+    nvs_close(h);
+    roteiro_iniciar_modulo();
+    VERIFICAR(roteiro_iniciar() && passo(), "roteiro não executou");
+    VERIFICAR(s_sp[0] == 12.0f, "blob inválido substituiu o roteiro (%.2f)", s_sp[0]);
+}
+
+int main(void) {
+    nvs_host_apagar();
+    teste_validacao();
+    teste_duracao_zero();
+    teste_velocidade();
+    teste_curvas();
+    teste_espera();
+    teste_voltas();
+    teste_nvs();
+    return teste_resultado("test_roteiro");
+}
@@ -0,0 +1,33 @@
+// host_test/teste.h
+// Verificações mínimas para os testes no PC (sem framework: cada teste é um executável do ctest).
+
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+#include <math.h>
+
+static int s_teste_falhas = 0;
+
+// Registra a falha e segue (mostra todas as falhas de uma vez)
+#define VERIFICAR(cond, ...) do {                                               \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "%s:%d: falhou: %s\n    ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__);                                       \
+            fprintf(stderr, "\n");                                              \
+            s_teste_falhas++;                                                   \
+        }                                                                       \
+    } while (0)
+
+#define VERIFICAR_PERTO(valor, esperado, tol) \
+    VERIFICAR(fabs((double)(valor) - (double)(esperado)) <= (tol), \
+              "%s = %g, esperado %g ± %g", #valor, (double)(valor), (double)(esperado), (double)(tol))
+
+// Código de saída do main()
+static inline int teste_resultado(const char *nome) {
+    if (s_teste_falhas) fprintf(stderr, "%s: %d falha(s)\n", nome, s_teste_falhas);
+    else printf("%s: ok\n", nome);
+    return s_teste_falhas ? 1 : 0;
+}
+
+#endif // TESTE_H
@@ -5,6 +5,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
@@ -12,6 +13,7 @@
 // --- Includes do Projeto ---
 #include "adc_bateria.h"
 #include "mqtt_esp32.h"
+#include "gerenciador_energia.h"
 
 // --- Tag de Log ---
 static const char *TAG = "BAT_MONITOR";
@@ -32,7 +34,9 @@ static const char *TAG = "BAT_MONITOR";
 // --- Configurações de Alerta ---
 #define PIN_LED_STATUS          32              // GPIO do LED de status da bateria
 #define BAT_LOW_THRESHOLD_V     6.4             // Tensão mínima para alerta
-#define UPDATE_INTERVAL_MS      5000            // Intervalo de leitura
+#define UPDATE_INTERVAL_MS      5000            // Intervalo de publicação MQTT / LED
+#define AMOSTRAGEM_INTERVAL_MS  100             // Intervalo de leitura (alimenta a compensação dos motores)
+#define SNAPSHOT_ALPHA          0.2f            // Peso da nova amostra na média exponencial
 
 // --- Variáveis Estáticas (Escopo do Arquivo) ---
 static adc_oneshot_unit_handle_t adc_handle = NULL;
@@ -40,6 +44,11 @@ static adc_cali_handle_t cali_handle = NULL;
 static bool calibration_valid = false;
 static bool led_state = true; 
 
+// Snapshot compartilhado (escrito só por task_leitura_bateria)
+static bateria_snapshot_t s_snapshot = { 0 };
+static bool s_snapshot_valido = false;
+static portMUX_TYPE s_snapshot_mux = portMUX_INITIALIZER_UNLOCKED;
+
 // --- Inicializa a calibração do ADC ---
 static bool init_adc_calibration(adc_unit_t unit, adc_channel_t channel, adc_atten_t atten, adc_cali_handle_t *out_handle){
     adc_cali_handle_t handle = NULL;
@@ -138,10 +147,40 @@ void setup_adc(void){
     gpio_set_level(PIN_LED_STATUS, 1);
 }
 
+// --- Atualiza o snapshot compartilhado com uma nova leitura ---
+static void atualizar_snapshot(double bat_voltage_v){
+    if (bat_voltage_v <= 0.5) return; // Ignora leituras espúrias de 0V
+
+    portENTER_CRITICAL(&s_snapshot_mux);
+    if (s_snapshot_valido) {
+        s_snapshot.tensao_v += SNAPSHOT_ALPHA * ((float)bat_voltage_v - s_snapshot.tensao_v);
+    } else {
+        s_snapshot.tensao_v = (float)bat_voltage_v;
+        s_snapshot_valido = true;
+    }
+    s_snapshot.timestamp_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_snapshot_mux);
+}
+
+// --- Copia o snapshot da bateria (não bloqueia) ---
+bool bateria_obter_snapshot(bateria_snapshot_t *saida){
+    if (!saida) return false;
+
+    portENTER_CRITICAL(&s_snapshot_mux);
+    bool valido = s_snapshot_valido;
+    *saida = s_snapshot;
+    portEXIT_CRITICAL(&s_snapshot_mux);
+
+    return valido;
+}
+
 // --- Task de Leitura e Monitoramento da Bateria ---
 void task_leitura_bateria(void *pvParameters){
     LOGI(TAG, "Iniciando monitoramento de bateria...");
 
+    const int leituras_por_publicacao = UPDATE_INTERVAL_MS / AMOSTRAGEM_INTERVAL_MS;
+    int contador_publicacao = 0;
+
     while (1) 
     {
         // 1. Leitura e Conversão
@@ -149,6 +188,20 @@ void task_leitura_bateria(void *pvParameters){
         
         // 2. Cálculo da tensão real
         double bat_voltage_v = ((double)pino_mv * VOLTAGE_DIVIDER_FACTOR) / 1000.0;
+        atualizar_snapshot(bat_voltage_v);
+
+        // Gerenciador de energia decide o modo pela tensão filtrada
+        bateria_snapshot_t bat;
+        if (bateria_obter_snapshot(&bat)) {
+            energia_atualizar_vbat(bat.tensao_v);
+        }
+
+        // Publicação e LED seguem no intervalo lento
+        if (++contador_publicacao < leituras_por_publicacao) {
+            vTaskDelay(pdMS_TO_TICKS(AMOSTRAGEM_INTERVAL_MS));
+            continue;
+        }
+        contador_publicacao = 0;
 
         // 3. Publicação MQTT
         mqtt_publish_battery_voltage(bat_voltage_v);
@@ -166,6 +219,6 @@ void task_leitura_bateria(void *pvParameters){
                 gpio_set_level(PIN_LED_STATUS, 1);
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(UPDATE_INTERVAL_MS));
+        vTaskDelay(pdMS_TO_TICKS(AMOSTRAGEM_INTERVAL_MS));
     }
 }
\ No newline at end of file
@@ -2,6 +2,17 @@
 #define ADC_BATERIA_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Última leitura filtrada da bateria, compartilhada com as outras tasks
+typedef struct {
+    float tensao_v;         // Tensão da bateria em Volts (média móvel exponencial)
+    int64_t timestamp_us;   // Instante da leitura (esp_timer_get_time)
+} bateria_snapshot_t;
 
 /**
  * @brief Inicializa o ADC e o GPIO do LED de status.
@@ -15,4 +26,15 @@ void setup_adc(void);
  */
 void task_leitura_bateria(void *pvParameters);
 
+/**
+ * @brief Copia a última leitura da bateria sem bloquear.
+ * Pode ser chamada de qualquer task (inclusive a de controle).
+ * @return false se ainda não existe leitura válida.
+ */
+bool bateria_obter_snapshot(bateria_snapshot_t *saida);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // ADC_BATERIA_H
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_timer.h"
-#include "mainGlobals.h"
+#include "setpoint.h"
 
 static const char *TAG = "BOTAO_ISR";
 
@@ -41,19 +41,18 @@ static void task_botao_event(void *pvParameters) {
                 
                 ESP_LOGI(TAG, "Clique valido detectado via ISR!");
 
-                // 3. Lógica do Setpoint (Segura com Mutex)
-                if (xSemaphoreTake(mutex_pr, pdMS_TO_TICKS(100)) == pdTRUE) {
-                    // Alterna entre 0 e 80
-                    if (pr[1] == 0.0f) {
-                        pr[1] = -80.0f;
-                    } else {
-                        pr[1] = 0.0f;
-                    }
-                    ESP_LOGI(TAG, "Novo Roll definido para: %.2f", pr[1]);
-                    xSemaphoreGive(mutex_pr);
-                } else {
-                    ESP_LOGW(TAG, "Nao conseguiu pegar o Mutex a tempo.");
-                }
+                // 3. Lógica do Setpoint (caixa de setpoint, sem bloquear)
+                setpoint_t sp;
+                uint32_t versao = 0;
+                setpoint_ler(&sp, &versao);
+
+                // Alterna entre 0 e 80
+                sp.roll = (sp.roll == 0.0f) ? -80.0f : 0.0f;
+                sp.velocidade = 0.0f;
+                sp.tempo_s = 0.0f;
+                sp.recebido_us = 0;
+                setpoint_publicar(&sp, false);
+                ESP_LOGI(TAG, "Novo Roll definido para: %.2f", sp.roll);
 
                 last_interrupt_time = interrupt_time;
             }
@@ -5,29 +5,30 @@
 
 static const char *TAG = "BUFFER_TELEMETRIA";
 
-// Buffer linear: capacidade * 2 (pitch, roll)
-static float *buffer = NULL;
+// Buffer linear de amostras (instante, pitch, roll)
+static telemetria_amostra_t *buffer = NULL;
 
 static size_t capacidade_buffer = 0;
 static size_t indice_escrita = 0;
 static size_t indice_leitura  = 0;
+static volatile uint32_t descartes = 0;         // Gravações recusadas por buffer cheio
 
 static SemaphoreHandle_t mutex_buffer = NULL;
 static SemaphoreHandle_t sem_preenchido = NULL; // Quantos dados existem
 static SemaphoreHandle_t sem_livre = NULL;      // Quantos espaços existem
 
-// Inicia o buffer de telemetria com a capacidade especificada (número de pares pitch/roll)
+// Inicia o buffer de telemetria com a capacidade especificada (número de amostras)
 bool buffer_telemetria_iniciar(size_t capacidade){
     if (capacidade == 0) return false;
     if (buffer != NULL) return true;            // Já iniciado
 
-    buffer = (float*)malloc(sizeof(float) * capacidade * 2);
+    buffer = (telemetria_amostra_t*)malloc(sizeof(telemetria_amostra_t) * capacidade);
     if (!buffer) {
         ESP_LOGI(TAG, "Falha no malloc do buffer");
         return false;
     }
 
-    memset(buffer, 0, sizeof(float) * capacidade * 2);
+    memset(buffer, 0, sizeof(telemetria_amostra_t) * capacidade);
 
     capacidade_buffer = capacidade;
     indice_escrita = 0;
@@ -47,12 +48,13 @@ bool buffer_telemetria_iniciar(size_t capacidade){
     return true;
 }
 
-// Grava um par (pitch, roll) no buffer. Retorna false se o buffer estiver cheio após o tempo de espera especificado
-bool buffer_telemetria_gravar(const float dado[2], TickType_t espera_ticks){
+// Grava uma amostra no buffer. Retorna false se o buffer estiver cheio após o tempo de espera especificado
+bool buffer_telemetria_gravar(const telemetria_amostra_t *dado, TickType_t espera_ticks){
     if (!buffer) return false;
 
     // Espera até existir espaço livre
     if (xSemaphoreTake(sem_livre, espera_ticks) != pdTRUE) {
+        descartes++;
         return false; // Buffer cheio
     }
 
@@ -62,9 +64,7 @@ bool buffer_telemetria_gravar(const float dado[2], TickType_t espera_ticks){
     }
 
     // Grava no índice atual
-    size_t pos = indice_escrita * 2;
-    buffer[pos]     = dado[0]; // pitch
-    buffer[pos + 1] = dado[1]; // roll
+    buffer[indice_escrita] = *dado;
 
     // Atualiza índice de escrita
     indice_escrita = (indice_escrita + 1) % capacidade_buffer;
@@ -77,8 +77,8 @@ bool buffer_telemetria_gravar(const float dado[2], TickType_t espera_ticks){
     return true;
 }
 
-// Lê um par (pitch, roll) do buffer. Retorna false se o buffer estiver vazio após o tempo de espera especificado
-bool buffer_telemetria_ler(float saida[2], TickType_t espera_ticks) {
+// Lê uma amostra do buffer. Retorna false se o buffer estiver vazio após o tempo de espera especificado
+bool buffer_telemetria_ler(telemetria_amostra_t *saida, TickType_t espera_ticks) {
     if (!buffer) return false;
 
     // Espera até existir dado salvo
@@ -93,9 +93,7 @@ bool buffer_telemetria_ler(float saida[2], TickType_t espera_ticks) {
     }
 
     // Lê do índice atual
-    size_t pos = indice_leitura * 2;
-    saida[0] = buffer[pos];
-    saida[1] = buffer[pos + 1];
+    *saida = buffer[indice_leitura];
 
     // Atualiza índice de leitura
     indice_leitura = (indice_leitura + 1) % capacidade_buffer;
@@ -108,6 +106,11 @@ bool buffer_telemetria_ler(float saida[2], TickType_t espera_ticks) {
     return true;
 }
 
+// Amostras descartadas por buffer cheio desde o boot (publicação não acompanha a taxa)
+uint32_t buffer_telemetria_descartes(void) {
+    return descartes;
+}
+
 // Finaliza o buffer de telemetria, liberando recursos
 void buffer_telemetria_finalizar(void){
     if (buffer) {
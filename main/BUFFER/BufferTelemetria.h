@@ -11,14 +11,24 @@
 extern "C" {
 #endif
 
+// Amostra de telemetria com o instante da medição (esp_timer, us desde o boot).
+typedef struct {
+    int64_t t_us;
+    float pitch;    // Graus
+    float roll;     // Graus
+} telemetria_amostra_t;
+
 // Inicializa o buffer circular de telemetria.
 bool buffer_telemetria_iniciar(size_t capacidade);
 
-// Insere no buffer um par [pitch, roll].
-bool buffer_telemetria_gravar(const float dado[2], TickType_t espera_ticks);
+// Insere uma amostra no buffer.
+bool buffer_telemetria_gravar(const telemetria_amostra_t *dado, TickType_t espera_ticks);
+
+// Retira uma amostra do buffer.
+bool buffer_telemetria_ler(telemetria_amostra_t *saida, TickType_t espera_ticks);
 
-// Retira um par [pitch, roll] do buffer.
-bool buffer_telemetria_ler(float saida[2], TickType_t espera_ticks);
+// Amostras descartadas por buffer cheio desde o boot.
+uint32_t buffer_telemetria_descartes(void);
 
 // Finaliza e libera memória.
 void buffer_telemetria_finalizar(void);
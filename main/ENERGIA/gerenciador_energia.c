@@ -0,0 +1,143 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "gerenciador_energia.h"
+#include "wifi_sta.h"
+#include "mqtt_esp32.h"
+
+// --- Tag de Log ---
+static const char *TAG = "ENERGIA";
+
+// --- Limiares de tensão (bateria 2S) ---
+#define LIMIAR_ECONOMIA_V       7.0f    // Abaixo: ENERGIA_ECONOMIA
+#define LIMIAR_RESERVA_V        6.7f    // Abaixo: ENERGIA_RESERVA
+#define LIMIAR_CRITICO_V        6.4f    // Abaixo: ENERGIA_CRITICO (mesmo alerta do LED)
+#define HISTERESE_V             0.15f   // Margem para voltar ao modo anterior
+#define LIMIAR_RECARGA_V        7.4f    // Só sai do crítico com a bateria recarregada
+
+// Perfis indexados por energia_modo_t (no crítico, fator_vlimit vale só durante o estacionamento)
+static const energia_perfil_t s_perfis[ENERGIA_NUM_MODOS] = {
+    [ENERGIA_NORMAL]   = { .fator_vlimit = 1.0f, .periodo_controle_ms = 1,  .divisor_telemetria = 50,  .wifi_economia = false, .motores_ativos = true  }, // 20Hz
+    [ENERGIA_ECONOMIA] = { .fator_vlimit = 0.8f, .periodo_controle_ms = 1,  .divisor_telemetria = 100, .wifi_economia = false, .motores_ativos = true  }, // 10Hz
+    [ENERGIA_RESERVA]  = { .fator_vlimit = 0.6f, .periodo_controle_ms = 2,  .divisor_telemetria = 100, .wifi_economia = true,  .motores_ativos = true  }, // 5Hz
+    [ENERGIA_CRITICO]  = { .fator_vlimit = 0.6f, .periodo_controle_ms = 10, .divisor_telemetria = 100, .wifi_economia = true,  .motores_ativos = false }, // 1Hz
+};
+
+static const char *s_nomes[ENERGIA_NUM_MODOS] = { "normal", "economia", "reserva", "critico" };
+
+// Escrito pela task da bateria e pelo handler MQTT (sob s_mutex); lido sem trava pelas tasks de controle
+static volatile energia_modo_t s_modo = ENERGIA_NORMAL;
+static volatile int s_modo_forcado = -1;   // -1 = automático
+static float s_ultima_vbat = 0.0f;
+static SemaphoreHandle_t s_mutex = NULL;
+
+// --- Escolhe o modo automático a partir da tensão, com histerese ---
+static energia_modo_t modo_por_tensao(energia_modo_t atual, float vbat) {
+    // O crítico fica travado: com os motores desligados a tensão sobe e o modo oscilaria
+    if (atual == ENERGIA_CRITICO) {
+        return (vbat >= LIMIAR_RECARGA_V) ? ENERGIA_NORMAL : ENERGIA_CRITICO;
+    }
+
+    static const float limiares[ENERGIA_NUM_MODOS] = {
+        [ENERGIA_NORMAL]   = 100.0f,
+        [ENERGIA_ECONOMIA] = LIMIAR_ECONOMIA_V,
+        [ENERGIA_RESERVA]  = LIMIAR_RESERVA_V,
+        [ENERGIA_CRITICO]  = LIMIAR_CRITICO_V,
+    };
+
+    // Desce para o modo mais econômico cujo limiar foi cruzado
+    energia_modo_t novo = ENERGIA_NORMAL;
+    for (int m = ENERGIA_ECONOMIA; m < ENERGIA_NUM_MODOS; m++) {
+        if (vbat <= limiares[m]) novo = (energia_modo_t)m;
+    }
+
+    // Só volta para um modo menos econômico com a margem de histerese
+    if (novo < atual && vbat <= limiares[atual] + HISTERESE_V) {
+        novo = atual;
+    }
+    return novo;
+}
+
+// --- Troca o modo e aplica os efeitos que não dependem das tasks de controle (com s_mutex) ---
+static bool aplicar_modo(energia_modo_t modo, energia_modo_t *anterior) {
+    *anterior = s_modo;
+    if (modo == *anterior) return false;
+
+    s_modo = modo;
+    const energia_perfil_t *perfil = &s_perfis[modo];
+    if (perfil->wifi_economia != s_perfis[*anterior].wifi_economia) {
+        wifi_definir_economia(perfil->wifi_economia);
+    }
+    return true;
+}
+
+// --- Log e MQTT fora do mutex: o handler MQTT também o toma, e publicar espera o cliente ---
+static void anunciar_modo(energia_modo_t anterior, energia_modo_t modo, bool forcado, float vbat) {
+    LOGW(TAG, "Modo de energia: %s -> %s (%.2f V)", s_nomes[anterior], s_nomes[modo], vbat);
+    mqtt_publish_power_mode(s_nomes[modo], forcado, vbat);
+}
+
+void energia_iniciar(void) {
+    if (!s_mutex) s_mutex = xSemaphoreCreateMutex();
+}
+
+void energia_atualizar_vbat(float vbat) {
+    if (!s_mutex) return;
+
+    energia_modo_t anterior, modo;
+    bool mudou = false;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_ultima_vbat = vbat;
+    if (s_modo_forcado < 0) {
+        modo = modo_por_tensao(s_modo, vbat);
+        mudou = aplicar_modo(modo, &anterior);
+    }
+    xSemaphoreGive(s_mutex);
+
+    if (mudou) anunciar_modo(anterior, modo, false, vbat);
+}
+
+void energia_forcar_modo(int modo) {
+    if (modo >= ENERGIA_NUM_MODOS || !s_mutex) return;
+
+    energia_modo_t anterior, novo;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_modo_forcado = modo;
+    if (modo >= 0) {
+        novo = (energia_modo_t)modo;
+    } else {
+        // Reavalia do zero: um crítico forçado não deve ficar travado
+        novo = s_ultima_vbat > 0.0f ? modo_por_tensao(ENERGIA_NORMAL, s_ultima_vbat) : ENERGIA_NORMAL;
+    }
+    bool mudou = aplicar_modo(novo, &anterior);
+    float vbat = s_ultima_vbat;
+    xSemaphoreGive(s_mutex);
+
+    if (modo < 0) LOGI(TAG, "Modo de energia automático");
+    if (mudou) anunciar_modo(anterior, novo, modo >= 0, vbat);
+}
+
+energia_modo_t energia_obter_modo(void) {
+    return s_modo;
+}
+
+const energia_perfil_t *energia_obter_perfil(void) {
+    return &s_perfis[s_modo];
+}
+
+const char *energia_nome_modo(energia_modo_t modo) {
+    return (modo < ENERGIA_NUM_MODOS) ? s_nomes[modo] : "?";
+}
+
+int energia_modo_por_nome(const char *nome) {
+    if (!nome) return -2;
+    if (strcmp(nome, "auto") == 0) return -1;
+    for (int m = 0; m < ENERGIA_NUM_MODOS; m++) {
+        if (strcmp(nome, s_nomes[m]) == 0) return m;
+    }
+    return -2;
+}
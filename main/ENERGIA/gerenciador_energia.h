@@ -0,0 +1,70 @@
+#ifndef GERENCIADOR_ENERGIA_H
+#define GERENCIADOR_ENERGIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Modos de energia, do mais ao menos econômico em relação à bateria
+typedef enum {
+    ENERGIA_NORMAL = 0,     // Operação completa
+    ENERGIA_ECONOMIA,       // Reduz a tensão nos motores e a telemetria
+    ENERGIA_RESERVA,        // Reduz a taxa de controle e ativa o modem sleep do Wi-Fi
+    ENERGIA_CRITICO,        // Estaciona o gimbal e desliga os drivers
+    ENERGIA_NUM_MODOS
+} energia_modo_t;
+
+// Parâmetros aplicados pelas tasks em cada modo
+typedef struct {
+    float fator_vlimit;             // Fração do Uq nominal liberada para os motores
+    uint8_t periodo_controle_ms;    // Período de task_mpu / task_pid
+    uint16_t divisor_telemetria;    // Ciclos de task_mpu entre envios de telemetria
+    bool wifi_economia;             // Modem sleep máximo do Wi-Fi
+    bool motores_ativos;            // false = estaciona e desliga os drivers
+} energia_perfil_t;
+
+/**
+ * @brief Cria o mutex dos modos (app_main, antes das tasks).
+ */
+void energia_iniciar(void);
+
+/**
+ * @brief Avalia a tensão da bateria e troca de modo se necessário.
+ * Chamada pela task da bateria a cada nova leitura.
+ */
+void energia_atualizar_vbat(float vbat);
+
+/**
+ * @brief Força um modo (recebido via MQTT). Use -1 para voltar ao automático.
+ */
+void energia_forcar_modo(int modo);
+
+/**
+ * @brief Modo atual (leitura não bloqueante).
+ */
+energia_modo_t energia_obter_modo(void);
+
+/**
+ * @brief Perfil do modo atual (leitura não bloqueante).
+ */
+const energia_perfil_t *energia_obter_perfil(void);
+
+/**
+ * @brief Nome do modo, usado no MQTT.
+ */
+const char *energia_nome_modo(energia_modo_t modo);
+
+/**
+ * @brief Converte o nome recebido via MQTT.
+ * @return Modo, -1 para "auto" ou -2 se o nome for desconhecido.
+ */
+int energia_modo_por_nome(const char *nome);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GERENCIADOR_ENERGIA_H
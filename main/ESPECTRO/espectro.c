@@ -0,0 +1,231 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "espectro.h"
+#include "filtros.h"
+#include "mqtt_esp32.h"
+
+// --- Tag de Log ---
+static const char *TAG = "ESPECTRO";
+
+#define ANEL_TAMANHO            (2 * ESPECTRO_N)   // Folga para a task_mpu seguir escrevendo durante a cópia
+#define ANEL_MASCARA            (ANEL_TAMANHO - 1)
+#define BINS                    (ESPECTRO_N / 2)
+#define BINS_POR_BANDA          (BINS / ESPECTRO_BANDAS)
+
+#define PERIODO_CONSULTA_MS     50
+#define PERIODO_PUBLICACAO_US   1000000
+#define F_MIN_PICO_HZ           20.0f   // Abaixo disso é movimento do gimbal, não ressonância
+#define LIMIAR_PICO             8.0f    // Potência mínima do pico sobre a média (~9 dB)
+#define LACUNA_MAX              3       // Intervalo entre amostras acima de 3x a média descarta a janela
+#define RAD_PARA_GRAUS          (180.0f / (float)M_PI)
+
+// Anel preenchido pela task_mpu (um produtor, um consumidor)
+static float s_anel_pitch[ANEL_TAMANHO];
+static float s_anel_roll[ANEL_TAMANHO];
+static uint32_t s_anel_t_us[ANEL_TAMANHO];
+static atomic_uint s_escrita;
+
+// Tabelas e buffers da FFT (usados só pela task_espectro)
+static float s_hann[ESPECTRO_N];
+static float s_cos[BINS], s_sin[BINS];
+static float s_re[ESPECTRO_N], s_im[ESPECTRO_N];
+static float s_pot[2][BINS + 1];     // Amplitude² média (°/s)² por bin, [pitch, roll]
+
+void espectro_amostrar(float taxa_pitch, float taxa_roll, int64_t t_us) {
+    unsigned int i = atomic_load_explicit(&s_escrita, memory_order_relaxed);
+    s_anel_pitch[i & ANEL_MASCARA] = taxa_pitch;
+    s_anel_roll[i & ANEL_MASCARA]  = taxa_roll;
+    s_anel_t_us[i & ANEL_MASCARA]  = (uint32_t)t_us;
+    atomic_store_explicit(&s_escrita, i + 1, memory_order_release);
+}
+
+static void preparar_tabelas(void) {
+    for (int i = 0; i < ESPECTRO_N; i++) {
+        s_hann[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / ESPECTRO_N);
+    }
+    for (int k = 0; k < BINS; k++) {
+        s_cos[k] = cosf(2.0f * (float)M_PI * k / ESPECTRO_N);
+        s_sin[k] = sinf(2.0f * (float)M_PI * k / ESPECTRO_N);
+    }
+}
+
+// --- FFT complexa radix-2 in-place (s_re, s_im) ---
+static void fft(void) {
+    for (int i = 1, j = 0; i < ESPECTRO_N; i++) {
+        int bit = ESPECTRO_N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            float t = s_re[i]; s_re[i] = s_re[j]; s_re[j] = t;
+            t = s_im[i]; s_im[i] = s_im[j]; s_im[j] = t;
+        }
+    }
+    for (int tam = 2; tam <= ESPECTRO_N; tam <<= 1) {
+        int passo = ESPECTRO_N / tam;
+        for (int ini = 0; ini < ESPECTRO_N; ini += tam) {
+            for (int k = 0; k < tam / 2; k++) {
+                float wr = s_cos[k * passo], wi = -s_sin[k * passo];
+                int a = ini + k, b = a + tam / 2;
+                float tr = s_re[b] * wr - s_im[b] * wi;
+                float ti = s_re[b] * wi + s_im[b] * wr;
+                s_re[b] = s_re[a] - tr; s_im[b] = s_im[a] - ti;
+                s_re[a] += tr;          s_im[a] += ti;
+            }
+        }
+    }
+}
+
+// Copia as últimas ESPECTRO_N amostras; false se foram sobrescritas ou há lacunas (pausas da task_mpu)
+static bool copiar_janela(unsigned int fim, float *fs_hz) {
+    unsigned int ini = fim - ESPECTRO_N;
+    for (int i = 0; i < ESPECTRO_N; i++) {
+        unsigned int j = (ini + i) & ANEL_MASCARA;
+        // Pitch na parte real, roll na imaginária: uma FFT para os dois eixos
+        s_re[i] = s_anel_pitch[j] * RAD_PARA_GRAUS;
+        s_im[i] = s_anel_roll[j] * RAD_PARA_GRAUS;
+    }
+    uint32_t total_us = s_anel_t_us[(fim - 1) & ANEL_MASCARA] - s_anel_t_us[ini & ANEL_MASCARA];
+    if (total_us == 0) return false;
+    uint32_t lacuna_max_us = LACUNA_MAX * total_us / (ESPECTRO_N - 1);
+    for (int i = 1; i < ESPECTRO_N; i++) {
+        if (s_anel_t_us[(ini + i) & ANEL_MASCARA] - s_anel_t_us[(ini + i - 1) & ANEL_MASCARA] > lacuna_max_us) return false;
+    }
+    if (atomic_load_explicit(&s_escrita, memory_order_acquire) - ini > ANEL_TAMANHO) return false;
+    *fs_hz = (ESPECTRO_N - 1) * 1e6f / total_us;
+    return true;
+}
+
+// Janela de Hann (sem a média) e acumula a amplitude² de cada eixo
+static void acumular_janela(void) {
+    float media_re = 0.0f, media_im = 0.0f;
+    for (int i = 0; i < ESPECTRO_N; i++) {
+        media_re += s_re[i];
+        media_im += s_im[i];
+    }
+    media_re /= ESPECTRO_N;
+    media_im /= ESPECTRO_N;
+    for (int i = 0; i < ESPECTRO_N; i++) {
+        s_re[i] = (s_re[i] - media_re) * s_hann[i];
+        s_im[i] = (s_im[i] - media_im) * s_hann[i];
+    }
+
+    fft();
+
+    // Separa os dois sinais reais: X[k] = (Z[k] + Z*[N-k]) / 2, Y[k] = (Z[k] - Z*[N-k]) / 2j
+    // Amplitude de um seno = 2|X| / soma(janela) = 4|X| / N
+    const float escala = (2.0f / ESPECTRO_N) * (2.0f / ESPECTRO_N);
+    for (int k = 0; k <= BINS; k++) {
+        int n = (ESPECTRO_N - k) & (ESPECTRO_N - 1);
+        float soma_r = s_re[k] + s_re[n], dif_r = s_re[k] - s_re[n];
+        float soma_i = s_im[k] + s_im[n], dif_i = s_im[k] - s_im[n];
+        s_pot[0][k] += (soma_r * soma_r + dif_i * dif_i) * escala;
+        s_pot[1][k] += (soma_i * soma_i + dif_r * dif_r) * escala;
+    }
+}
+
+static float para_db(float potencia) {
+    return 10.0f * log10f(potencia + 1e-12f);
+}
+
+// Bandas resumidas e picos de um eixo (s_pot já dividido pelo número de janelas)
+static void analisar_eixo(const float *pot, float fs_hz, espectro_eixo_t *saida) {
+    for (int b = 0; b < ESPECTRO_BANDAS; b++) {
+        float max = 0.0f;
+        for (int k = 1 + b * BINS_POR_BANDA; k <= (b + 1) * BINS_POR_BANDA; k++) {
+            if (pot[k] > max) max = pot[k];
+        }
+        float db = roundf(para_db(max));
+        saida->db[b] = (int8_t)(db < -128.0f ? -128.0f : (db > 127.0f ? 127.0f : db));
+    }
+
+    int k_min = (int)ceilf(F_MIN_PICO_HZ * ESPECTRO_N / fs_hz);
+    if (k_min < 2) k_min = 2;
+    float media = 0.0f;
+    for (int k = k_min; k <= BINS; k++) media += pot[k];
+    media /= (BINS - k_min + 1);
+
+    // Máximos locais acima do limiar, mantidos em ordem decrescente de potência
+    int bins[ESPECTRO_MAX_PICOS];
+    saida->n_picos = 0;
+    for (int k = k_min; k < BINS; k++) {
+        if (pot[k] <= pot[k - 1] || pot[k] < pot[k + 1] || pot[k] < LIMIAR_PICO * media) continue;
+        int pos = saida->n_picos;
+        while (pos > 0 && pot[bins[pos - 1]] < pot[k]) pos--;
+        if (pos >= ESPECTRO_MAX_PICOS) continue;
+        int ultimo = saida->n_picos < ESPECTRO_MAX_PICOS ? saida->n_picos : ESPECTRO_MAX_PICOS - 1;
+        for (int i = ultimo; i > pos; i--) bins[i] = bins[i - 1];
+        bins[pos] = k;
+        if (saida->n_picos < ESPECTRO_MAX_PICOS) saida->n_picos++;
+    }
+
+    // Interpolação parabólica em dB para refinar a frequência entre bins
+    for (int i = 0; i < saida->n_picos; i++) {
+        int k = bins[i];
+        float l = para_db(pot[k - 1]), c = para_db(pot[k]), r = para_db(pot[k + 1]);
+        float den = l - 2.0f * c + r;
+        float delta = (den != 0.0f) ? 0.5f * (l - r) / den : 0.0f;
+        saida->picos[i].f_hz = (k + delta) * fs_hz / ESPECTRO_N;
+        saida->picos[i].db = c - 0.25f * (l - r) * delta;
+    }
+}
+
+void task_espectro(void *pvParameters) {
+    static espectro_resultado_t resultado;
+    preparar_tabelas();
+
+    unsigned int ultima = atomic_load(&s_escrita);
+    int janelas = 0;
+    float soma_fs = 0.0f;
+    int64_t inicio_us = esp_timer_get_time();
+
+    LOGI(TAG, "Analisador iniciado (%d pontos)", ESPECTRO_N);
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(PERIODO_CONSULTA_MS));
+
+        // Janelas sem sobreposição: espera ESPECTRO_N amostras novas
+        unsigned int fim = atomic_load_explicit(&s_escrita, memory_order_acquire);
+        if (fim - ultima >= ESPECTRO_N) {
+            float fs_hz;
+            if (copiar_janela(fim, &fs_hz)) {
+                acumular_janela();
+                soma_fs += fs_hz;
+                janelas++;
+            }
+            ultima = fim;
+        }
+
+        if (esp_timer_get_time() - inicio_us < PERIODO_PUBLICACAO_US) continue;
+        inicio_us = esp_timer_get_time();
+        if (janelas == 0) continue;
+
+        resultado.fs_hz = soma_fs / janelas;
+        resultado.janelas = (uint8_t)janelas;
+        for (int e = 0; e < 2; e++) {
+            for (int k = 0; k <= BINS; k++) s_pot[e][k] /= janelas;
+            analisar_eixo(s_pot[e], resultado.fs_hz, &resultado.eixo[e]);
+        }
+        memset(s_pot, 0, sizeof(s_pot));
+        janelas = 0;
+        soma_fs = 0.0f;
+
+        // Notches dinâmicos seguem o pico mais forte entre os eixos (0 = nenhum)
+        const espectro_pico_t *pico = NULL;
+        for (int e = 0; e < 2; e++) {
+            const espectro_eixo_t *eixo = &resultado.eixo[e];
+            if (eixo->n_picos && (!pico || eixo->picos[0].db > pico->db)) pico = &eixo->picos[0];
+        }
+        filtros_definir_pico(pico ? pico->f_hz : 0.0f);
+
+        mqtt_publish_espectro(&resultado);
+    }
+    vTaskDelete(NULL);
+}
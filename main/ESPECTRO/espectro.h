@@ -0,0 +1,51 @@
+#ifndef ESPECTRO_H
+#define ESPECTRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESPECTRO_N              256     // Pontos da FFT (potência de 2)
+#define ESPECTRO_BANDAS         32      // Bandas do espectro resumido publicado
+#define ESPECTRO_MAX_PICOS      3
+
+// Pico de ressonância (frequência interpolada e amplitude em dB re 1 °/s)
+typedef struct {
+    float f_hz;
+    float db;
+} espectro_pico_t;
+
+// Resultado de um eixo do giroscópio
+typedef struct {
+    espectro_pico_t picos[ESPECTRO_MAX_PICOS];  // Do mais forte ao mais fraco
+    uint8_t n_picos;
+    int8_t db[ESPECTRO_BANDAS];                 // Máximo de cada banda (dB re 1 °/s), de 0 a fs/2
+} espectro_eixo_t;
+
+// Publicado ~1 Hz em gimbal/espectro
+typedef struct {
+    float fs_hz;            // Taxa medida pelos instantes das amostras
+    uint8_t janelas;        // Janelas de ESPECTRO_N amostras na média
+    espectro_eixo_t eixo[2];    // [pitch, roll]
+} espectro_resultado_t;
+
+/**
+ * @brief Copia uma amostra das taxas do giroscópio (rad/s, antes dos filtros) para o anel.
+ * Chamada pela task_mpu a cada leitura; não bloqueia.
+ */
+void espectro_amostrar(float taxa_pitch, float taxa_roll, int64_t t_us);
+
+/**
+ * @brief Task de análise (núcleo 0, baixa prioridade).
+ * Calcula a FFT das janelas do anel, publica o resultado e atualiza o pico dos notches dinâmicos.
+ */
+void task_espectro(void *pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESPECTRO_H
@@ -0,0 +1,128 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "filtros.h"
+
+// --- Tag de Log ---
+static const char *TAG = "FILTROS";
+
+#define Q_PASSA_BAIXA       0.7071f
+#define Q_NOTCH_PADRAO      4.0f
+#define FC_MAX_FRACAO_FS    0.45f   // Acima disso (perto de Nyquist) o estágio vira identidade
+#define PICO_HISTERESE_HZ   1.0f    // Variação mínima do pico para recalcular os notches
+
+// Configuração de um estágio
+typedef struct {
+    filtro_tipo_t tipo;
+    float fc_hz;
+    float q;
+} estagio_cfg_t;
+
+// Escrito pelo MQTT / FFT, copiado pelas tasks de controle em cadeia_sincronizar
+static estagio_cfg_t s_cfg[FILTRO_NUM_ALVOS][FILTRO_MAX_ESTAGIOS];
+static volatile uint32_t s_versao = 1;
+static float s_pico_hz = 0.0f;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *s_nomes_alvo[FILTRO_NUM_ALVOS] = { "giro", "saida" };
+static const char *s_nomes_tipo[FILTRO_NUM_TIPOS] = { "desligado", "passa_baixa", "notch", "notch_dinamico" };
+
+// --- Coeficientes (RBJ Audio EQ Cookbook), preservando o estado z1/z2 ---
+static void biquad_identidade(biquad_t *f) {
+    f->b0 = 1.0f;
+    f->b1 = f->b2 = f->a1 = f->a2 = 0.0f;
+}
+
+static void biquad_calcular(biquad_t *f, filtro_tipo_t tipo, float fc_hz, float q, float fs_hz) {
+    if (tipo == FILTRO_DESLIGADO || fc_hz <= 0.0f || q <= 0.0f || fc_hz >= FC_MAX_FRACAO_FS * fs_hz) {
+        biquad_identidade(f);
+        return;
+    }
+
+    float w0 = 2.0f * (float)M_PI * fc_hz / fs_hz;
+    float cosw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    if (tipo == FILTRO_PASSA_BAIXA) {
+        f->b0 = (1.0f - cosw) * 0.5f / a0;
+        f->b1 = (1.0f - cosw) / a0;
+        f->b2 = f->b0;
+    } else {
+        f->b0 = 1.0f / a0;
+        f->b1 = -2.0f * cosw / a0;
+        f->b2 = f->b0;
+    }
+    f->a1 = -2.0f * cosw / a0;
+    f->a2 = (1.0f - alpha) / a0;
+}
+
+bool filtros_definir_estagio(filtro_alvo_t alvo, int estagio, filtro_tipo_t tipo, float fc_hz, float q) {
+    if (alvo >= FILTRO_NUM_ALVOS || estagio < 0 || estagio >= FILTRO_MAX_ESTAGIOS || tipo >= FILTRO_NUM_TIPOS) return false;
+    if (tipo == FILTRO_PASSA_BAIXA) q = Q_PASSA_BAIXA;
+    else if (q <= 0.0f) q = Q_NOTCH_PADRAO;
+
+    portENTER_CRITICAL(&s_mux);
+    s_cfg[alvo][estagio] = (estagio_cfg_t){ .tipo = tipo, .fc_hz = fc_hz, .q = q };
+    s_versao++;
+    portEXIT_CRITICAL(&s_mux);
+
+    LOGI(TAG, "%s[%d]: %s %.1f Hz (Q %.2f)", s_nomes_alvo[alvo], estagio, s_nomes_tipo[tipo], fc_hz, q);
+    return true;
+}
+
+void filtros_definir_pico(float f_hz) {
+    if (fabsf(f_hz - s_pico_hz) < PICO_HISTERESE_HZ) return;
+
+    portENTER_CRITICAL(&s_mux);
+    s_pico_hz = f_hz;
+    s_versao++;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void cadeia_iniciar(cadeia_filtros_t *c) {
+    memset(c, 0, sizeof(*c));
+}
+
+void cadeia_sincronizar(cadeia_filtros_t *c, filtro_alvo_t alvo, float fs_hz) {
+    if (c->versao == s_versao && c->fs_hz == fs_hz) return;
+
+    estagio_cfg_t cfg[FILTRO_MAX_ESTAGIOS];
+    float pico;
+    portENTER_CRITICAL(&s_mux);
+    memcpy(cfg, s_cfg[alvo], sizeof(cfg));
+    pico = s_pico_hz;
+    c->versao = s_versao;
+    portEXIT_CRITICAL(&s_mux);
+
+    c->fs_hz = fs_hz;
+    c->n = 0;
+    for (int i = 0; i < FILTRO_MAX_ESTAGIOS; i++) {
+        float fc = cfg[i].fc_hz;
+        filtro_tipo_t tipo = cfg[i].tipo;
+        if (tipo == FILTRO_NOTCH_DINAMICO) {
+            fc = pico;
+            tipo = FILTRO_NOTCH;
+        }
+        biquad_calcular(&c->estagio[i], tipo, fc, cfg[i].q, fs_hz);
+        if (cfg[i].tipo != FILTRO_DESLIGADO) c->n = i + 1;
+    }
+}
+
+int filtros_alvo_por_nome(const char *nome) {
+    for (int i = 0; i < FILTRO_NUM_ALVOS; i++) {
+        if (strcmp(nome, s_nomes_alvo[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int filtros_tipo_por_nome(const char *nome) {
+    for (int i = 0; i < FILTRO_NUM_TIPOS; i++) {
+        if (strcmp(nome, s_nomes_tipo[i]) == 0) return i;
+    }
+    return -1;
+}
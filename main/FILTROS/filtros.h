@@ -0,0 +1,88 @@
+#ifndef FILTROS_H
+#define FILTROS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FILTRO_MAX_ESTAGIOS     3
+
+// Tipo de cada estágio da cadeia
+typedef enum {
+    FILTRO_DESLIGADO = 0,
+    FILTRO_PASSA_BAIXA,     // Butterworth com Q = 0.707
+    FILTRO_NOTCH,           // Frequência fixa
+    FILTRO_NOTCH_DINAMICO,  // Segue o pico informado por filtros_definir_pico
+    FILTRO_NUM_TIPOS
+} filtro_tipo_t;
+
+// Sinais filtrados
+typedef enum {
+    FILTRO_GIRO = 0,        // Taxas do giroscópio em task_mpu
+    FILTRO_SAIDA,           // Saída do PID em task_pid
+    FILTRO_NUM_ALVOS
+} filtro_alvo_t;
+
+// Biquad em forma direta II transposta (2 estados)
+typedef struct {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} biquad_t;
+
+// Cadeia usada por uma task; os coeficientes só são recalculados em cadeia_sincronizar
+typedef struct {
+    biquad_t estagio[FILTRO_MAX_ESTAGIOS];
+    uint8_t n;              // Estágios aplicados (os desligados no meio são identidade)
+    float fs_hz;
+    uint32_t versao;
+} cadeia_filtros_t;
+
+static inline float biquad_aplicar(biquad_t *f, float x) {
+    float y = f->b0 * x + f->z1;
+    f->z1 = f->b1 * x - f->a1 * y + f->z2;
+    f->z2 = f->b2 * x - f->a2 * y;
+    return y;
+}
+
+static inline float cadeia_aplicar(cadeia_filtros_t *c, float x) {
+    for (int i = 0; i < c->n; i++) x = biquad_aplicar(&c->estagio[i], x);
+    return x;
+}
+
+/**
+ * @brief Configura um estágio (recebido via MQTT). As tasks aplicam na próxima sincronização.
+ * @return false se o alvo, o estágio ou os parâmetros forem inválidos.
+ */
+bool filtros_definir_estagio(filtro_alvo_t alvo, int estagio, filtro_tipo_t tipo, float fc_hz, float q);
+
+/**
+ * @brief Frequência de ressonância atual para os notches dinâmicos (0 = nenhuma).
+ */
+void filtros_definir_pico(float f_hz);
+
+/**
+ * @brief Zera a cadeia (nenhum estágio) para a próxima sincronização.
+ */
+void cadeia_iniciar(cadeia_filtros_t *c);
+
+/**
+ * @brief Recalcula os coeficientes se a configuração ou a taxa de amostragem mudaram.
+ * Chamada pela task dona da cadeia a cada ciclo (só compara quando nada mudou).
+ */
+void cadeia_sincronizar(cadeia_filtros_t *c, filtro_alvo_t alvo, float fs_hz);
+
+/**
+ * @brief Converte nomes ("giro", "saida" / "desligado", "passa_baixa", "notch", "notch_dinamico").
+ * @return -1 se desconhecido.
+ */
+int filtros_alvo_por_nome(const char *nome);
+int filtros_tipo_por_nome(const char *nome);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILTROS_H
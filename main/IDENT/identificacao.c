@@ -0,0 +1,216 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "identificacao.h"
+#include "gerenciador_energia.h"
+#include "mqtt_esp32.h"
+
+// --- Tag de Log ---
+static const char *TAG = "IDENT";
+
+#define IDENT_MAX_AMOSTRAS      6000    // 6 s a 1 kHz (36 KB, alocados só durante a identificação)
+#define IDENT_DURACAO_MIN_S     0.5f
+#define IDENT_AMPLITUDE_MAX     10.0f
+#define IDENT_BLOCO             200     // Amostras por mensagem MQTT
+#define IDENT_PAUSA_BLOCO_MS    20      // Dá tempo ao cliente MQTT de esvaziar a fila
+#define PRBS_BITS_POR_F1        2.5f    // Taxa de bits da PRBS em relação a f1 (-3 dB perto de f1)
+
+typedef enum {
+    IDENT_LIVRE = 0,
+    IDENT_GRAVANDO,
+    IDENT_TRANSMITINDO,
+    IDENT_CANCELADO
+} ident_estado_t;
+
+static const char *s_nomes_eixo[IDENT_NUM_EIXOS] = { "pitch", "roll" };
+static const char *s_nomes_sinal[IDENT_NUM_SINAIS] = { "chirp", "prbs" };
+
+// Pedido e buffer (escritos pelo MQTT antes de armar, depois só pela task_pid até terminar)
+static ident_config_t s_cfg;
+static ident_amostra_t *s_buf = NULL;
+static uint32_t s_total = 0;
+static uint32_t s_n = 0;
+static float s_fs_hz = 0.0f;
+static volatile ident_estado_t s_estado = IDENT_LIVRE;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+
+// Estado da PRBS (LFSR de 10 bits, x^10 + x^7 + 1)
+static uint16_t s_lfsr;
+static uint16_t s_prbs_manter, s_prbs_contador;
+static float s_prbs_valor;
+
+// Última leitura do giroscópio (task_mpu)
+static volatile int16_t s_giro[IDENT_NUM_EIXOS];
+
+static int16_t saturar_int16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lroundf(v);
+}
+
+bool identificacao_solicitar(const ident_config_t *cfg) {
+    if (s_estado != IDENT_LIVRE) {
+        LOGW(TAG, "Identificação já em andamento.");
+        return false;
+    }
+    if (cfg->eixo >= IDENT_NUM_EIXOS || cfg->sinal >= IDENT_NUM_SINAIS
+        || cfg->amplitude <= 0.0f || cfg->amplitude > IDENT_AMPLITUDE_MAX
+        || cfg->f0_hz <= 0.0f || cfg->f1_hz <= cfg->f0_hz || cfg->duracao_s < IDENT_DURACAO_MIN_S) {
+        LOGW(TAG, "Pedido de identificação inválido.");
+        return false;
+    }
+
+    const energia_perfil_t *perfil = energia_obter_perfil();
+    if (!perfil->motores_ativos) {
+        LOGW(TAG, "Motores desligados pelo modo de energia, identificação recusada.");
+        return false;
+    }
+
+    float fs_hz = 1000.0f / perfil->periodo_controle_ms;
+    uint32_t total = (uint32_t)(cfg->duracao_s * fs_hz);
+    if (total > IDENT_MAX_AMOSTRAS) {
+        total = IDENT_MAX_AMOSTRAS;
+        LOGW(TAG, "Duração limitada a %.1f s.", total / fs_hz);
+    }
+
+    ident_amostra_t *buf = (ident_amostra_t *)malloc(sizeof(ident_amostra_t) * total);
+    if (!buf) {
+        LOGE(TAG, "Sem memória para %lu amostras.", (unsigned long)total);
+        return false;
+    }
+
+    portENTER_CRITICAL(&s_mux);
+    s_cfg = *cfg;
+    s_buf = buf;
+    s_total = total;
+    s_n = 0;
+    s_fs_hz = fs_hz;
+    s_lfsr = 0x3FF;
+    s_prbs_manter = (uint16_t)fmaxf(1.0f, roundf(fs_hz / (PRBS_BITS_POR_F1 * cfg->f1_hz)));
+    s_prbs_contador = 0;
+    s_prbs_valor = 1.0f;
+    s_estado = IDENT_GRAVANDO;
+    portEXIT_CRITICAL(&s_mux);
+
+    LOGI(TAG, "Identificação %s em %s: %.2f, %.1f-%.1f Hz, %lu amostras a %.0f Hz",
+         s_nomes_sinal[cfg->sinal], s_nomes_eixo[cfg->eixo], cfg->amplitude,
+         cfg->f0_hz, cfg->f1_hz, (unsigned long)total, fs_hz);
+    return true;
+}
+
+void identificacao_giro(int16_t giro_pitch, int16_t giro_roll) {
+    s_giro[IDENT_PITCH] = giro_pitch;
+    s_giro[IDENT_ROLL]  = giro_roll;
+}
+
+// Excitação da amostra n (sem a amplitude)
+static float excitacao(uint32_t n) {
+    if (s_cfg.sinal == IDENT_PRBS) {
+        if (s_prbs_contador++ == 0) {
+            uint16_t bit = ((s_lfsr >> 9) ^ (s_lfsr >> 6)) & 1;
+            s_lfsr = ((s_lfsr << 1) | bit) & 0x3FF;
+            s_prbs_valor = bit ? 1.0f : -1.0f;
+        }
+        if (s_prbs_contador >= s_prbs_manter) s_prbs_contador = 0;
+        return s_prbs_valor;
+    }
+
+    // Chirp logarítmico: f(t) = f0 * (f1/f0)^(t/T)
+    float t = n / s_fs_hz;
+    float duracao = s_total / s_fs_hz;
+    float ln_k = logf(s_cfg.f1_hz / s_cfg.f0_hz);
+    float fase = 2.0f * (float)M_PI * s_cfg.f0_hz * duracao / ln_k * (expf(ln_k * t / duracao) - 1.0f);
+    return sinf(fase);
+}
+
+float identificacao_aplicar(ident_eixo_t eixo, float saida, float fs_hz) {
+    if (s_estado != IDENT_GRAVANDO || eixo != s_cfg.eixo) return saida;
+
+    // O período de controle mudou no meio (modo de energia): a gravação não serve mais
+    if (fs_hz != s_fs_hz) {
+        s_estado = IDENT_CANCELADO;
+        if (s_task) xTaskNotifyGive(s_task);
+        return saida;
+    }
+
+    float r = s_cfg.amplitude * excitacao(s_n);
+    float u = saida + r;
+    ident_amostra_t *a = &s_buf[s_n];
+    a->r = saturar_int16(r * IDENT_ESCALA_CMD);
+    a->u = saturar_int16(u * IDENT_ESCALA_CMD);
+    a->y = s_giro[eixo];
+
+    if (++s_n >= s_total) {
+        s_estado = IDENT_TRANSMITINDO;
+        if (s_task) xTaskNotifyGive(s_task);
+    }
+    return u;
+}
+
+static void transmitir(void) {
+    if (!mqtt_publish_identificacao_inicio(&s_cfg, s_fs_hz, s_total)) {
+        LOGW(TAG, "MQTT indisponível, gravação descartada.");
+        return;
+    }
+    for (uint32_t i = 0; i < s_total; i += IDENT_BLOCO) {
+        uint16_t n = (s_total - i < IDENT_BLOCO) ? (uint16_t)(s_total - i) : IDENT_BLOCO;
+        if (!mqtt_publish_identificacao_bloco(i, &s_buf[i], n)) {
+            LOGW(TAG, "Envio interrompido na amostra %lu.", (unsigned long)i);
+            return;
+        }
+        vTaskDelay(pdMS_TO_TICKS(IDENT_PAUSA_BLOCO_MS));
+    }
+    LOGI(TAG, "Gravação enviada (%lu amostras).", (unsigned long)s_total);
+}
+
+void task_identificacao(void *pvParameters) {
+    s_task = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (s_estado == IDENT_TRANSMITINDO) {
+            transmitir();
+        } else if (s_estado == IDENT_CANCELADO) {
+            LOGW(TAG, "Período de controle mudou durante a gravação, identificação cancelada.");
+        } else {
+            continue;
+        }
+
+        free(s_buf);
+        s_buf = NULL;
+        s_estado = IDENT_LIVRE;
+    }
+    vTaskDelete(NULL);
+}
+
+int identificacao_eixo_por_nome(const char *nome) {
+    if (!nome) return -1;
+    for (int i = 0; i < IDENT_NUM_EIXOS; i++) {
+        if (strcmp(nome, s_nomes_eixo[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int identificacao_sinal_por_nome(const char *nome) {
+    if (!nome) return -1;
+    for (int i = 0; i < IDENT_NUM_SINAIS; i++) {
+        if (strcmp(nome, s_nomes_sinal[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char *identificacao_nome_eixo(ident_eixo_t eixo) {
+    return (eixo < IDENT_NUM_EIXOS) ? s_nomes_eixo[eixo] : "?";
+}
+
+const char *identificacao_nome_sinal(ident_sinal_t sinal) {
+    return (sinal < IDENT_NUM_SINAIS) ? s_nomes_sinal[sinal] : "?";
+}
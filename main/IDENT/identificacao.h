@@ -0,0 +1,78 @@
+#ifndef IDENTIFICACAO_H
+#define IDENTIFICACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IDENT_ESCALA_CMD        1000.0f     // Comando gravado em milésimos (rad/s do velocity_openloop)
+#define IDENT_GIRO_LSB_POR_GRAU 65.0f       // Giroscópio gravado em LSB (FS_500)
+
+typedef enum {
+    IDENT_PITCH = 0,
+    IDENT_ROLL,
+    IDENT_NUM_EIXOS
+} ident_eixo_t;
+
+typedef enum {
+    IDENT_CHIRP = 0,        // Seno com frequência crescente exponencial de f0 a f1
+    IDENT_PRBS,             // Sequência binária pseudoaleatória com banda até ~f1
+    IDENT_NUM_SINAIS
+} ident_sinal_t;
+
+// Pedido recebido via MQTT
+typedef struct {
+    ident_eixo_t eixo;
+    ident_sinal_t sinal;
+    float amplitude;        // Mesma unidade da saída do PID
+    float f0_hz;
+    float f1_hz;
+    float duracao_s;
+} ident_config_t;
+
+// Uma amostra gravada a cada ciclo da task_pid
+typedef struct {
+    int16_t r;              // Excitação injetada (x IDENT_ESCALA_CMD)
+    int16_t u;              // Comando total enviado ao motor (x IDENT_ESCALA_CMD)
+    int16_t y;              // Taxa do giroscópio do eixo (LSB, antes dos filtros)
+} ident_amostra_t;
+
+/**
+ * @brief Aloca o buffer e arma a gravação (chamada pelo MQTT).
+ * @return false se já houver uma identificação em andamento ou o pedido for inválido.
+ */
+bool identificacao_solicitar(const ident_config_t *cfg);
+
+/**
+ * @brief Última leitura bruta do giroscópio (chamada pela task_mpu a cada leitura).
+ */
+void identificacao_giro(int16_t giro_pitch, int16_t giro_roll);
+
+/**
+ * @brief Soma a excitação à saída do eixo e grava a amostra (chamada pela task_pid a cada ciclo).
+ * Sem identificação em andamento no eixo, devolve a saída inalterada.
+ */
+float identificacao_aplicar(ident_eixo_t eixo, float saida, float fs_hz);
+
+/**
+ * @brief Task que envia a gravação pelo MQTT ao terminar e libera o buffer (núcleo 0).
+ */
+void task_identificacao(void *pvParameters);
+
+/**
+ * @brief Converte nomes ("pitch", "roll" / "chirp", "prbs").
+ * @return -1 se desconhecido.
+ */
+int identificacao_eixo_por_nome(const char *nome);
+int identificacao_sinal_por_nome(const char *nome);
+const char *identificacao_nome_eixo(ident_eixo_t eixo);
+const char *identificacao_nome_sinal(ident_sinal_t sinal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IDENTIFICACAO_H
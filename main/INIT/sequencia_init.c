@@ -0,0 +1,51 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "sequencia_init.h"
+
+static const char *TAG = "INIT";
+
+static EventGroupHandle_t s_eventos_init = NULL;
+
+// Instante (us desde o boot) em que cada fase ficou pronta pela primeira vez
+static int64_t s_instantes_us[INIT_NUM_FASES] = { 0 };
+
+static const char *s_nomes[INIT_NUM_FASES] = {
+    "i2c", "sensor", "calibrado", "motores", "rede", "broker", "estabilizado"
+};
+
+void init_sequencia_criar(void) {
+    if (!s_eventos_init) s_eventos_init = xEventGroupCreate();
+}
+
+void init_marcar(EventBits_t fase) {
+    int64_t agora = esp_timer_get_time();
+    for (int i = 0; i < INIT_NUM_FASES; i++) {
+        if ((fase & (1 << i)) && s_instantes_us[i] == 0) s_instantes_us[i] = agora;
+    }
+    xEventGroupSetBits(s_eventos_init, fase);
+}
+
+void init_desmarcar(EventBits_t fase) {
+    xEventGroupClearBits(s_eventos_init, fase);
+}
+
+bool init_aguardar(EventBits_t fases, TickType_t espera_ticks) {
+    EventBits_t bits = xEventGroupWaitBits(s_eventos_init, fases, pdFALSE, pdTRUE, espera_ticks);
+    return (bits & fases) == fases;
+}
+
+void init_publicar_relatorio(void) {
+    for (int i = 0; i < INIT_NUM_FASES; i++) {
+        if (s_instantes_us[i] != 0) {
+            LOGI(TAG, "Fase %-12s pronta em %lld ms", s_nomes[i], s_instantes_us[i] / 1000);
+        } else {
+            LOGW(TAG, "Fase %-12s pendente", s_nomes[i]);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+// main/INIT/sequencia_init.h
+
+#ifndef SEQUENCIA_INIT_H
+#define SEQUENCIA_INIT_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Fases da inicialização (bits de g_eventos_init) ---
+#define INIT_I2C_PRONTO         BIT0    // Barramento I2C instalado
+#define INIT_SENSOR_PRONTO      BIT1    // MPU6050 respondeu e foi configurado
+#define INIT_CALIBRADO          BIT2    // Offsets aplicados e filtros inicializados
+#define INIT_MOTORES_PRONTOS    BIT3    // Drivers e motores configurados
+#define INIT_REDE_PRONTA        BIT4    // Wi-Fi com IP
+#define INIT_BROKER_CONECTADO   BIT5    // Cliente MQTT conectado
+#define INIT_ESTABILIZADO       BIT6    // Gimbal parado no setpoint pela primeira vez
+#define INIT_NUM_FASES          7
+
+/**
+ * @brief Cria o event group de inicialização. Chamar no início do app_main.
+ */
+void init_sequencia_criar(void);
+
+/**
+ * @brief Sinaliza que uma fase terminou e guarda o instante da primeira vez.
+ */
+void init_marcar(EventBits_t fase);
+
+/**
+ * @brief Limpa uma fase que pode se desfazer (rede, broker).
+ */
+void init_desmarcar(EventBits_t fase);
+
+/**
+ * @brief Bloqueia até todas as fases pedidas estarem prontas.
+ * @return true se todas ficaram prontas dentro do tempo.
+ */
+bool init_aguardar(EventBits_t fases, TickType_t espera_ticks);
+
+/**
+ * @brief Loga (serial + MQTT) o instante de cada fase desde o boot.
+ */
+void init_publicar_relatorio(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQUENCIA_INIT_H
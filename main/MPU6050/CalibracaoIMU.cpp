@@ -0,0 +1,99 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <stddef.h>
+#include <string.h>
+#include "nvs.h"
+#include "esp_rom_crc.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "MPU6050.h"
+#include "CalibracaoIMU.h"
+
+static const char *TAG = "CALIBRACAO";
+
+// --- NVS ---
+#define CAL_NVS_NAMESPACE   "imu"
+#define CAL_NVS_CHAVE       "calibracao"
+#define CAL_MAGIC           0x43414C49  // "CALI"
+#define CAL_VERSAO          1
+
+// Pedido de recalibração (escrito pelo MQTT, consumido pelo task_mpu)
+static volatile bool s_pedido = false;
+static volatile bool s_pedido_acel = false;
+
+// --- CRC de tudo antes do campo crc ---
+static uint32_t calcular_crc(const calibracao_imu_t *cal) {
+    return esp_rom_crc32_le(0, (const uint8_t *)cal, offsetof(calibracao_imu_t, crc));
+}
+
+bool calibracao_carregar(calibracao_imu_t *cal) {
+    nvs_handle_t nvs;
+    if (nvs_open(CAL_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+
+    size_t tamanho = sizeof(*cal);
+    esp_err_t err = nvs_get_blob(nvs, CAL_NVS_CHAVE, cal, &tamanho);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || tamanho != sizeof(*cal)) return false;
+    if (cal->magic != CAL_MAGIC || cal->versao != CAL_VERSAO) {
+        ESP_LOGW(TAG, "Calibração salva em formato antigo, ignorando.");
+        return false;
+    }
+    if (cal->crc != calcular_crc(cal)) {
+        ESP_LOGW(TAG, "Calibração salva corrompida (CRC), ignorando.");
+        return false;
+    }
+    return true;
+}
+
+bool calibracao_salvar(calibracao_imu_t *cal) {
+    cal->magic = CAL_MAGIC;
+    cal->versao = CAL_VERSAO;
+    cal->crc = calcular_crc(cal);
+
+    nvs_handle_t nvs;
+    if (nvs_open(CAL_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return false;
+
+    esp_err_t err = nvs_set_blob(nvs, CAL_NVS_CHAVE, cal, sizeof(*cal));
+    if (err == ESP_OK) err = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Falha ao salvar calibração: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+void calibracao_aplicar(MPU6050 &mpu, const calibracao_imu_t *cal) {
+    mpu.setXAccelOffset(cal->offset_acel[0]);
+    mpu.setYAccelOffset(cal->offset_acel[1]);
+    mpu.setZAccelOffset(cal->offset_acel[2]);
+    mpu.setXGyroOffset(cal->offset_giro[0]);
+    mpu.setYGyroOffset(cal->offset_giro[1]);
+    mpu.setZGyroOffset(cal->offset_giro[2]);
+}
+
+void calibracao_ler(MPU6050 &mpu, calibracao_imu_t *cal) {
+    memset(cal, 0, sizeof(*cal));
+    cal->offset_acel[0] = mpu.getXAccelOffset();
+    cal->offset_acel[1] = mpu.getYAccelOffset();
+    cal->offset_acel[2] = mpu.getZAccelOffset();
+    cal->offset_giro[0] = mpu.getXGyroOffset();
+    cal->offset_giro[1] = mpu.getYGyroOffset();
+    cal->offset_giro[2] = mpu.getZGyroOffset();
+    cal->temperatura_c = calibracao_temperatura_c(mpu.getTemperature());
+}
+
+void calibracao_solicitar(bool incluir_acel) {
+    s_pedido_acel = incluir_acel;
+    s_pedido = true;
+    LOGI(TAG, "Recalibração solicitada (acelerômetro: %s)", incluir_acel ? "sim" : "não");
+}
+
+bool calibracao_pendente(bool *incluir_acel) {
+    if (!s_pedido) return false;
+    if (incluir_acel) *incluir_acel = s_pedido_acel;
+    s_pedido = false;
+    return true;
+}
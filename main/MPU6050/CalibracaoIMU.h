@@ -0,0 +1,69 @@
+// main/MPU6050/CalibracaoIMU.h
+
+#ifndef CALIBRACAOIMU_H
+#define CALIBRACAOIMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pede uma recalibração completa ao task_mpu (ex.: comando MQTT).
+ * O gimbal deve estar parado e nivelado se incluir_acel for true.
+ */
+void calibracao_solicitar(bool incluir_acel);
+
+#ifdef __cplusplus
+}
+
+#include "MPU6050.h"
+
+// Resultado de uma calibração, como gravado na NVS
+typedef struct {
+    uint32_t magic;
+    uint16_t versao;
+    int16_t offset_acel[3];     // XA/YA/ZA_OFFS
+    int16_t offset_giro[3];     // XG/YG/ZG_OFFS_USR
+    float temperatura_c;        // Temperatura do die na calibração
+    uint32_t crc;               // CRC32 dos campos acima
+} calibracao_imu_t;
+
+/**
+ * @brief Carrega e valida (magic, versão, CRC) a calibração salva.
+ */
+bool calibracao_carregar(calibracao_imu_t *cal);
+
+/**
+ * @brief Salva a calibração na NVS (calcula o CRC).
+ */
+bool calibracao_salvar(calibracao_imu_t *cal);
+
+/**
+ * @brief Escreve os offsets salvos nos registradores do MPU6050.
+ */
+void calibracao_aplicar(MPU6050 &mpu, const calibracao_imu_t *cal);
+
+/**
+ * @brief Lê os offsets atuais do MPU6050 e a temperatura.
+ */
+void calibracao_ler(MPU6050 &mpu, calibracao_imu_t *cal);
+
+/**
+ * @brief Consome um pedido de recalibração pendente.
+ * @return true se havia pedido; incluir_acel indica se o acelerômetro entra.
+ */
+bool calibracao_pendente(bool *incluir_acel);
+
+/**
+ * @brief Converte a leitura bruta do sensor de temperatura para graus Celsius.
+ */
+static inline float calibracao_temperatura_c(int16_t bruto) {
+    return bruto / 340.0f + 36.53f;
+}
+
+#endif // __cplusplus
+
+#endif // CALIBRACAOIMU_H
@@ -0,0 +1,103 @@
+// main/MPU6050/KalmanBank.h
+
+#ifndef KALMANBANK_H
+#define KALMANBANK_H
+
+#include <math.h>
+
+// --- Kalman adaptativo ---
+#define DESVIO_G_REF        0.05f       // |a| fora de 1 g por 0.05 g dobra o R
+#define ALFA_NIS            0.05f       // Janela (~20 updates) da média de y²/S
+#define FATOR_R_MAX         100.0f
+
+/**
+ * @brief Banco de N filtros de Kalman (ângulo + bias) em estrutura de arrays.
+ *
+ * Cada elemento de P fica num array próprio e os laços rodam sobre os eixos,
+ * então os N filtros formam cadeias independentes de multiplica-acumula
+ * (madd.s do FPU do ESP32) e o laço vetoriza automaticamente no host.
+ * Os laços são desenrolados: com N = 2 e -O2/-Os o contador do laço custava
+ * mais que o ganho (ver host_test/bench_kalman).
+ *
+ * Modo adaptativo: R cresce quando o acelerômetro não é confiável
+ * (|a| longe de 1 g ou inovações maiores que o previsto) e Q_bias cai
+ * na mesma proporção, para o bias não aprender com vibração.
+ */
+template <int N>
+class KalmanBank {
+public:
+    float angle[N];
+    float bias[N];
+    float P00[N], P01[N], P10[N], P11[N];
+
+    float Q_angle = 0.001f;
+    float Q_bias  = 0.005f;
+    float R_measure = 0.03f;
+
+    bool adaptativo = false;
+    float nis_medio[N];     // Média móvel de y²/S (1 = filtro consistente)
+    float fator_r[N];       // Fator aplicado a R_measure (e divisor de Q_bias)
+    float vibracao_media = 0.0f;    // Média móvel de (desvio_g / DESVIO_G_REF)²
+
+    KalmanBank() {
+        for (int i = 0; i < N; i++) {
+            angle[i] = bias[i] = 0.0f;
+            P00[i] = P01[i] = P10[i] = P11[i] = 0.0f;
+            nis_medio[i] = 1.0f;
+            fator_r[i] = 1.0f;
+            q_bias_ef[i] = Q_bias;
+        }
+    }
+
+    void predict(const float *gyro_rate, float dt) {
+        #pragma GCC unroll 4
+        for (int i = 0; i < N; i++) {
+            angle[i] += dt * (gyro_rate[i] - bias[i]);
+            P00[i] += dt * (dt*P11[i] - P01[i] - P10[i] + Q_angle);
+            P01[i] -= dt * P11[i];
+            P10[i] -= dt * P11[i];
+            P11[i] += q_bias_ef[i] * dt;
+        }
+    }
+
+    void update(const float *measured_angle, float desvio_g = 0.0f) {
+        // R segue o nível de vibração, não a fase: com o desvio instantâneo o filtro aceitava
+        // justamente as amostras em que |a| passava por 1 g, e o erro dessas não tem média zero
+        float fg = desvio_g / DESVIO_G_REF;
+        if (adaptativo) vibracao_media += ALFA_NIS * (fg*fg - vibracao_media);
+        float fator_g = 1.0f + vibracao_media;
+
+        #pragma GCC unroll 4
+        for (int i = 0; i < N; i++) {
+            float y = measured_angle[i] - angle[i];
+
+            float f = 1.0f;
+            if (adaptativo) {
+                nis_medio[i] += ALFA_NIS * (y*y / (P00[i] + R_measure*fator_r[i]) - nis_medio[i]);
+                f = fminf(fator_g * fmaxf(1.0f, nis_medio[i]), FATOR_R_MAX);
+            }
+            fator_r[i] = f;
+            q_bias_ef[i] = Q_bias / f;
+
+            float inv_S = 1.0f / (P00[i] + R_measure * f);
+            float K0 = P00[i] * inv_S;
+            float K1 = P10[i] * inv_S;
+
+            angle[i] += K0 * y;
+            bias[i]  += K1 * y;
+
+            float P00_temp = P00[i];
+            float P01_temp = P01[i];
+
+            P00[i] -= K0 * P00_temp;
+            P01[i] -= K0 * P01_temp;
+            P10[i] -= K1 * P00_temp;
+            P11[i] -= K1 * P01_temp;
+        }
+    }
+
+private:
+    float q_bias_ef[N];     // Q_bias / fator_r, recalculado só no update
+};
+
+#endif // KALMANBANK_H
@@ -0,0 +1,188 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "esp_rom_crc.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "ModeloTermico.h"
+
+static const char *TAG = "TERMICO";
+
+// --- NVS ---
+#define TERM_NVS_NAMESPACE      "imu"
+#define TERM_NVS_CHAVE          "termico"
+#define TERM_MAGIC              0x5445524D  // "TERM"
+#define TERM_VERSAO             1
+#define TERM_INTERVALO_SALVAR   (10 * 60 * 1000000LL)  // 10 min entre gravações
+
+// --- Ajuste ---
+#define TEMP_REFERENCIA         25.0f       // Centraliza as somas (condicionamento em float)
+#define FATOR_ESQUECIMENTO      0.9999f     // ~2.8 h de memória com 1 amostra/s
+#define PESO_MINIMO             30.0f       // Amostras efetivas antes de usar o modelo
+#define VARIANCIA_TEMP_MINIMA   1.0f        // (grau C)^2 de faixa coberta
+#define INCLINACAO_MAXIMA       0.005f      // rad/s por grau C (folga sobre o datasheet)
+
+// Somas ponderadas do ajuste bias = a + b*(T - TEMP_REFERENCIA)
+typedef struct {
+    float s0;       // Σw
+    float s1;       // Σw·T
+    float s2;       // Σw·T²
+    float sb;       // Σw·bias
+    float stb;      // Σw·T·bias
+} somas_t;
+
+// Formato gravado na NVS
+typedef struct {
+    uint32_t magic;
+    uint16_t versao;
+    somas_t eixo[TERMICO_NUM_EIXOS];
+    uint32_t crc;
+} termico_nvs_t;
+
+static somas_t s_eixo[TERMICO_NUM_EIXOS];
+static volatile bool s_alterado = false;
+static int64_t s_ultimo_salvo_us = 0;
+
+// Gravação na NVS fora do laço de 1 kHz: task_mpu copia o modelo e acorda a task de gravação
+static termico_nvs_t s_copia;
+static volatile bool s_gravando = false;
+static TaskHandle_t s_task_gravar = NULL;
+
+static uint32_t calcular_crc(const termico_nvs_t *m) {
+    return esp_rom_crc32_le(0, (const uint8_t *)m, offsetof(termico_nvs_t, crc));
+}
+
+// Inclinação e intercepto do ajuste (inclinação 0 sem faixa de temperatura)
+static void ajustar(const somas_t *s, float *a, float *b) {
+    *a = 0.0f;
+    *b = 0.0f;
+    if (s->s0 <= 0.0f) return;
+
+    float media_t = s->s1 / s->s0;
+    float var_t = s->s2 / s->s0 - media_t * media_t;
+    if (var_t > 1e-3f) {
+        *b = (s->stb / s->s0 - media_t * (s->sb / s->s0)) / var_t;
+        *b = fmaxf(-INCLINACAO_MAXIMA, fminf(INCLINACAO_MAXIMA, *b));
+    }
+    *a = s->sb / s->s0 - *b * media_t;
+}
+
+static bool modelo_valido(const somas_t *s) {
+    if (s->s0 < PESO_MINIMO) return false;
+    float media_t = s->s1 / s->s0;
+    return (s->s2 / s->s0 - media_t * media_t) >= VARIANCIA_TEMP_MINIMA;
+}
+
+// --- Grava a cópia na NVS (core 0, prioridade baixa; flash apagando pode levar dezenas de ms) ---
+static void task_gravar_termico(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        nvs_handle_t nvs;
+        esp_err_t err = nvs_open(TERM_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+        if (err == ESP_OK) {
+            err = nvs_set_blob(nvs, TERM_NVS_CHAVE, &s_copia, sizeof(s_copia));
+            if (err == ESP_OK) err = nvs_commit(nvs);
+            nvs_close(nvs);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Falha ao salvar modelo térmico: %s", esp_err_to_name(err));
+            s_alterado = true;     // Tenta de novo no próximo intervalo
+        }
+        s_gravando = false;
+    }
+}
+
+void termico_iniciar(void) {
+    memset(s_eixo, 0, sizeof(s_eixo));
+    s_alterado = false;
+
+    if (!s_task_gravar) {
+        xTaskCreatePinnedToCore(task_gravar_termico, "task_termico", 3072, NULL, 1, &s_task_gravar, 0);
+    }
+
+    nvs_handle_t nvs;
+    if (nvs_open(TERM_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+
+    termico_nvs_t m;
+    size_t tamanho = sizeof(m);
+    esp_err_t err = nvs_get_blob(nvs, TERM_NVS_CHAVE, &m, &tamanho);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || tamanho != sizeof(m)) return;
+    if (m.magic != TERM_MAGIC || m.versao != TERM_VERSAO || m.crc != calcular_crc(&m)) {
+        ESP_LOGW(TAG, "Modelo térmico salvo inválido, ignorando.");
+        return;
+    }
+    memcpy(s_eixo, m.eixo, sizeof(s_eixo));
+
+    for (int i = 0; i < TERMICO_NUM_EIXOS; i++) {
+        float a, b;
+        ajustar(&s_eixo[i], &a, &b);
+        LOGI(TAG, "Eixo %d: %.5f rad/s por grau C (%s)", i, b, modelo_valido(&s_eixo[i]) ? "válido" : "em treino");
+    }
+}
+
+void termico_amostrar(termico_eixo_t eixo, float temp_c, float bias) {
+    somas_t *s = &s_eixo[eixo];
+    float t = temp_c - TEMP_REFERENCIA;
+    bool era_valido = modelo_valido(s);
+
+    s->s0  = s->s0  * FATOR_ESQUECIMENTO + 1.0f;
+    s->s1  = s->s1  * FATOR_ESQUECIMENTO + t;
+    s->s2  = s->s2  * FATOR_ESQUECIMENTO + t * t;
+    s->sb  = s->sb  * FATOR_ESQUECIMENTO + bias;
+    s->stb = s->stb * FATOR_ESQUECIMENTO + t * bias;
+    s_alterado = true;
+
+    if (!era_valido && modelo_valido(s)) {
+        float a, b;
+        ajustar(s, &a, &b);
+        LOGI(TAG, "Modelo do eixo %d válido: %.5f rad/s por grau C", eixo, b);
+    }
+}
+
+bool termico_prever(termico_eixo_t eixo, float temp_c, float *bias) {
+    const somas_t *s = &s_eixo[eixo];
+    if (!modelo_valido(s)) return false;
+
+    float a, b;
+    ajustar(s, &a, &b);
+    *bias = a + b * (temp_c - TEMP_REFERENCIA);
+    return true;
+}
+
+void termico_rebasear(termico_eixo_t eixo, float temp_c, float bias) {
+    somas_t *s = &s_eixo[eixo];
+    if (s->s0 <= 0.0f) return;
+
+    // Somar d a todas as amostras de bias: Σw·b += d·Σw e Σw·T·b += d·Σw·T
+    float a, b;
+    ajustar(s, &a, &b);
+    float d = bias - (a + b * (temp_c - TEMP_REFERENCIA));
+    s->sb  += d * s->s0;
+    s->stb += d * s->s1;
+    s_alterado = true;
+}
+
+void termico_persistir(int64_t agora_us) {
+    if (!s_alterado || s_gravando || !s_task_gravar) return;
+    if (agora_us - s_ultimo_salvo_us < TERM_INTERVALO_SALVAR) return;
+    s_ultimo_salvo_us = agora_us;
+
+    // Só a task_mpu altera s_eixo; a cópia fica intocada até a gravação terminar
+    memset(&s_copia, 0, sizeof(s_copia));
+    s_copia.magic = TERM_MAGIC;
+    s_copia.versao = TERM_VERSAO;
+    memcpy(s_copia.eixo, s_eixo, sizeof(s_eixo));
+    s_copia.crc = calcular_crc(&s_copia);
+
+    s_alterado = false;
+    s_gravando = true;
+    xTaskNotifyGive(s_task_gravar);
+}
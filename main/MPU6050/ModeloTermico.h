@@ -0,0 +1,53 @@
+// main/MPU6050/ModeloTermico.h
+
+#ifndef MODELOTERMICO_H
+#define MODELOTERMICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Eixos modelados (os dois filtros de Kalman)
+typedef enum {
+    TERMICO_PITCH = 0,      // Giroscópio Y
+    TERMICO_ROLL,           // Giroscópio X
+    TERMICO_NUM_EIXOS
+} termico_eixo_t;
+
+/**
+ * @brief Carrega o modelo bias x temperatura salvo na NVS (ou começa vazio).
+ */
+void termico_iniciar(void);
+
+/**
+ * @brief Adiciona uma amostra (temperatura, bias estimado em rad/s) ao
+ * ajuste por mínimos quadrados do eixo.
+ */
+void termico_amostrar(termico_eixo_t eixo, float temp_c, float bias);
+
+/**
+ * @brief Bias previsto para a temperatura.
+ * @return false enquanto o modelo não cobre uma faixa de temperatura suficiente.
+ */
+bool termico_prever(termico_eixo_t eixo, float temp_c, float *bias);
+
+/**
+ * @brief Desloca o modelo para passar por (temp_c, bias) sem mudar a inclinação.
+ * Usada quando os offsets do giroscópio mudam (boot, recalibração).
+ */
+void termico_rebasear(termico_eixo_t eixo, float temp_c, float bias);
+
+/**
+ * @brief Agenda a gravação do modelo na NVS se houver amostras novas e o intervalo mínimo passou.
+ * Só copia o modelo (chamada pela task_mpu); a escrita na flash roda numa task de baixa prioridade no core 0.
+ */
+void termico_persistir(int64_t agora_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODELOTERMICO_H
@@ -1,5 +1,4 @@
 // --- Includes Padrão e de Biblioteca ---
-#include <driver/i2c.h>
 #include "log_mqtt.h"
 #include <esp_err.h>
 #include <math.h>
@@ -8,77 +7,140 @@
 #include "BufferTelemetria.h"
 #include "esp_timer.h"
 #include "esp_rom_sys.h"
+#include "esp_cpu.h"
 
 // --- Includes das Bibliotecas C++ do MPU6050 ---
 #include "MPU6050.h"
 #include "sdkconfig.h"
 #include "mainGlobals.h"
 #include "SensorMPU6050.h"
+#include "CalibracaoIMU.h"
+#include "ModeloTermico.h"
+#include "VelocidadeI2C.h"
+#include "KalmanBank.h"
+#include "filtros.h"
+#include "espectro.h"
+#include "identificacao.h"
+#include "gerenciador_energia.h"
+#include "agendador_telemetria.h"
+#include "sequencia_init.h"
 
 // --- Pinos I2C sensor MPU6050 ---
 #define PIN_SDA 21
 #define PIN_SCL 22
+#define I2C_VELOCIDADE_HZ   400000  // 400kHz para velocidade
+
+// --- Leitura assíncrona ---
+#define LEITURA_TIMEOUT_MS  2       // Timeout da transferência no barramento
+#define LEITURA_PRAZO_MS    2       // Quanto o loop espera pela leitura antes de seguir sem ela
+
+// --- Caracterização em operação ---
+#define PARADA_MOTORES_ESPERA_MS    100     // Prazo para a task_pid confirmar os drivers desligados
+
+// --- Fusão multi-taxa ---
+// Todo ciclo lê só GYRO_X/Y (4 bytes) para o predict; a cada N ciclos lê
+// ACCEL_X..GYRO_Y (12 bytes, inclui a temperatura) e faz o update do Kalman.
+#define TAM_LEITURA_GIRO        4
+#define TAM_LEITURA_COMPLETA    12
+#define DIVISOR_ACEL_PADRAO     4       // Update a 250 Hz com loop de 1 kHz
+#define DIVISOR_ACEL_MAX        50
+
+// --- Calibração ---
+#define ACEL_OFFSET_PADRAO_X    -3678   // Usados enquanto não há calibração na NVS
+#define ACEL_OFFSET_PADRAO_Y    -2954
+#define ACEL_OFFSET_PADRAO_Z    1392
+#define BIAS_MAX_LSB            8.0f    // Bias residual aceito no boot rápido (~0.12 grau/s)
+#define AMOSTRAS_REPOUSO        100
+
+// --- Compensação térmica do bias ---
+#define TERMICO_PERIODO_US      1000000     // Leitura de temperatura a 1 Hz
+#define TERMICO_TAXA_REPOUSO    0.05f       // rad/s; acima disso o bias do Kalman não é amostrado
+
+// --- Kalman ---
+#define ACEL_LSB_POR_G      16384.0f    // Escala +/- 2g
+enum { EIXO_PITCH = 0, EIXO_ROLL, NUM_EIXOS };
+
+static KalmanBank<NUM_EIXOS> kalman;
+static cadeia_filtros_t filtro_giro[NUM_EIXOS];
+
+// Ciclos entre leituras do acelerômetro (1 = leitura completa todo ciclo)
+static volatile uint8_t s_divisor_acel = DIVISOR_ACEL_PADRAO;
+
+// R/Q adaptativos (desligado = valores fixos originais)
+static volatile bool s_kalman_adaptativo = false;
+
+// Médias em repouso (LSB), usadas nos ângulos iniciais e para conferir o bias
+typedef struct {
+    float ax, ay, az;
+    float gx, gy, gz;
+} media_repouso_t;
+
+static void medir_repouso(MPU6050 &mpu, media_repouso_t *m) {
+    int32_t sum_ax = 0, sum_ay = 0, sum_az = 0;
+    int32_t sum_gx = 0, sum_gy = 0, sum_gz = 0;
+    int16_t ax, ay, az, gx, gy, gz;
 
-// --- Filtro de Kalman ---
-class KalmanFilter {
-public:
-    float angle = 0.0f;
-    float bias  = 0.0f;
-    float P[2][2] = {{0,0},{0,0}};
-
-    float Q_angle = 0.001f;
-    float Q_bias  = 0.005f;
-    float R_measure = 0.03f; 
-
-    void predict(float gyro_rate, float dt) {
-        angle += dt * (gyro_rate - bias);
-        P[0][0] += dt * (dt*P[1][1] - P[0][1] - P[1][0] + Q_angle);
-        P[0][1] -= dt * P[1][1];
-        P[1][0] -= dt * P[1][1];
-        P[1][1] += Q_bias * dt;
+    for (int i=0; i<AMOSTRAS_REPOUSO; i++) {
+        mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+        sum_ax += ax; sum_ay += ay; sum_az += az;
+        sum_gx += gx; sum_gy += gy; sum_gz += gz;
+        esp_rom_delay_us(1000);
     }
 
-    void update(float measured_angle) {
-        float y = measured_angle - angle;
-        float S = P[0][0] + R_measure;
-
-        float K0 = P[0][0] / S;
-        float K1 = P[1][0] / S;
+    m->ax = sum_ax / (float)AMOSTRAS_REPOUSO;
+    m->ay = sum_ay / (float)AMOSTRAS_REPOUSO;
+    m->az = sum_az / (float)AMOSTRAS_REPOUSO;
+    m->gx = sum_gx / (float)AMOSTRAS_REPOUSO;
+    m->gy = sum_gy / (float)AMOSTRAS_REPOUSO;
+    m->gz = sum_gz / (float)AMOSTRAS_REPOUSO;
+}
 
-        angle += K0 * y;
-        bias  += K1 * y;
+// Maior bias do giroscópio que sobrou depois dos offsets
+static float bias_residual_lsb(const media_repouso_t *m) {
+    return fmaxf(fabsf(m->gx), fmaxf(fabsf(m->gy), fabsf(m->gz)));
+}
 
-        float P00_temp = P[0][0];
-        float P01_temp = P[0][1];
+// Tráfego no barramento desde o último resetStats (custo de cada operação)
+static void log_barramento(const char *operacao) {
+    I2CdevStats st;
+    I2Cdev::getStats(&st);
+    LOGI("I2C", "%s: %lu transações, %lu bytes escritos, %lu lidos, %lu erros", operacao,
+         (unsigned long)st.transactions, (unsigned long)st.bytesWritten,
+         (unsigned long)st.bytesRead, (unsigned long)st.errors);
+    I2Cdev::resetStats();
+}
 
-        P[0][0] -= K0 * P00_temp;
-        P[0][1] -= K0 * P01_temp;
-        P[1][0] -= K1 * P00_temp;
-        P[1][1] -= K1 * P01_temp;
+// Calibração completa (médias da FIFO + offsets em forma fechada), salva na NVS
+static void calibrar_completo(MPU6050 &mpu, bool incluir_acel) {
+    LOGI("MPU6050", "Calibrando %s...", incluir_acel ? "Acelerômetro e Giroscópio" : "Giroscópio");
+    if (!mpu.CalibrateFast(incluir_acel, 1)) {
+        // FIFO não encheu: o PID lê os registradores de dados direto, sem a FIFO
+        LOGW("MPU6050", "FIFO vazia na calibração rápida, usando a calibração por PID.");
+        if (incluir_acel) mpu.CalibrateAccel(6);
+        mpu.CalibrateGyro(6);
     }
-};
 
-static KalmanFilter kalmanPitch;
-static KalmanFilter kalmanRoll;
+    calibracao_imu_t cal;
+    calibracao_ler(mpu, &cal);
+    if (calibracao_salvar(&cal)) {
+        LOGI("MPU6050", "Calibração salva (%.1f C).", cal.temperatura_c);
+    }
+}
 
 // Task de inicialização do barramento I2C
 void task_initI2C(void *ignore) {
-    i2c_config_t conf = {};
-    conf.mode = I2C_MODE_MASTER;
-    conf.sda_io_num = (gpio_num_t)PIN_SDA;
-    conf.scl_io_num = (gpio_num_t)PIN_SCL;
-    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = 400000; // 400kHz para velocidade
-    ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_NUM_0, I2C_MODE_MASTER, 0, 0, 0));
+    ESP_ERROR_CHECK(I2Cdev::begin((gpio_num_t)PIN_SDA, (gpio_num_t)PIN_SCL, I2C_VELOCIDADE_HZ));
+    init_marcar(INIT_I2C_PRONTO);
     vTaskDelete(NULL);
 }
 
 // Task de inicialização do barramento I2C
 void task_mpu(void *) {
+    init_aguardar(INIT_I2C_PRONTO, portMAX_DELAY);
+
     MPU6050 mpu;
     // Inicializa comunicação com o MPU6050
+    I2Cdev::resetStats();
     mpu.initialize();
 
     if (!mpu.testConnection()) {
@@ -87,98 +149,258 @@ void task_mpu(void *) {
     }
     printf("MPU6050 conectado.\n");
 
-	// Calibrações de Offset pré-definidas
-    mpu.setXAccelOffset(-3678); mpu.setYAccelOffset(-2954); mpu.setZAccelOffset(1392);
-
 	// Escala Padrão +/- 2g (1g = 16384)
     mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_2);
     mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
+    log_barramento("Configuração");
+
+    // Velocidade do barramento: salva na NVS ou caracterizada agora (antes da calibração)
+    velocidade_i2c_iniciar();
+    log_barramento("Velocidade do barramento");
+    init_marcar(INIT_SENSOR_PRONTO);
+
+    // Boot rápido: usa os offsets da NVS e só confere o bias em repouso
+    int64_t inicio_cal = esp_timer_get_time();
+    calibracao_imu_t cal;
+    bool carregada = calibracao_carregar(&cal);
+    if (carregada) {
+        calibracao_aplicar(mpu, &cal);
+    } else {
+        // Calibrações de Offset pré-definidas
+        mpu.setXAccelOffset(ACEL_OFFSET_PADRAO_X); mpu.setYAccelOffset(ACEL_OFFSET_PADRAO_Y); mpu.setZAccelOffset(ACEL_OFFSET_PADRAO_Z);
+        calibrar_completo(mpu, false);
+    }
 
-    printf("Calibrando Giroscópio...\n");
-    mpu.CalibrateGyro(20);
-    printf("Calibração concluída.\n");
+    log_barramento("Calibração");
 
-    // Leitura Inicial para definir ângulos iniciais
-    int32_t sum_ax = 0, sum_ay = 0, sum_az = 0;
-    int32_t sum_gx = 0, sum_gy = 0;
-    int16_t ax, ay, az, gx, gy, gz;
+    // Leitura Inicial para definir ângulos iniciais (e conferir o bias)
+    media_repouso_t media;
+    medir_repouso(mpu, &media);
+    log_barramento("Média em repouso");
 
-    for (int i=0; i<100; i++) {
-        mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-        sum_ax += ax; sum_ay += ay; sum_az += az;
-        sum_gx += gx; sum_gy += gy;
-        esp_rom_delay_us(1000);
+    if (carregada && bias_residual_lsb(&media) > BIAS_MAX_LSB) {
+        LOGW("MPU6050", "Bias %.1f LSB acima do limite, recalibrando.", bias_residual_lsb(&media));
+        carregada = false;
+        calibrar_completo(mpu, false);
+        medir_repouso(mpu, &media);
     }
-
-    float avg_ax = sum_ax / 100.0f;
-    float avg_ay = sum_ay / 100.0f;
-    float avg_az = sum_az / 100.0f;
-    float avg_gx = sum_gx / 100.0f;
-    float avg_gy = sum_gy / 100.0f;
+    LOGI("MPU6050", "Calibração %s em %lld ms, bias residual %.1f LSB.", carregada ? "da NVS" : "completa",
+         (esp_timer_get_time() - inicio_cal) / 1000, bias_residual_lsb(&media));
 
     // Pitch (Y): atan2(-ax, sqrt(ay² + az²))
-    float init_pitch = atan2(-avg_ax, sqrt(avg_ay*avg_ay + avg_az*avg_az));
+    float init_pitch = atan2(-media.ax, sqrt(media.ay*media.ay + media.az*media.az));
 
     // Roll (X): atan2(ay, az)
-    float init_roll  = atan2(avg_ay, avg_az);
+    float init_roll  = atan2(media.ay, media.az);
 
     // Inicializa Filtros de Kalman com os valores iniciais
-    kalmanRoll.angle  = init_roll;
-    kalmanPitch.angle = init_pitch;
-    kalmanRoll.bias  = (avg_gx / 131.0f) * (M_PI/180.0f);
-    kalmanPitch.bias = (avg_gy / 131.0f) * (M_PI/180.0f);
+    kalman.angle[EIXO_ROLL]  = init_roll;
+    kalman.angle[EIXO_PITCH] = init_pitch;
+    kalman.bias[EIXO_ROLL]  = (media.gx / 131.0f) * (M_PI/180.0f);
+    kalman.bias[EIXO_PITCH] = (media.gy / 131.0f) * (M_PI/180.0f);
+
+    // Modelo bias x temperatura: alinha ao bias medido agora (offsets podem ter mudado)
+    float temp_anterior = calibracao_temperatura_c(mpu.getTemperature());
+    termico_iniciar();
+    termico_rebasear(TERMICO_PITCH, temp_anterior, kalman.bias[EIXO_PITCH]);
+    termico_rebasear(TERMICO_ROLL, temp_anterior, kalman.bias[EIXO_ROLL]);
+    int64_t ultima_temp_us = esp_timer_get_time();
 
     // Indica que o MPU está pronto
-    xSemaphoreGive(g_mpu_pronta);
+    init_marcar(INIT_CALIBRADO);
 
     // Tempo de loop da task do MPU6050
     int64_t last_time = esp_timer_get_time();
     int telemetry_counter = 0;
+    int16_t ax, ay, az, gx, gy;
+    uint8_t bruto[TAM_LEITURA_COMPLETA];
+    float taxa[NUM_EIXOS] = {0.0f, 0.0f};      // Última taxa do giroscópio (rad/s)
+    for (int i = 0; i < NUM_EIXOS; i++) cadeia_iniciar(&filtro_giro[i]);
+    float medido[NUM_EIXOS];
+    uint32_t ciclos_kalman = 0;                 // Ciclos de CPU no Kalman no último segundo
+    uint32_t leituras_perdidas = 0;
+    uint8_t ciclo_acel = 0;
+    int16_t temp_bruta = mpu.getTemperature();
+    int64_t tempo_leitura_us = 0;     // Tempo no barramento acumulado no último segundo
+    uint32_t leituras = 0;
 
     while(1) {
+        // Recalibração pedida via MQTT (o gimbal deve estar parado)
+        bool incluir_acel;
+        if (calibracao_pendente(&incluir_acel)) {
+            int64_t inicio = esp_timer_get_time();
+            calibrar_completo(mpu, incluir_acel);
+            medir_repouso(mpu, &media);
+            kalman.bias[EIXO_ROLL]  = (media.gx / 131.0f) * (M_PI/180.0f);
+            kalman.bias[EIXO_PITCH] = (media.gy / 131.0f) * (M_PI/180.0f);
+            temp_anterior = calibracao_temperatura_c(mpu.getTemperature());
+            termico_rebasear(TERMICO_PITCH, temp_anterior, kalman.bias[EIXO_PITCH]);
+            termico_rebasear(TERMICO_ROLL, temp_anterior, kalman.bias[EIXO_ROLL]);
+            LOGI("MPU6050", "Recalibração em %lld ms, bias residual %.1f LSB.",
+                 (esp_timer_get_time() - inicio) / 1000, bias_residual_lsb(&media));
+            last_time = esp_timer_get_time();
+        }
+
+        // Caracterização do barramento pedida via MQTT: o ângulo para de ser atualizado,
+        // então os drivers são desligados antes (recusada se a task_pid não confirmar)
+        if (velocidade_i2c_pendente()) {
+            if (velocidade_i2c_parar_motores(PARADA_MOTORES_ESPERA_MS)) {
+                velocidade_i2c_caracterizar();
+            } else {
+                LOGW("I2C", "Caracterização recusada: motores não confirmaram a parada");
+            }
+            last_time = esp_timer_get_time();
+            velocidade_i2c_liberar_motores();
+        }
+
         int64_t now = esp_timer_get_time();
 
         // Delta time em segundos
         float dt = (now - last_time) / 1000000.0f;
         last_time = now;
 
-        // Lê dados brutos do sensor
-        mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-
-        // Converte para unidades físicas
-        float gxr = (gx/65.0f)*(M_PI/180.0f);
-        float gyr = (gy/65.0f)*(M_PI/180.0f);
-
-        // Pitch (Eixo X do sensor, rotação sobre Y)
-        float acc_p = atan2((float)-ax, sqrt((float)ay*ay + (float)az*az));
-
-        // Roll (Eixo Y do sensor, rotação sobre X) 
-        float acc_r = atan2((float)ay, (float)az);
+        // Só o giroscópio, ou leitura completa quando é a vez do acelerômetro
+        bool completa = (++ciclo_acel >= s_divisor_acel);
+        uint8_t reg = completa ? MPU6050_RA_ACCEL_XOUT_H : MPU6050_RA_GYRO_XOUT_H;
+        uint8_t tamanho = completa ? TAM_LEITURA_COMPLETA : TAM_LEITURA_GIRO;
 
-        // Atualiza Filtros de Kalman
-        kalmanRoll.predict(gxr, dt);
-        kalmanRoll.update(acc_r);
+        // Lê dados brutos do sensor (o worker do I2Cdev faz a transferência e notifica esta task)
+        esp_err_t leitura = ESP_FAIL;
+        int64_t inicio_leitura = esp_timer_get_time();
+        if (I2Cdev::readBytesAsync(MPU6050_DEFAULT_ADDRESS, reg, tamanho, LEITURA_TIMEOUT_MS)) {
+            leitura = I2Cdev::waitAsync(bruto, tamanho, LEITURA_PRAZO_MS);
+        }
+        tempo_leitura_us += esp_timer_get_time() - inicio_leitura;
+        leituras++;
+
+        if (leitura == ESP_OK) {
+            // Giroscópio X/Y no fim do bloco lido
+            const uint8_t *giro = bruto + tamanho - TAM_LEITURA_GIRO;
+            gx = (int16_t)((giro[0] << 8) | giro[1]);
+            gy = (int16_t)((giro[2] << 8) | giro[3]);
+
+            // Converte para unidades físicas; o analisador de espectro recebe a taxa antes dos filtros
+            float taxa_roll  = (gx/65.0f)*(M_PI/180.0f);
+            float taxa_pitch = (gy/65.0f)*(M_PI/180.0f);
+            espectro_amostrar(taxa_pitch, taxa_roll, now);
+            identificacao_giro(gy, gx);
+
+            // Filtra (notch/passa-baixa configurados via MQTT)
+            float fs_hz = 1000.0f / energia_obter_perfil()->periodo_controle_ms;
+            for (int i = 0; i < NUM_EIXOS; i++) cadeia_sincronizar(&filtro_giro[i], FILTRO_GIRO, fs_hz);
+            taxa[EIXO_ROLL]  = cadeia_aplicar(&filtro_giro[EIXO_ROLL],  taxa_roll);
+            taxa[EIXO_PITCH] = cadeia_aplicar(&filtro_giro[EIXO_PITCH], taxa_pitch);
+
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            kalman.predict(taxa, dt);
+            ciclos_kalman += esp_cpu_get_cycle_count() - c0;
+
+            if (completa) {
+                ciclo_acel = 0;
+                ax = (int16_t)((bruto[0] << 8) | bruto[1]);
+                ay = (int16_t)((bruto[2] << 8) | bruto[3]);
+                az = (int16_t)((bruto[4] << 8) | bruto[5]);
+                temp_bruta = (int16_t)((bruto[6] << 8) | bruto[7]);
+
+                // Pitch (Eixo X do sensor, rotação sobre Y)
+                medido[EIXO_PITCH] = atan2((float)-ax, sqrt((float)ay*ay + (float)az*az));
+
+                // Roll (Eixo Y do sensor, rotação sobre X) 
+                medido[EIXO_ROLL] = atan2((float)ay, (float)az);
+
+                // Quanto |a| se afasta de 1 g (vibração, aceleração linear)
+                float norma_g = sqrtf((float)ax*ax + (float)ay*ay + (float)az*az) / ACEL_LSB_POR_G;
+                float desvio_g = fabsf(norma_g - 1.0f);
+
+                // Atualiza Filtros de Kalman
+                kalman.adaptativo = s_kalman_adaptativo;
+                c0 = esp_cpu_get_cycle_count();
+                kalman.update(medido, desvio_g);
+                ciclos_kalman += esp_cpu_get_cycle_count() - c0;
+            }
+        } else {
+            // Falha no barramento: mantém o prazo propagando com a última taxa do giroscópio
+            kalman.predict(taxa, dt);
+            leituras_perdidas++;
+        }
 
-        kalmanPitch.predict(gyr, dt);
-        kalmanPitch.update(acc_p);
+        // Bias x temperatura (1 Hz): o modelo antecipa a deriva e o Kalman só corrige o resto
+        if (now - ultima_temp_us >= TERMICO_PERIODO_US) {
+            ultima_temp_us = now;
+            float temp = calibracao_temperatura_c(temp_bruta);
+            float prev_ant, prev_atual;
+
+            if (termico_prever(TERMICO_PITCH, temp_anterior, &prev_ant) && termico_prever(TERMICO_PITCH, temp, &prev_atual)) {
+                kalman.bias[EIXO_PITCH] += prev_atual - prev_ant;
+            }
+            if (termico_prever(TERMICO_ROLL, temp_anterior, &prev_ant) && termico_prever(TERMICO_ROLL, temp, &prev_atual)) {
+                kalman.bias[EIXO_ROLL] += prev_atual - prev_ant;
+            }
+            temp_anterior = temp;
+
+            if (leituras_perdidas > 0) {
+                LOGW("MPU6050", "%lu leituras perdidas no último segundo", (unsigned long)leituras_perdidas);
+                leituras_perdidas = 0;
+            }
+            if (leituras > 0) {
+                ESP_LOGD("MPU6050", "Barramento: %lld us por ciclo (acelerômetro a cada %d), Kalman: %lu ciclos de CPU, fator R %.1f/%.1f",
+                         tempo_leitura_us / leituras, s_divisor_acel, (unsigned long)(ciclos_kalman / leituras),
+                         kalman.fator_r[EIXO_PITCH], kalman.fator_r[EIXO_ROLL]);
+                tempo_leitura_us = 0;
+                leituras = 0;
+                ciclos_kalman = 0;
+            }
+
+            // Só aprende com o gimbal quase parado (bias do Kalman confiável)
+            if (fabsf(taxa[EIXO_PITCH] - kalman.bias[EIXO_PITCH]) < TERMICO_TAXA_REPOUSO) {
+                termico_amostrar(TERMICO_PITCH, temp, kalman.bias[EIXO_PITCH]);
+            }
+            if (fabsf(taxa[EIXO_ROLL] - kalman.bias[EIXO_ROLL]) < TERMICO_TAXA_REPOUSO) {
+                termico_amostrar(TERMICO_ROLL, temp, kalman.bias[EIXO_ROLL]);
+            }
+            termico_persistir(now);
+        }
 
         // Atualiza variáveis globais de ângulo
         xSemaphoreTake(mutex_sensor_data, portMAX_DELAY);
-        pr_medido[0] = kalmanPitch.angle;
-        pr_medido[1] = kalmanRoll.angle;
+        pr_medido[0] = kalman.angle[EIXO_PITCH];
+        pr_medido[1] = kalman.angle[EIXO_ROLL];
         xSemaphoreGive(mutex_sensor_data);
 
+        // Perfil de energia define o período do loop e a taxa de telemetria
+        const energia_perfil_t *perfil = energia_obter_perfil();
+
+        // Taxa de telemetria pelo agendador (qualidade do enlace); fora do modo normal o
+        // divisor do perfil de energia é o piso
+        uint16_t divisor_telemetria = agendador_telemetria_divisor(perfil->periodo_controle_ms);
+        if (energia_obter_modo() != ENERGIA_NORMAL && divisor_telemetria < perfil->divisor_telemetria) {
+            divisor_telemetria = perfil->divisor_telemetria;
+        }
+
         // Envia o ângulo para a interface MQTT
         telemetry_counter++;
-        if (telemetry_counter >= 50) {  // 20Hz Telemetria
+        if (telemetry_counter >= divisor_telemetria) {  // 20Hz Telemetria em modo normal, até o agendador mudar
             telemetry_counter = 0;      // Reseta o contador
             // Envia o ângulo atual (em graus) para a fila de telemetria
 			// Envia os dados para o buffer circular de telemetria
-            float tel[2];
-            tel[0] = kalmanPitch.angle * 180/M_PI;
-            tel[1] = kalmanRoll.angle * 180/M_PI;
-            buffer_telemetria_gravar(tel, 0);            
+            telemetria_amostra_t tel;
+            tel.t_us  = now;    // Instante da leitura do sensor
+            tel.pitch = kalman.angle[EIXO_PITCH] * 180/M_PI;
+            tel.roll  = kalman.angle[EIXO_ROLL] * 180/M_PI;
+            buffer_telemetria_gravar(&tel, 0);            
         }
-		vTaskDelay(pdMS_TO_TICKS(1));
+		vTaskDelay(pdMS_TO_TICKS(perfil->periodo_controle_ms));
     }
-}
\ No newline at end of file
+}
+
+void mpu_definir_divisor_acel(int divisor) {
+    if (divisor < 1) divisor = 1;
+    if (divisor > DIVISOR_ACEL_MAX) divisor = DIVISOR_ACEL_MAX;
+    s_divisor_acel = (uint8_t)divisor;
+    LOGI("MPU6050", "Acelerômetro a cada %d ciclos", divisor);
+}
+
+void mpu_definir_kalman_adaptativo(bool ativo) {
+    s_kalman_adaptativo = ativo;
+    LOGI("MPU6050", "Kalman adaptativo %s", ativo ? "ligado" : "desligado");
+}
@@ -3,6 +3,8 @@
 #ifndef SENSORMPU6050_H
 #define SENSORMPU6050_H
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -18,6 +20,18 @@ void task_initI2C(void *ignore);
  */
 void task_mpu(void *);
 
+/**
+ * @brief Define a cada quantos ciclos o acelerômetro é lido e fundido.
+ * 1 = leitura completa (acelerômetro + giroscópio) em todo ciclo.
+ */
+void mpu_definir_divisor_acel(int divisor);
+
+/**
+ * @brief Liga/desliga o ajuste de R e Q do Kalman pela confiabilidade do acelerômetro.
+ * Desligado, o filtro usa os valores fixos.
+ */
+void mpu_definir_kalman_adaptativo(bool ativo);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,172 @@
+// --- Includes Padrão e de Biblioteca ---
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "esp_timer.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "MPU6050.h"
+#include "VelocidadeI2C.h"
+
+static const char *TAG = "I2C";
+
+// --- NVS ---
+#define VEL_NVS_NAMESPACE   "imu"
+#define VEL_NVS_CHAVE       "i2c_hz"
+
+// --- Caracterização ---
+// O datasheet do MPU6050 garante 400 kHz; acima disso depende da placa (pull-ups, fiação)
+static const uint32_t VELOCIDADES_HZ[] = {400000, 600000, 800000, 1000000};
+#define NUM_VELOCIDADES     (sizeof(VELOCIDADES_HZ) / sizeof(VELOCIDADES_HZ[0]))
+#define CICLOS_TESTE        1000    // Cada ciclo: WHO_AM_I + escrita/leitura de offset
+#define LEITURAS_LATENCIA   500     // Leituras de 14 bytes para medir a latência
+#define WHO_AM_I_ESPERADO   0x68
+#define TENTATIVAS_RESTAURAR 3
+
+static volatile bool s_pedido = false;
+
+// Pausa dos motores durante a caracterização pedida em operação (ver velocidade_i2c_parar_motores)
+static volatile bool s_parar_motores = false;
+static volatile bool s_motores_parados = false;
+
+// Transferências com erro em CICLOS_TESTE ciclos de verificação.
+// Escreve padrões no offset do giroscópio X: quem chama restaura o original em velocidade confiável.
+static uint32_t verificar_integridade(uint8_t dev) {
+    uint32_t erros = 0;
+    uint8_t padrao[2], lido[2];
+
+    for (uint32_t i = 0; i < CICLOS_TESTE; i++) {
+        uint8_t id = 0;
+        if (I2Cdev::readByte(dev, MPU6050_RA_WHO_AM_I, &id) == 0 || id != WHO_AM_I_ESPERADO) erros++;
+
+        // Alterna padrões com muitas transições de bit
+        padrao[0] = (i & 1) ? 0xA5 : 0x5A;
+        padrao[1] = (uint8_t)i;
+        if (!I2Cdev::writeBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, padrao) ||
+            I2Cdev::readBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, lido) == 0 ||
+            lido[0] != padrao[0] || lido[1] != padrao[1]) {
+            erros++;
+        }
+    }
+    return erros;
+}
+
+// Devolve o offset original na velocidade dada, conferindo por leitura
+static bool restaurar_offset(uint8_t dev, uint32_t hz, const uint8_t original[2]) {
+    I2Cdev::setSpeed(dev, hz);
+    for (int t = 0; t < TENTATIVAS_RESTAURAR; t++) {
+        uint8_t escrito[2] = { original[0], original[1] }, lido[2];
+        if (I2Cdev::writeBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, escrito) &&
+            I2Cdev::readBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, lido) == 2 &&
+            lido[0] == original[0] && lido[1] == original[1]) {
+            return true;
+        }
+    }
+    LOGE(TAG, "Offset do giroscópio X não restaurado a %lu kHz", (unsigned long)(hz / 1000));
+    return false;
+}
+
+// Tempo médio (us) de uma leitura de aceleração + temperatura + giroscópio
+static float medir_latencia(uint8_t dev) {
+    uint8_t bruto[14];
+    int64_t inicio = esp_timer_get_time();
+    for (int i = 0; i < LEITURAS_LATENCIA; i++) {
+        I2Cdev::readBytes(dev, MPU6050_RA_ACCEL_XOUT_H, sizeof(bruto), bruto);
+    }
+    return (esp_timer_get_time() - inicio) / (float)LEITURAS_LATENCIA;
+}
+
+static bool carregar(uint32_t *hz) {
+    nvs_handle_t nvs;
+    if (nvs_open(VEL_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+    esp_err_t err = nvs_get_u32(nvs, VEL_NVS_CHAVE, hz);
+    nvs_close(nvs);
+    return err == ESP_OK;
+}
+
+static void salvar(uint32_t hz) {
+    nvs_handle_t nvs;
+    if (nvs_open(VEL_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    esp_err_t err = nvs_set_u32(nvs, VEL_NVS_CHAVE, hz);
+    if (err == ESP_OK) err = nvs_commit(nvs);
+    nvs_close(nvs);
+    if (err != ESP_OK) ESP_LOGW(TAG, "Falha ao salvar velocidade: %s", esp_err_to_name(err));
+}
+
+uint32_t velocidade_i2c_caracterizar(void) {
+    const uint8_t dev = MPU6050_DEFAULT_ADDRESS;
+    uint32_t escolhida = VELOCIDADES_HZ[0];
+
+    // Offsets do giroscópio X como registrador de ida e volta, lidos na velocidade garantida
+    uint8_t original[2];
+    I2Cdev::setSpeed(dev, escolhida);
+    if (I2Cdev::readBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, original) != 2) {
+        LOGE(TAG, "Sem leitura a %lu kHz, caracterização cancelada", (unsigned long)(escolhida / 1000));
+        return escolhida;
+    }
+
+    for (size_t v = 0; v < NUM_VELOCIDADES; v++) {
+        I2Cdev::setSpeed(dev, VELOCIDADES_HZ[v]);
+        uint32_t erros = verificar_integridade(dev);
+        float latencia = medir_latencia(dev);
+
+        // Restaura antes de decidir, na última velocidade sem erros (esta, se passou)
+        if (!restaurar_offset(dev, erros ? escolhida : VELOCIDADES_HZ[v], original)) erros++;
+
+        LOGI(TAG, "%lu kHz: %lu erros em %d ciclos, leitura de 14 bytes em %.0f us",
+             (unsigned long)(VELOCIDADES_HZ[v] / 1000), (unsigned long)erros, CICLOS_TESTE, latencia);
+
+        // Para na primeira velocidade com erro: as acima dela teriam ainda menos margem
+        if (erros > 0) break;
+        escolhida = VELOCIDADES_HZ[v];
+    }
+
+    I2Cdev::setSpeed(dev, escolhida);
+    salvar(escolhida);
+    LOGI(TAG, "Barramento em %lu kHz", (unsigned long)(escolhida / 1000));
+    return escolhida;
+}
+
+uint32_t velocidade_i2c_iniciar(void) {
+    uint32_t hz;
+    if (carregar(&hz)) {
+        I2Cdev::setSpeed(MPU6050_DEFAULT_ADDRESS, hz);
+        LOGI(TAG, "Barramento em %lu kHz (NVS)", (unsigned long)(hz / 1000));
+        return hz;
+    }
+    return velocidade_i2c_caracterizar();
+}
+
+void velocidade_i2c_solicitar(void) {
+    s_pedido = true;
+    LOGI(TAG, "Caracterização do barramento solicitada");
+}
+
+bool velocidade_i2c_pendente(void) {
+    if (!s_pedido) return false;
+    s_pedido = false;
+    return true;
+}
+
+bool velocidade_i2c_parar_motores(uint32_t espera_ms) {
+    s_motores_parados = false;
+    s_parar_motores = true;
+    for (uint32_t t = 0; t < espera_ms && !s_motores_parados; t++) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return s_motores_parados;
+}
+
+void velocidade_i2c_liberar_motores(void) {
+    s_parar_motores = false;
+    s_motores_parados = false;
+}
+
+bool velocidade_i2c_motores_bloqueados(void) {
+    return s_parar_motores;
+}
+
+void velocidade_i2c_confirmar_parada(void) {
+    s_motores_parados = true;
+}
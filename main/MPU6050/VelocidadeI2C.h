@@ -0,0 +1,63 @@
+// main/MPU6050/VelocidadeI2C.h
+
+#ifndef VELOCIDADEI2C_H
+#define VELOCIDADEI2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pede uma nova caracterização do barramento ao task_mpu (ex.: comando MQTT).
+ */
+void velocidade_i2c_solicitar(void);
+
+/**
+ * @brief Aplica a velocidade salva na NVS; sem velocidade salva, caracteriza o barramento.
+ * @return Velocidade em uso (Hz).
+ */
+uint32_t velocidade_i2c_iniciar(void);
+
+/**
+ * @brief Sobe o clock de 400 kHz a 1 MHz conferindo a integridade das leituras
+ * e salva a maior velocidade sem erros. O offset do giroscópio X usado no teste é
+ * restaurado (e conferido) na última velocidade sem erros.
+ * Bloqueia o task_mpu por alguns segundos: em operação, pare os motores antes.
+ * @return Velocidade escolhida (Hz).
+ */
+uint32_t velocidade_i2c_caracterizar(void);
+
+/**
+ * @brief Consome um pedido de caracterização pendente.
+ */
+bool velocidade_i2c_pendente(void);
+
+/**
+ * @brief Pede à task_pid que desligue os drivers (o ângulo medido para durante a caracterização).
+ * @return false se a task_pid não confirmou em espera_ms.
+ */
+bool velocidade_i2c_parar_motores(uint32_t espera_ms);
+
+/**
+ * @brief Libera os motores; a task_pid religa e recomeça a rampa de onde o gimbal está.
+ */
+void velocidade_i2c_liberar_motores(void);
+
+/**
+ * @brief true enquanto os motores devem ficar desligados (task_pid, a cada ciclo).
+ */
+bool velocidade_i2c_motores_bloqueados(void);
+
+/**
+ * @brief Confirmação da task_pid de que os drivers estão desligados.
+ */
+void velocidade_i2c_confirmar_parada(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VELOCIDADEI2C_H
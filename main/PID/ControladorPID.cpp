@@ -9,8 +9,20 @@
 
 // --- Includes das Bibliotecas C++ SimpleFOC ---
 #include "esp_simplefoc.h"
+#include "esp_timer.h"
+#include "esp_system.h"
 #include "ControladorPID.h"
+#include "pid.h"
 #include "mainGlobals.h"
+#include "adc_bateria.h"
+#include "gerenciador_energia.h"
+#include "sequencia_init.h"
+#include "filtros.h"
+#include "identificacao.h"
+#include "setpoint.h"
+#include "stream_setpoint.h"
+#include "roteiro.h"
+#include "VelocidadeI2C.h"
 
 // --- Definições ---
 #define IN1_1 19
@@ -25,9 +37,25 @@
 const float deadzone = 0.005;
 const float MAX_ANGLE = 1.46608f;
 
-#define MAX_INTEGRADOR 30.0f
-#define MIN_INTEGRADOR -30.0f
-#define D_FILTER_ALPHA 0.2f
+// --- Compensação da tensão de alimentação ---
+#define VBAT_NOMINAL_V          8.4f    // Sem leitura da bateria: 2S cheia, nunca sobreexcita
+#define VBAT_MIN_VALIDA_V       5.0f    // Abaixo disso a leitura é considerada inválida
+#define VBAT_SNAPSHOT_MAX_US    2000000 // Leitura mais velha que 2s é ignorada
+#define COMPENSACAO_CICLOS      50      // Atualiza a compensação a cada 50 ciclos
+
+// --- Estacionamento (modo de energia crítico) ---
+#define VELOCIDADE_RAMPA        1.0f    // rad/s (0.001 rad/ms)
+#define VELOCIDADE_RAMPA_MIN    0.01f   // rad/s (limites para "vel"/"tempo" pedidos via MQTT)
+#define VELOCIDADE_RAMPA_MAX    4.0f    // rad/s
+#define LATENCIA_LOG_US         10000000 // Relatório da latência comando -> setpoint a cada 10s
+#define ESTACIONAR_PITCH_RAD    0.0f
+#define ESTACIONAR_ROLL_RAD     0.0f
+#define ESTACIONAR_TOLERANCIA   0.05f   // rad
+#define ESTACIONAR_TIMEOUT_US   3000000 // Desliga mesmo sem chegar na posição
+
+// --- Detecção de estabilização (relatório de inicialização) ---
+#define ESTABILIZADO_TOLERANCIA 0.02f   // rad (~1.1 grau)
+#define ESTABILIZADO_CICLOS     200     // Ciclos seguidos dentro da tolerância
 
 // Variáveis Globais
 static BLDCMotor motor_pitch = BLDCMotor(7);
@@ -35,59 +63,45 @@ static BLDCDriver3PWM driver_pitch = BLDCDriver3PWM(IN1_1, IN2_1, IN3_1, EN1);
 static BLDCMotor motor_roll = BLDCMotor(7);
 static BLDCDriver3PWM driver_roll = BLDCDriver3PWM(IN1_2, IN2_2, IN3_2, EN2);
 
-// Estrutura PID
-typedef struct {
-    float kp, ki, kd;
-    float integrador;
-    float medicao_anterior;
-    float derivada_filtrada;
-} PID_t;
-
-// Inicializa o controlador PID
-void PID_Init(PID_t *pid, float kp, float ki, float kd) {
-    pid->kp = kp;
-    pid->ki = ki;
-    pid->kd = kd;
-    pid->integrador = 0.0f;
-    pid->medicao_anterior = 0.0f;
-    pid->derivada_filtrada = 0.0f;
-}
+// Ajusta drivers e motores à tensão medida da bateria (o ganho do laço fica constante
+// porque o Uq aplicado não muda; ver pid_tensoes_para_vbat)
+static void aplicar_compensacao_tensao(void) {
+    bateria_snapshot_t bat;
+    float vbat = VBAT_NOMINAL_V;
 
-// Calcula a saída do controlador PID
-float PID_Compute(PID_t *pid, float erro, float medicao, float dt) {
-    if (dt <= 0.0f) return 0.0f;
-
-    // P
-    float P = pid->kp * erro;
+    if (bateria_obter_snapshot(&bat)
+        && (esp_timer_get_time() - bat.timestamp_us) < VBAT_SNAPSHOT_MAX_US
+        && bat.tensao_v > VBAT_MIN_VALIDA_V) {
+        vbat = bat.tensao_v;
+    }
 
-    // I
-    pid->integrador += erro * dt;
-    if (pid->integrador > MAX_INTEGRADOR) pid->integrador = MAX_INTEGRADOR;
-    else if (pid->integrador < MIN_INTEGRADOR) pid->integrador = MIN_INTEGRADOR;
-    float I = pid->ki * pid->integrador;
+    // Inclui a redução intencional do gerenciador de energia
+    tensoes_motor_t t;
+    pid_tensoes_para_vbat(vbat, energia_obter_perfil()->fator_vlimit, &t);
 
-    // D
-    float derivada_raw = -(medicao - pid->medicao_anterior) / dt;
-    pid->derivada_filtrada = (D_FILTER_ALPHA * derivada_raw) + (1.0f - D_FILTER_ALPHA) * pid->derivada_filtrada;
-    float D = pid->kd * pid->derivada_filtrada;
+    driver_pitch.voltage_power_supply = t.voltage_power_supply;
+    driver_roll.voltage_power_supply  = t.voltage_power_supply;
+    driver_pitch.voltage_limit = t.driver_vlimit;
+    driver_roll.voltage_limit  = t.driver_vlimit;
+    motor_pitch.voltage_limit = t.motor_vlimit;
+    motor_roll.voltage_limit  = t.motor_vlimit;
+}
 
-    pid->medicao_anterior = medicao;
-    return P + I + D;
+// Velocidade da rampa (rad/s) até o novo alvo: pelo tempo pedido, pela velocidade pedida ou a padrão
+static float velocidade_rampa(const setpoint_t *sp, float distancia_rad) {
+    float v = VELOCIDADE_RAMPA;
+    if (sp->tempo_s > 0.0f) v = fabsf(distancia_rad) / sp->tempo_s;
+    else if (sp->velocidade > 0.0f) v = sp->velocidade * M_PI / 180.0f;
+    return fmaxf(VELOCIDADE_RAMPA_MIN, fminf(VELOCIDADE_RAMPA_MAX, v));
 }
 
 // --- Tarefa Principal ---
 void task_pid(void *ignore) {
-    xSemaphoreTake(g_mpu_pronta, portMAX_DELAY);
-    // Espera um pouco para o sensor estabilizar totalmente
-    vTaskDelay(pdMS_TO_TICKS(500)); 
-
+    // Drivers e motores são configurados em paralelo com a calibração do sensor
     LOGI("PID", "Configurando Motores...");
     
-    // Configuração do driver BLDC
-    driver_pitch.voltage_power_supply = 12;
-    driver_roll.voltage_power_supply = 12;
-    driver_pitch.voltage_limit = 11;
-    driver_roll.voltage_limit = 11;
+    // Configuração do driver BLDC (tensões da leitura da bateria, se já houver)
+    aplicar_compensacao_tensao();
     driver_pitch.init(0);
     driver_roll.init(1);
 
@@ -96,8 +110,6 @@ void task_pid(void *ignore) {
     motor_roll.linkDriver(&driver_roll);
     motor_pitch.velocity_limit = 20;
     motor_roll.velocity_limit = 20;
-    motor_pitch.voltage_limit = 3;
-    motor_roll.voltage_limit = 3;
     motor_pitch.current_limit = 0.5f;
     motor_roll.current_limit = 0.5f;
 
@@ -106,22 +118,52 @@ void task_pid(void *ignore) {
     motor_roll.controller = MotionControlType::velocity_openloop;
     motor_pitch.init();
     motor_roll.init();
+    init_marcar(INIT_MOTORES_PRONTOS);
+
+    // O loop precisa dos filtros já inicializados
+    init_aguardar(INIT_CALIBRADO, portMAX_DELAY);
 
     // Inicialização do PID
     PID_t pid_pitch, pid_roll;
     PID_Init(&pid_pitch, 8.0f, 0.01f, 1.0f);
     PID_Init(&pid_roll,  8.0f, 0.01f, 1.2f);
+    aplicar_compensacao_tensao();
+    int contador_compensacao = 0;
 
-    const float dt = 0.001f;     // 1ms de tempo fixo para o PID
+    // Período do PID segue o perfil de energia (1ms em operação normal)
+    uint8_t periodo_ms = energia_obter_perfil()->periodo_controle_ms;
+    float dt = periodo_ms / 1000.0f;
     float erro_pitch, erro_roll;
     float setpoint_pitch, setpoint_roll;
+    float alvo_pitch = 0.0f, alvo_roll = 0.0f;  // Último setpoint recebido (rad)
     float medicao_pitch_rad, medicao_roll_rad;
 
     // Variáveis da Rampa
     static float setpoint_suave_pitch = 0.0f;
     static float setpoint_suave_roll = 0.0f;
     // Diminuí a velocidade da rampa para garantir torque (0.001 rad/ms = 1 rad/s)
-    float max_step = 0.001f; 
+    // Cada comando pode pedir outra velocidade ou um tempo até o alvo
+    float vel_rampa_pitch = VELOCIDADE_RAMPA, vel_rampa_roll = VELOCIDADE_RAMPA;
+
+    // Caixa de setpoint e latência comando -> task_pid
+    setpoint_t sp;
+    uint32_t versao_sp = 0;
+    int64_t latencia_soma_us = 0, latencia_max_us = 0;
+    uint32_t latencia_n = 0;
+    int64_t ultimo_log_latencia = esp_timer_get_time();
+    uint32_t heap_inicio_janela = esp_get_free_heap_size();
+
+    // Estado do estacionamento
+    bool motores_ligados = true;
+    int64_t inicio_estacionamento = 0;
+
+    // Contagem para sinalizar a primeira estabilização
+    int ciclos_estavel = 0;
+
+    // Filtros da saída (notch/passa-baixa configurados via MQTT)
+    cadeia_filtros_t filtro_saida_pitch, filtro_saida_roll;
+    cadeia_iniciar(&filtro_saida_pitch);
+    cadeia_iniciar(&filtro_saida_roll);
 
     // Lê onde o gimbal está AGORA para começar a rampa dali
     xSemaphoreTake(mutex_sensor_data, portMAX_DELAY);
@@ -133,25 +175,89 @@ void task_pid(void *ignore) {
     pid_roll.medicao_anterior  = pr_medido[1];
     xSemaphoreGive(mutex_sensor_data);
 
-    const TickType_t xFrequency = pdMS_TO_TICKS(1); // 1ms
+    TickType_t xFrequency = pdMS_TO_TICKS(periodo_ms);
     TickType_t xLastWakeTime = xTaskGetTickCount();
 
     LOGI("PID", "Iniciando loop de cálculo PID...");
     
     while (1) {
-        // 1. ESPERA ATÉ O PRÓXIMO CICLO DE 1ms
+        // 1. ESPERA ATÉ O PRÓXIMO CICLO (1ms em operação normal)
         vTaskDelayUntil(&xLastWakeTime, xFrequency);
+
+        // Acompanha o perfil do gerenciador de energia
+        const energia_perfil_t *perfil = energia_obter_perfil();
+        if (perfil->periodo_controle_ms != periodo_ms) {
+            periodo_ms = perfil->periodo_controle_ms;
+            xFrequency = pdMS_TO_TICKS(periodo_ms);
+            dt = periodo_ms / 1000.0f;
+        }
+
+        // Acompanha a tensão da bateria (leitura não bloqueante)
+        if (++contador_compensacao >= COMPENSACAO_CICLOS) {
+            contador_compensacao = 0;
+            aplicar_compensacao_tensao();
+        }
         
-        // 2. PEGA O SETPOINT ATUALIZADO
-		xSemaphoreTake(mutex_pr, portMAX_DELAY);
-		setpoint_pitch = pr[0] * M_PI / 180.0f;	// Converte para radianos
-		setpoint_roll = pr[1] * M_PI / 180.0f;	// Converte para radianos
-		xSemaphoreGive(mutex_pr);
+        // 2. PEGA O SETPOINT ATUALIZADO (sem bloquear; só muda quando chega comando novo)
+        if (setpoint_ler(&sp, &versao_sp)) {
+            stream_encerrar();  // Setpoint absoluto tem prioridade sobre o streaming e o roteiro
+            roteiro_parar();
+            alvo_pitch = sp.pitch * M_PI / 180.0f;	// Converte para radianos
+            alvo_roll  = sp.roll * M_PI / 180.0f;	// Converte para radianos
+
+            // 3. APLICA LIMITE DE SEGURANÇA
+            // Aplica um limite de segurança ao setpoint para evitar Gimbal Lock
+            alvo_pitch = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, alvo_pitch)); // Limita Pitch
+            alvo_roll  = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, alvo_roll));  // Limita Roll
 
-        // 3. APLICA LIMITE DE SEGURANÇA
-        // Aplica um limite de segurança ao setpoint para evitar Gimbal Lock
-        setpoint_pitch = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, setpoint_pitch)); // Limita Pitch
-        setpoint_roll = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, setpoint_roll)); // Limita Roll
+            vel_rampa_pitch = velocidade_rampa(&sp, alvo_pitch - setpoint_suave_pitch);
+            vel_rampa_roll  = velocidade_rampa(&sp, alvo_roll - setpoint_suave_roll);
+
+            if (sp.id) setpoint_confirmar(&sp, esp_timer_get_time());  // Atua neste ciclo
+            if (sp.recebido_us) {
+                int64_t latencia = esp_timer_get_time() - sp.recebido_us;
+                latencia_soma_us += latencia;
+                if (latencia > latencia_max_us) latencia_max_us = latencia;
+                latencia_n++;
+            }
+        }
+
+        // Streaming: setpoint interpolado a cada ciclo; a rampa fica só como limite de segurança
+        float stream_pitch, stream_roll;
+        if (stream_amostrar(esp_timer_get_time(), &stream_pitch, &stream_roll)) {
+            alvo_pitch = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, stream_pitch * (float)M_PI / 180.0f));
+            alvo_roll  = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, stream_roll * (float)M_PI / 180.0f));
+            vel_rampa_pitch = vel_rampa_roll = VELOCIDADE_RAMPA_MAX;
+            roteiro_parar();
+        }
+
+        // Roteiro no próprio ESP32: a trajetória já vem suavizada, sem depender da rede
+        float atual_graus[2] = { alvo_pitch * 180.0f / (float)M_PI, alvo_roll * 180.0f / (float)M_PI };
+        float roteiro_pitch, roteiro_roll;
+        if (roteiro_passo(dt, atual_graus, &roteiro_pitch, &roteiro_roll)) {
+            alvo_pitch = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, roteiro_pitch * (float)M_PI / 180.0f));
+            alvo_roll  = fmaxf(-MAX_ANGLE, fminf(MAX_ANGLE, roteiro_roll * (float)M_PI / 180.0f));
+            vel_rampa_pitch = vel_rampa_roll = VELOCIDADE_RAMPA_MAX;
+        }
+        setpoint_pitch = alvo_pitch;
+        setpoint_roll  = alvo_roll;
+
+        if (latencia_n && esp_timer_get_time() - ultimo_log_latencia > LATENCIA_LOG_US) {
+            setpoint_estatisticas_t estat;
+            setpoint_obter_estatisticas(&estat);
+            // Heap no início e no fim da janela: com o parser sem alocação, uma rajada de setpoints
+            // não deve mexer no heap. Só no serial (o LOGI pelo MQTT alocaria no meio da medida).
+            uint32_t heap_agora = esp_get_free_heap_size();
+            ESP_LOGI("PID", "Setpoint: %lu comandos, latência média %lld us, máx %lld us (%lu descartados); "
+                     "heap livre %lu -> %lu B, mínimo %lu B",
+                     (unsigned long)latencia_n, latencia_soma_us / latencia_n, latencia_max_us,
+                     (unsigned long)estat.descartados, (unsigned long)heap_inicio_janela,
+                     (unsigned long)heap_agora, (unsigned long)esp_get_minimum_free_heap_size());
+            heap_inicio_janela = heap_agora;
+            latencia_soma_us = latencia_max_us = 0;
+            latencia_n = 0;
+            ultimo_log_latencia = esp_timer_get_time();
+        }
 
         // 4. PEGA A ÚLTIMA MEDIÇÃO DO SENSOR
         xSemaphoreTake(mutex_sensor_data, portMAX_DELAY);
@@ -159,19 +265,70 @@ void task_pid(void *ignore) {
         medicao_roll_rad  = pr_medido[1]; // Já está em radianos
         xSemaphoreGive(mutex_sensor_data);
 
-        // 5. RAMPA SUAVE
+        // Caracterização do I2C: o ângulo para de ser atualizado, então desliga sem estacionar
+        if (velocidade_i2c_motores_bloqueados()) {
+            if (motores_ligados) {
+                motor_pitch.disable();
+                motor_roll.disable();
+                motores_ligados = false;
+                LOGW("PID", "Drivers desligados durante a caracterização do I2C.");
+            }
+            velocidade_i2c_confirmar_parada();
+            continue;
+        }
+
+        // Bateria crítica: leva à posição de descanso e desliga os drivers
+        if (!perfil->motores_ativos) {
+            setpoint_pitch = ESTACIONAR_PITCH_RAD;
+            setpoint_roll  = ESTACIONAR_ROLL_RAD;
+
+            if (motores_ligados) {
+                int64_t agora = esp_timer_get_time();
+                if (inicio_estacionamento == 0) inicio_estacionamento = agora;
+
+                bool estacionado = fabsf(medicao_pitch_rad - ESTACIONAR_PITCH_RAD) < ESTACIONAR_TOLERANCIA
+                                && fabsf(medicao_roll_rad - ESTACIONAR_ROLL_RAD) < ESTACIONAR_TOLERANCIA;
+                if (estacionado || (agora - inicio_estacionamento) > ESTACIONAR_TIMEOUT_US) {
+                    motor_pitch.disable();
+                    motor_roll.disable();
+                    motores_ligados = false;
+                    LOGW("PID", "Gimbal estacionado, drivers desligados.");
+                }
+            }
+            if (!motores_ligados) continue;
+        } else if (!motores_ligados) {
+            // Saiu do modo crítico: religa e recomeça a rampa de onde o gimbal está
+            motor_pitch.enable();
+            motor_roll.enable();
+            motores_ligados = true;
+            inicio_estacionamento = 0;
+            setpoint_suave_pitch = medicao_pitch_rad;
+            setpoint_suave_roll  = medicao_roll_rad;
+            pid_pitch.integrador = 0.0f;
+            pid_roll.integrador  = 0.0f;
+            pid_pitch.medicao_anterior = medicao_pitch_rad;
+            pid_roll.medicao_anterior  = medicao_roll_rad;
+            LOGI("PID", "Drivers religados.");
+        } else {
+            inicio_estacionamento = 0;
+        }
+
+        // 5. RAMPA SUAVE (estacionamento sempre na velocidade padrão)
+        float passo_p = (perfil->motores_ativos ? vel_rampa_pitch : VELOCIDADE_RAMPA) * dt;
+        float passo_r = (perfil->motores_ativos ? vel_rampa_roll  : VELOCIDADE_RAMPA) * dt;
+
         float diferenca_p = setpoint_pitch - setpoint_suave_pitch;
-        if (fabs(diferenca_p) > max_step) {
-            if (diferenca_p > 0) setpoint_suave_pitch += max_step;
-            else setpoint_suave_pitch -= max_step;
+        if (fabs(diferenca_p) > passo_p) {
+            if (diferenca_p > 0) setpoint_suave_pitch += passo_p;
+            else setpoint_suave_pitch -= passo_p;
         } else {
             setpoint_suave_pitch = setpoint_pitch;
         }
 
         float diferenca_r = setpoint_roll - setpoint_suave_roll;
-        if (fabs(diferenca_r) > max_step) {
-            if (diferenca_r > 0) setpoint_suave_roll += max_step;
-            else setpoint_suave_roll -= max_step;
+        if (fabs(diferenca_r) > passo_r) {
+            if (diferenca_r > 0) setpoint_suave_roll += passo_r;
+            else setpoint_suave_roll -= passo_r;
         } else {
             setpoint_suave_roll = setpoint_roll;
         }
@@ -180,14 +337,32 @@ void task_pid(void *ignore) {
         erro_pitch = setpoint_suave_pitch - medicao_pitch_rad;  // Erro de Pitch em radianos
         erro_roll  = setpoint_suave_roll  - medicao_roll_rad;   // Erro de Roll em radianos
 
+        // Primeira vez parado no setpoint: fim da inicialização
+        if (ciclos_estavel < ESTABILIZADO_CICLOS) {
+            bool estavel = setpoint_suave_pitch == setpoint_pitch && setpoint_suave_roll == setpoint_roll
+                        && fabsf(erro_pitch) < ESTABILIZADO_TOLERANCIA && fabsf(erro_roll) < ESTABILIZADO_TOLERANCIA;
+            ciclos_estavel = estavel ? ciclos_estavel + 1 : 0;
+            if (ciclos_estavel == ESTABILIZADO_CICLOS) init_marcar(INIT_ESTABILIZADO);
+        }
+
         // 7. APLICA DEADZONE
         if (fabsf(erro_pitch) < deadzone) erro_pitch = 0.0f;
         if (fabsf(erro_roll) < deadzone) erro_roll = 0.0f;
 
-        // 8. CALCULA O PID COM O 'dt' FIXO
+        // 8. CALCULA O PID COM O 'dt' DO PERFIL
         float output_pitch = PID_Compute(&pid_pitch, erro_pitch, medicao_pitch_rad, dt);
         float output_roll  = PID_Compute(&pid_roll,  erro_roll, medicao_roll_rad, dt);
 
+        // Remove ressonâncias da saída antes dos motores
+        cadeia_sincronizar(&filtro_saida_pitch, FILTRO_SAIDA, 1000.0f / periodo_ms);
+        cadeia_sincronizar(&filtro_saida_roll,  FILTRO_SAIDA, 1000.0f / periodo_ms);
+        output_pitch = cadeia_aplicar(&filtro_saida_pitch, output_pitch);
+        output_roll  = cadeia_aplicar(&filtro_saida_roll,  output_roll);
+
+        // Excitação da identificação de planta (só no eixo pedido, enquanto grava)
+        output_pitch = identificacao_aplicar(IDENT_PITCH, output_pitch, 1000.0f / periodo_ms);
+        output_roll  = identificacao_aplicar(IDENT_ROLL,  output_roll,  1000.0f / periodo_ms);
+
         // 9. ATUALIZA A SAÍDA PARA O MOTOR
         motor_pitch.move(-output_pitch);
         motor_roll.move(output_roll);
@@ -0,0 +1,54 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <math.h>
+
+// --- Includes do Projeto ---
+#include "pid.h"
+
+#define MAX_INTEGRADOR 30.0f
+#define MIN_INTEGRADOR -30.0f
+#define D_FILTER_ALPHA 0.2f
+
+#define DRIVER_VLIMIT_MARGEM    0.92f   // Fração da alimentação liberada para o driver
+
+// Inicializa o controlador PID
+void PID_Init(PID_t *pid, float kp, float ki, float kd) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->integrador = 0.0f;
+    pid->medicao_anterior = 0.0f;
+    pid->derivada_filtrada = 0.0f;
+}
+
+// Calcula a saída do controlador PID
+float PID_Compute(PID_t *pid, float erro, float medicao, float dt) {
+    if (dt <= 0.0f) return 0.0f;
+
+    // P
+    float P = pid->kp * erro;
+
+    // I
+    pid->integrador += erro * dt;
+    if (pid->integrador > MAX_INTEGRADOR) pid->integrador = MAX_INTEGRADOR;
+    else if (pid->integrador < MIN_INTEGRADOR) pid->integrador = MIN_INTEGRADOR;
+    float I = pid->ki * pid->integrador;
+
+    // D
+    float derivada_raw = -(medicao - pid->medicao_anterior) / dt;
+    pid->derivada_filtrada = (D_FILTER_ALPHA * derivada_raw) + (1.0f - D_FILTER_ALPHA) * pid->derivada_filtrada;
+    float D = pid->kd * pid->derivada_filtrada;
+
+    pid->medicao_anterior = medicao;
+    return P + I + D;
+}
+
+void pid_tensoes_para_vbat(float vbat, float fator_vlimit, tensoes_motor_t *saida) {
+    float driver_vlimit = fminf(DRIVER_VLIMIT_MAX, vbat * DRIVER_VLIMIT_MARGEM);
+
+    // SinePWM centra as fases em driver_vlimit / 2: acima disso o Uq seria cortado
+    float motor_vlimit = fminf(MOTOR_VLIMIT_NOMINAL, driver_vlimit * 0.5f);
+
+    saida->voltage_power_supply = vbat;
+    saida->driver_vlimit = driver_vlimit;
+    saida->motor_vlimit = motor_vlimit * fator_vlimit;
+}
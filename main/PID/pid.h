@@ -0,0 +1,50 @@
+// main/PID/pid.h
+
+#ifndef PID_H
+#define PID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Limites de tensão dos motores ---
+#define DRIVER_VLIMIT_MAX       11.0f   // Limite de tensão do driver com bateria cheia
+#define MOTOR_VLIMIT_NOMINAL    3.0f    // Tensão (Uq) desejada nos motores
+
+// Estrutura PID
+typedef struct {
+    float kp, ki, kd;
+    float integrador;
+    float medicao_anterior;
+    float derivada_filtrada;
+} PID_t;
+
+// Tensões aplicadas ao driver e ao motor (SimpleFOC) para uma alimentação
+typedef struct {
+    float voltage_power_supply;     // Tensão real: o driver divide por ela para achar o duty cycle
+    float driver_vlimit;
+    float motor_vlimit;             // Uq
+} tensoes_motor_t;
+
+/**
+ * @brief Inicializa o controlador PID.
+ */
+void PID_Init(PID_t *pid, float kp, float ki, float kd);
+
+/**
+ * @brief Calcula a saída do controlador PID (velocidade pedida ao motor, rad/s).
+ */
+float PID_Compute(PID_t *pid, float erro, float medicao, float dt);
+
+/**
+ * @brief Tensões do driver e do motor para a bateria medida.
+ * Com voltage_power_supply igual à tensão real, o Uq aplicado não muda com a descarga.
+ * @param fator_vlimit Redução intencional do gerenciador de energia (1.0 = nominal).
+ */
+void pid_tensoes_para_vbat(float vbat, float fator_vlimit, tensoes_motor_t *saida);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PID_H
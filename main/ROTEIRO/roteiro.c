@@ -0,0 +1,227 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "nvs.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "roteiro.h"
+
+// --- Tag de Log ---
+static const char *TAG = "ROTEIRO";
+
+// --- NVS ---
+#define ROTEIRO_NVS_NAMESPACE   "roteiro"
+#define ROTEIRO_NVS_CHAVE       "pontos"
+#define ROTEIRO_MAGIC           0x524F5445  // "ROTE"
+#define ROTEIRO_VERSAO          1
+
+#define ANGULO_MAX_CGRAUS       8400        // MAX_ANGLE do PID (~84 graus)
+
+// Formato salvo (só os n primeiros pontos vão para a NVS)
+typedef struct {
+    uint32_t magic;
+    uint16_t versao;
+    uint16_t n;
+    uint16_t repeticoes;
+    roteiro_ponto_t pontos[ROTEIRO_MAX_PONTOS];
+} roteiro_salvo_t;
+
+static const char *s_nomes_estado[] = { "parado", "executando", "concluido" };
+
+// Roteiro e execução (MQTT carrega/inicia/para, task_pid executa; protegidos por s_mux)
+static roteiro_salvo_t s_roteiro;
+static volatile roteiro_estado_t s_estado = ROTEIRO_PARADO;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static int s_indice;
+static uint16_t s_volta;
+static bool s_comecar;          // Primeiro passo pega a origem do setpoint atual
+static bool s_esperando;        // Chegou ao ponto, contando a espera
+static float s_t;               // Tempo na fase atual (s), somado pelos dt do controle
+static float s_duracao;         // Duração do movimento atual (s)
+static float s_origem[2], s_destino[2];
+static bool s_progresso_mudou;
+
+static bool pontos_validos(const roteiro_ponto_t *pontos, int n) {
+    if (n <= 0 || n > ROTEIRO_MAX_PONTOS) return false;
+    for (int i = 0; i < n; i++) {
+        const roteiro_ponto_t *p = &pontos[i];
+        if (abs(p->pitch_cgraus) > ANGULO_MAX_CGRAUS || abs(p->roll_cgraus) > ANGULO_MAX_CGRAUS) return false;
+        if (p->suavizacao >= SUAVIZACAO_NUM || (p->flags & ~ROTEIRO_FLAG_VELOCIDADE)) return false;
+    }
+    return true;
+}
+
+void roteiro_iniciar_modulo(void) {
+    nvs_handle_t nvs;
+    if (nvs_open(ROTEIRO_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+
+    roteiro_salvo_t salvo;
+    size_t tamanho = sizeof(salvo);
+    esp_err_t err = nvs_get_blob(nvs, ROTEIRO_NVS_CHAVE, &salvo, &tamanho);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || tamanho < offsetof(roteiro_salvo_t, pontos)) return;
+    if (salvo.magic != ROTEIRO_MAGIC || salvo.versao != ROTEIRO_VERSAO
+        || tamanho != offsetof(roteiro_salvo_t, pontos) + salvo.n * sizeof(roteiro_ponto_t)
+        || !pontos_validos(salvo.pontos, salvo.n)) {
+        ESP_LOGW(TAG, "Roteiro salvo inválido, ignorando.");
+        return;
+    }
+
+    s_roteiro = salvo;
+    LOGI(TAG, "Roteiro carregado da NVS: %d pontos, %d repetições", salvo.n, salvo.repeticoes);
+}
+
+bool roteiro_carregar(const roteiro_ponto_t *pontos, int n, uint16_t repeticoes) {
+    if (!pontos_validos(pontos, n)) {
+        LOGW(TAG, "Roteiro inválido (%d pontos).", n);
+        return false;
+    }
+
+    portENTER_CRITICAL(&s_mux);
+    s_estado = ROTEIRO_PARADO;
+    s_roteiro.magic = ROTEIRO_MAGIC;
+    s_roteiro.versao = ROTEIRO_VERSAO;
+    s_roteiro.n = (uint16_t)n;
+    s_roteiro.repeticoes = repeticoes;
+    memcpy(s_roteiro.pontos, pontos, n * sizeof(roteiro_ponto_t));
+    s_progresso_mudou = true;
+    portEXIT_CRITICAL(&s_mux);
+
+    // Só o MQTT escreve s_roteiro, então a cópia fora da seção crítica é consistente
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(ROTEIRO_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, ROTEIRO_NVS_CHAVE, &s_roteiro,
+                           offsetof(roteiro_salvo_t, pontos) + n * sizeof(roteiro_ponto_t));
+        if (err == ESP_OK) err = nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) ESP_LOGW(TAG, "Falha ao salvar roteiro: %s", esp_err_to_name(err));
+
+    LOGI(TAG, "Roteiro recebido: %d pontos, %d repetições", n, repeticoes);
+    return true;
+}
+
+bool roteiro_iniciar(void) {
+    portENTER_CRITICAL(&s_mux);
+    bool ok = s_roteiro.n > 0;
+    if (ok) {
+        s_indice = 0;
+        s_volta = 0;
+        s_comecar = true;
+        s_estado = ROTEIRO_EXECUTANDO;
+        s_progresso_mudou = true;
+    }
+    portEXIT_CRITICAL(&s_mux);
+
+    if (ok) LOGI(TAG, "Roteiro iniciado.");
+    else LOGW(TAG, "Nenhum roteiro carregado.");
+    return ok;
+}
+
+void roteiro_parar(void) {
+    if (s_estado != ROTEIRO_EXECUTANDO) return;
+
+    portENTER_CRITICAL(&s_mux);
+    s_estado = ROTEIRO_PARADO;
+    s_progresso_mudou = true;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+static float suavizar(uint8_t tipo, float s) {
+    switch (tipo) {
+    case SUAVIZACAO_SUAVE:       return s * s * (3.0f - 2.0f * s);
+    case SUAVIZACAO_COSSENO:     return 0.5f - 0.5f * cosf((float)M_PI * s);
+    case SUAVIZACAO_MINIMO_JERK: return s * s * s * (10.0f + s * (-15.0f + 6.0f * s));
+    default:                     return s;
+    }
+}
+
+// Prepara o movimento até s_pontos[s_indice] partindo de origem (graus)
+static void iniciar_segmento(const float origem[2]) {
+    const roteiro_ponto_t *p = &s_roteiro.pontos[s_indice];
+    s_origem[0] = origem[0];
+    s_origem[1] = origem[1];
+    s_destino[0] = p->pitch_cgraus / 100.0f;
+    s_destino[1] = p->roll_cgraus / 100.0f;
+
+    if (p->flags & ROTEIRO_FLAG_VELOCIDADE) {
+        float distancia = fmaxf(fabsf(s_destino[0] - s_origem[0]), fabsf(s_destino[1] - s_origem[1]));
+        float velocidade = p->movimento / 10.0f;
+        s_duracao = (velocidade > 0.0f) ? distancia / velocidade : 0.0f;
+    } else {
+        s_duracao = p->movimento / 1000.0f;
+    }
+    s_t = 0.0f;
+    s_esperando = false;
+}
+
+bool roteiro_passo(float dt, const float atual_graus[2], float *pitch_graus, float *roll_graus) {
+    if (s_estado != ROTEIRO_EXECUTANDO) return false;
+
+    portENTER_CRITICAL(&s_mux);
+    if (s_estado != ROTEIRO_EXECUTANDO) {
+        portEXIT_CRITICAL(&s_mux);
+        return false;
+    }
+    if (s_comecar) {
+        s_comecar = false;
+        iniciar_segmento(atual_graus);
+    }
+
+    const roteiro_ponto_t *p = &s_roteiro.pontos[s_indice];
+    s_t += dt;
+    if (!s_esperando && s_t >= s_duracao) {
+        s_esperando = true;
+        s_t = 0.0f;
+    }
+
+    if (!s_esperando) {
+        float e = suavizar(p->suavizacao, s_t / s_duracao);
+        *pitch_graus = s_origem[0] + e * (s_destino[0] - s_origem[0]);
+        *roll_graus  = s_origem[1] + e * (s_destino[1] - s_origem[1]);
+    } else {
+        *pitch_graus = s_destino[0];
+        *roll_graus  = s_destino[1];
+
+        if (s_t >= p->espera_ms / 1000.0f) {
+            // Próximo ponto; no fim, nova volta ou conclui parado no último ponto
+            if (++s_indice >= s_roteiro.n) {
+                s_volta++;
+                s_indice = 0;
+                if (s_roteiro.repeticoes && s_volta >= s_roteiro.repeticoes) {
+                    s_indice = s_roteiro.n - 1;
+                    s_estado = ROTEIRO_CONCLUIDO;
+                }
+            }
+            if (s_estado == ROTEIRO_EXECUTANDO) iniciar_segmento(s_destino);
+            s_progresso_mudou = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+bool roteiro_progresso_novo(roteiro_progresso_t *saida) {
+    if (!s_progresso_mudou) return false;
+
+    portENTER_CRITICAL(&s_mux);
+    saida->estado = s_estado;
+    saida->ponto = (uint8_t)s_indice;
+    saida->n_pontos = (uint8_t)s_roteiro.n;
+    saida->volta = s_volta;
+    saida->repeticoes = s_roteiro.repeticoes;
+    s_progresso_mudou = false;
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+const char *roteiro_nome_estado(roteiro_estado_t estado) {
+    return (estado <= ROTEIRO_CONCLUIDO) ? s_nomes_estado[estado] : "?";
+}
@@ -0,0 +1,93 @@
+// main/ROTEIRO/roteiro.h
+
+#ifndef ROTEIRO_H
+#define ROTEIRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROTEIRO_MAX_PONTOS      64
+
+// Curva de cada movimento entre pontos
+typedef enum {
+    SUAVIZACAO_LINEAR = 0,
+    SUAVIZACAO_SUAVE,       // 3s² - 2s³
+    SUAVIZACAO_COSSENO,     // (1 - cos(πs)) / 2
+    SUAVIZACAO_MINIMO_JERK, // 10s³ - 15s⁴ + 6s⁵
+    SUAVIZACAO_NUM
+} roteiro_suavizacao_t;
+
+#define ROTEIRO_FLAG_VELOCIDADE (1 << 0)    // "movimento" é velocidade (0,1 °/s) em vez de duração (ms)
+
+// Ponto compilado (formato do MQTT e da NVS): [pitch, roll, movimento, espera, suavizacao, flags]
+typedef struct {
+    int16_t pitch_cgraus;   // Centésimos de grau
+    int16_t roll_cgraus;
+    uint16_t movimento;     // ms até o ponto, ou 0,1 °/s com ROTEIRO_FLAG_VELOCIDADE
+    uint16_t espera_ms;     // Parado no ponto antes do próximo
+    uint8_t suavizacao;     // roteiro_suavizacao_t
+    uint8_t flags;
+} roteiro_ponto_t;
+
+typedef enum {
+    ROTEIRO_PARADO = 0,
+    ROTEIRO_EXECUTANDO,
+    ROTEIRO_CONCLUIDO
+} roteiro_estado_t;
+
+// Progresso publicado em gimbal/roteiro
+typedef struct {
+    roteiro_estado_t estado;
+    uint8_t ponto;          // Ponto atual (destino do movimento)
+    uint8_t n_pontos;
+    uint16_t volta;         // Voltas completas
+    uint16_t repeticoes;    // 0 = infinito
+} roteiro_progresso_t;
+
+/**
+ * @brief Carrega o roteiro salvo na NVS (sem iniciar). Chamar no app_main após a NVS.
+ */
+void roteiro_iniciar_modulo(void);
+
+/**
+ * @brief Substitui o roteiro (para o atual) e salva na NVS (chamada pelo MQTT).
+ * @return false se os pontos forem inválidos.
+ */
+bool roteiro_carregar(const roteiro_ponto_t *pontos, int n, uint16_t repeticoes);
+
+/**
+ * @brief Começa do primeiro ponto, partindo do setpoint atual.
+ */
+bool roteiro_iniciar(void);
+
+/**
+ * @brief Interrompe o roteiro; o setpoint fica onde estava.
+ */
+void roteiro_parar(void);
+
+/**
+ * @brief Avança o roteiro em dt (task_pid, a cada ciclo). Sem rede nem bloqueio.
+ * @param atual_graus Setpoint atual [pitch, roll], origem do primeiro movimento.
+ * @return false se o roteiro não está executando.
+ */
+bool roteiro_passo(float dt, const float atual_graus[2], float *pitch_graus, float *roll_graus);
+
+/**
+ * @brief Copia o progresso se mudou desde a última chamada (task de telemetria).
+ */
+bool roteiro_progresso_novo(roteiro_progresso_t *saida);
+
+/**
+ * @brief Nome do estado, usado no MQTT.
+ */
+const char *roteiro_nome_estado(roteiro_estado_t estado);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROTEIRO_H
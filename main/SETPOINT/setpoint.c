@@ -0,0 +1,90 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+
+// --- Includes do Projeto ---
+#include "setpoint.h"
+
+#define SEQ_JANELA      1024    // Recuo maior que isso é um remetente reiniciado, não mensagem atrasada
+
+// Seqlock: contador ímpar durante a escrita; o leitor (task_pid) repete se pegou uma escrita no meio
+static setpoint_t s_setpoint;
+static atomic_uint s_versao;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Protegidos por s_mux
+static uint32_t s_ultimo_seq;
+static bool s_seq_valido = false;
+static setpoint_estatisticas_t s_estat;
+static setpoint_confirmacao_t s_confirmacao;
+static bool s_confirmacao_pendente = false;
+
+bool setpoint_publicar(const setpoint_t *sp, bool tem_seq) {
+    portENTER_CRITICAL(&s_mux);
+    if (tem_seq) {
+        int32_t avanco = (int32_t)(sp->seq - s_ultimo_seq);
+        if (s_seq_valido && avanco <= 0 && avanco > -SEQ_JANELA) {
+            s_estat.descartados++;
+            portEXIT_CRITICAL(&s_mux);
+            return false;
+        }
+        s_ultimo_seq = sp->seq;
+        s_seq_valido = true;
+    }
+
+    unsigned int v = atomic_load_explicit(&s_versao, memory_order_relaxed);
+    atomic_store_explicit(&s_versao, v + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s_setpoint = *sp;
+    atomic_store_explicit(&s_versao, v + 2, memory_order_release);
+
+    s_estat.publicados++;
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+bool setpoint_ler(setpoint_t *sp, uint32_t *versao) {
+    unsigned int v1, v2;
+    do {
+        v1 = atomic_load_explicit(&s_versao, memory_order_acquire);
+        if (v1 & 1) continue;
+        *sp = s_setpoint;
+        atomic_thread_fence(memory_order_acquire);
+        v2 = atomic_load_explicit(&s_versao, memory_order_relaxed);
+        if (v1 == v2) break;
+    } while (1);
+
+    bool mudou = (v1 != *versao);
+    *versao = v1;
+    return mudou;
+}
+
+void setpoint_obter_estatisticas(setpoint_estatisticas_t *saida) {
+    portENTER_CRITICAL(&s_mux);
+    *saida = s_estat;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void setpoint_confirmar(const setpoint_t *sp, int64_t atuacao_us) {
+    portENTER_CRITICAL(&s_mux);
+    s_confirmacao.id = sp->id;
+    s_confirmacao.th_ms = sp->th_ms;
+    s_confirmacao.recebido_us = sp->recebido_us;
+    s_confirmacao.atuacao_us = atuacao_us;
+    s_confirmacao_pendente = true;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+bool setpoint_confirmacao_pendente(setpoint_confirmacao_t *saida) {
+    if (!s_confirmacao_pendente) return false;
+
+    portENTER_CRITICAL(&s_mux);
+    *saida = s_confirmacao;
+    s_confirmacao_pendente = false;
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+bool setpoint_ha_confirmacao(void) {
+    return s_confirmacao_pendente;
+}
@@ -0,0 +1,80 @@
+// main/SETPOINT/setpoint.h
+
+#ifndef SETPOINT_H
+#define SETPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Setpoint absoluto recebido (MQTT, botão)
+typedef struct {
+    float pitch;            // Graus
+    float roll;             // Graus
+    float velocidade;       // Graus/s da rampa até o alvo (0 = velocidade padrão)
+    float tempo_s;          // Tempo para chegar ao alvo (0 = usa a velocidade); tem prioridade sobre ela
+    uint32_t seq;           // Número de sequência do remetente (ver setpoint_publicar)
+    uint32_t t_ms;          // Relógio do remetente (só no modo streaming, ver stream_setpoint.h)
+    uint32_t id;            // Id do comando para confirmação na telemetria (0 = sem confirmação)
+    uint32_t th_ms;         // Relógio do remetente no envio, devolvido na confirmação
+    int64_t recebido_us;    // Instante da chegada (esp_timer), para medir a latência até a task_pid
+} setpoint_t;
+
+// Contadores da caixa de setpoint
+typedef struct {
+    uint32_t publicados;
+    uint32_t descartados;   // Sequência antiga (mensagem fora de ordem ou repetida)
+} setpoint_estatisticas_t;
+
+/**
+ * @brief Escreve um novo setpoint sem bloquear (seqlock; escritores serializados por spinlock curto).
+ * @param tem_seq Se true, descarta setpoints com sequência mais antiga que a última aceita.
+ * @return false se o setpoint foi descartado.
+ */
+bool setpoint_publicar(const setpoint_t *sp, bool tem_seq);
+
+/**
+ * @brief Lê o setpoint atual sem bloquear.
+ * @param versao Versão da última leitura; atualizada na saída.
+ * @return true se o setpoint mudou desde essa versão.
+ */
+bool setpoint_ler(setpoint_t *sp, uint32_t *versao);
+
+/**
+ * @brief Copia os contadores.
+ */
+void setpoint_obter_estatisticas(setpoint_estatisticas_t *saida);
+
+// Confirmação de comando: ecoada na telemetria para medir RTT e latência comando -> motores
+typedef struct {
+    uint32_t id;
+    uint32_t th_ms;         // Relógio do remetente, como veio no comando
+    int64_t recebido_us;    // Chegada no ESP32 (esp_timer)
+    int64_t atuacao_us;     // Primeiro ciclo de controle com o novo setpoint
+} setpoint_confirmacao_t;
+
+/**
+ * @brief Registra a confirmação (task_pid, no ciclo que aplica o setpoint). Sobrescreve a
+ * anterior se ela ainda não foi publicada.
+ */
+void setpoint_confirmar(const setpoint_t *sp, int64_t atuacao_us);
+
+/**
+ * @brief Retira a confirmação pendente (task de telemetria).
+ * @return false se não há confirmação nova.
+ */
+bool setpoint_confirmacao_pendente(setpoint_confirmacao_t *saida);
+
+/**
+ * @brief true se há confirmação esperando, sem retirá-la.
+ */
+bool setpoint_ha_confirmacao(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SETPOINT_H
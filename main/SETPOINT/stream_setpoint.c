@@ -0,0 +1,137 @@
+// --- Includes Padrão e de Biblioteca ---
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "stream_setpoint.h"
+
+// --- Tag de Log ---
+static const char *TAG = "STREAM";
+
+#define STREAM_CAPACIDADE       16          // Amostras no buffer (potência de 2; 160 ms a 100 Hz)
+#define STREAM_MASCARA          (STREAM_CAPACIDADE - 1)
+#define STREAM_ATRASO_PADRAO_MS 60          // Cobre o jitter típico do Wi-Fi + broker
+#define STREAM_ATRASO_MAX_MS    150         // Tem que caber no buffer
+#define STREAM_TIMEOUT_US       300000      // Sem amostras por 300 ms: mantém a posição
+#define STREAM_DERIVA_US        1           // Subida do offset por amostra (segue deriva do relógio e mudança de rota)
+#define SEQ_JANELA              1024        // Recuo maior que isso é um remetente reiniciado
+
+typedef struct {
+    int64_t t_us;           // Relógio do remetente
+    float pitch, roll;
+} amostra_t;
+
+// Escritos pelo MQTT e lidos pela task_pid, protegidos por s_mux
+static amostra_t s_buf[STREAM_CAPACIDADE];
+static uint32_t s_ini, s_fim;               // Índices livres (quantidade = s_fim - s_ini)
+static volatile bool s_ativo = false;
+static uint32_t s_ultimo_seq;
+static int64_t s_offset_us;                 // Local - remetente, pelo menor atraso visto
+static int64_t s_ultima_chegada_us;
+static int64_t s_atraso_us = STREAM_ATRASO_PADRAO_MS * 1000;
+static bool s_em_lacuna;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Contadores do streaming atual (relatados no fim)
+static uint32_t s_recebidas, s_fora_de_ordem, s_atrasadas, s_lacunas;
+
+static void reiniciar(const setpoint_t *sp, int64_t t_us) {
+    s_ini = s_fim = 0;
+    s_offset_us = sp->recebido_us - t_us;
+    s_em_lacuna = false;
+    s_recebidas = s_fora_de_ordem = s_atrasadas = s_lacunas = 0;
+    s_ativo = true;
+}
+
+void stream_inserir(const setpoint_t *sp) {
+    int64_t t_us = (int64_t)sp->t_ms * 1000;
+    bool iniciou = false;
+
+    portENTER_CRITICAL(&s_mux);
+    int32_t avanco = (int32_t)(sp->seq - s_ultimo_seq);
+    if (!s_ativo || avanco <= -SEQ_JANELA) {
+        reiniciar(sp, t_us);
+        iniciou = true;
+    } else if (avanco <= 0 || t_us <= s_buf[(s_fim - 1) & STREAM_MASCARA].t_us) {
+        s_fora_de_ordem++;
+        portEXIT_CRITICAL(&s_mux);
+        return;
+    }
+
+    // Offset pelo menor atraso de chegada: o jitter só atrasa, nunca adianta
+    int64_t candidato = sp->recebido_us - t_us;
+    if (candidato < s_offset_us + STREAM_DERIVA_US) s_offset_us = candidato;
+    else s_offset_us += STREAM_DERIVA_US;
+
+    // Chegou depois de o ponto de reprodução passar por ela
+    if (t_us + s_offset_us + s_atraso_us < sp->recebido_us) s_atrasadas++;
+
+    if (s_fim - s_ini == STREAM_CAPACIDADE) s_ini++;
+    amostra_t *a = &s_buf[s_fim & STREAM_MASCARA];
+    a->t_us = t_us;
+    a->pitch = sp->pitch;
+    a->roll = sp->roll;
+    s_fim++;
+
+    s_ultimo_seq = sp->seq;
+    s_ultima_chegada_us = sp->recebido_us;
+    s_recebidas++;
+    portEXIT_CRITICAL(&s_mux);
+
+    if (iniciou) LOGI(TAG, "Streaming de setpoint iniciado (atraso %lld ms)", s_atraso_us / 1000);
+}
+
+bool stream_amostrar(int64_t agora_us, float *pitch, float *roll) {
+    if (!s_ativo) return false;
+
+    portENTER_CRITICAL(&s_mux);
+    if (agora_us - s_ultima_chegada_us > STREAM_TIMEOUT_US) {
+        s_ativo = false;
+        uint32_t recebidas = s_recebidas, fora = s_fora_de_ordem, atrasadas = s_atrasadas, lacunas = s_lacunas;
+        portEXIT_CRITICAL(&s_mux);
+        ESP_LOGI(TAG, "Streaming parado, mantendo posição (%lu amostras, %lu fora de ordem, %lu atrasadas, %lu lacunas)",
+                 (unsigned long)recebidas, (unsigned long)fora, (unsigned long)atrasadas, (unsigned long)lacunas);
+        return false;
+    }
+
+    // Instante de reprodução no relógio do remetente; descarta as amostras que já passaram
+    int64_t t = agora_us - s_offset_us - s_atraso_us;
+    while (s_fim - s_ini >= 2 && s_buf[(s_ini + 1) & STREAM_MASCARA].t_us <= t) s_ini++;
+
+    const amostra_t *a = &s_buf[s_ini & STREAM_MASCARA];
+    if (s_fim - s_ini >= 2 && t > a->t_us) {
+        const amostra_t *b = &s_buf[(s_ini + 1) & STREAM_MASCARA];
+        float frac = (float)(t - a->t_us) / (float)(b->t_us - a->t_us);
+        *pitch = a->pitch + frac * (b->pitch - a->pitch);
+        *roll  = a->roll + frac * (b->roll - a->roll);
+        s_em_lacuna = false;
+    } else {
+        // Antes da primeira amostra ou além da última (buffer esvaziou): segura o valor
+        *pitch = a->pitch;
+        *roll  = a->roll;
+        if (t > a->t_us && !s_em_lacuna) {
+            s_em_lacuna = true;
+            s_lacunas++;
+        }
+    }
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+void stream_encerrar(void) {
+    portENTER_CRITICAL(&s_mux);
+    s_ativo = false;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void stream_definir_atraso(int atraso_ms) {
+    if (atraso_ms < 0) atraso_ms = 0;
+    if (atraso_ms > STREAM_ATRASO_MAX_MS) atraso_ms = STREAM_ATRASO_MAX_MS;
+
+    portENTER_CRITICAL(&s_mux);
+    s_atraso_us = (int64_t)atraso_ms * 1000;
+    portEXIT_CRITICAL(&s_mux);
+    LOGI(TAG, "Atraso do streaming: %d ms", atraso_ms);
+}
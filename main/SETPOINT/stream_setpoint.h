@@ -0,0 +1,43 @@
+// main/SETPOINT/stream_setpoint.h
+
+#ifndef STREAM_SETPOINT_H
+#define STREAM_SETPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "setpoint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Modo streaming: amostras {"pitch","roll","seq","t"} a até ~100 Hz ficam num buffer de jitter
+// e são reproduzidas com um atraso fixo, interpoladas na taxa de controle.
+
+/**
+ * @brief Insere uma amostra recebida (MQTT). A primeira amostra inicia o streaming.
+ */
+void stream_inserir(const setpoint_t *sp);
+
+/**
+ * @brief Setpoint interpolado para o instante atual (task_pid, a cada ciclo).
+ * @return false se não há streaming ativo; após o timeout o streaming termina e o
+ * último setpoint reproduzido fica valendo (mantém a posição).
+ */
+bool stream_amostrar(int64_t agora_us, float *pitch, float *roll);
+
+/**
+ * @brief Termina o streaming (um setpoint absoluto chegou).
+ */
+void stream_encerrar(void);
+
+/**
+ * @brief Atraso de reprodução (profundidade do buffer de jitter), recebido via MQTT.
+ */
+void stream_definir_atraso(int atraso_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STREAM_SETPOINT_H
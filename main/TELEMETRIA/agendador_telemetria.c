@@ -0,0 +1,165 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "agendador_telemetria.h"
+
+// --- Tag de Log ---
+static const char *TAG = "AGENDA_TEL";
+
+#define JANELA_US               1000000     // Reavalia a cada 1 s
+#define LATENCIA_MAX_MS         150         // Acima disso o enlace está congestionado
+#define LATENCIA_BOA_MS         50          // Abaixo disso (por JANELAS_PARA_SUBIR janelas) pode subir
+#define JANELAS_PARA_SUBIR      3
+#define RSSI_FRACO              -80         // Limita a taxa ao nível padrão
+#define RSSI_BOM                -75
+#define RAJADA_HZ               200
+#define RAJADA_MAX_S            30.0f
+
+// Níveis de taxa; começa no antigo fixo de 20 Hz
+static const uint16_t s_niveis_hz[] = { 1, 2, 5, 10, 20, 50, 100 };
+#define NUM_NIVEIS      (sizeof(s_niveis_hz) / sizeof(s_niveis_hz[0]))
+#define NIVEL_PADRAO    4
+
+// Lidos pela task_mpu a cada ciclo (escrita atômica de 16 bits / bool)
+static volatile uint16_t s_taxa_hz = 20;
+static volatile bool s_minimo = false;
+static volatile uint16_t s_taxa_fixa = 0;  // Telemetria por UDP: a taxa é a pedida pelo PC
+
+// Contadores da janela (task de telemetria; envio e avaliação rodam na mesma task)
+static uint32_t s_bytes_janela;
+static uint32_t s_falhas_janela;
+static int64_t s_idade_max_janela_us;
+static uint32_t s_outbox_anterior;
+static int64_t s_inicio_janela_us;
+
+// Controle
+static int s_nivel = NIVEL_PADRAO;
+static int s_janelas_boas;
+static volatile int64_t s_rajada_ate_us;
+
+// Estado exposto (s_mux)
+static agendador_estado_t s_estado = { .taxa_hz = 20 };
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void agendador_telemetria_registrar_envio(size_t bytes, bool ok, int64_t idade_us) {
+    if (ok) {
+        s_bytes_janela += (uint32_t)bytes;
+    } else {
+        s_falhas_janela++;
+    }
+    if (idade_us > s_idade_max_janela_us) s_idade_max_janela_us = idade_us;
+
+    portENTER_CRITICAL(&s_mux);
+    if (ok) s_estado.enviadas++;
+    else s_estado.falhas++;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+bool agendador_telemetria_atualizar(int64_t agora_us, uint32_t outbox_bytes, int8_t rssi) {
+    if (s_inicio_janela_us == 0) s_inicio_janela_us = agora_us;
+    if (agora_us - s_inicio_janela_us < JANELA_US) return false;
+
+    // Vazão de saída = o que entrou na fila menos o quanto ela cresceu; latência = fila / vazão
+    float janela_s = (agora_us - s_inicio_janela_us) / 1e6f;
+    int32_t crescimento = (int32_t)outbox_bytes - (int32_t)s_outbox_anterior;
+    float vazao = ((float)s_bytes_janela - crescimento) / janela_s;
+    uint32_t latencia_ms = 0;
+    if (outbox_bytes > 0) {
+        latencia_ms = (vazao > 1.0f) ? (uint32_t)(outbox_bytes * 1000.0f / vazao) : UINT32_MAX;
+    }
+    uint32_t idade_ms = (uint32_t)(s_idade_max_janela_us / 1000);
+
+    // Fila já encolhendo (depois de uma redução) não é motivo para reduzir de novo
+    bool congestionado = (latencia_ms > LATENCIA_MAX_MS && crescimento > 0)
+                         || idade_ms > LATENCIA_MAX_MS || s_falhas_janela > 0;
+    bool folgado = latencia_ms < LATENCIA_BOA_MS && idade_ms < LATENCIA_BOA_MS
+                   && (rssi == 0 || rssi > RSSI_BOM);
+    int nivel_max = (rssi != 0 && rssi < RSSI_FRACO) ? NIVEL_PADRAO : (int)NUM_NIVEIS - 1;
+    bool rajada = s_rajada_ate_us > agora_us;
+
+    int nivel_antes = s_nivel;
+    bool minimo_antes = s_minimo;
+    if (congestionado) {
+        // Primeiro enxuga o conteúdo, depois reduz a taxa
+        s_janelas_boas = 0;
+        if (rajada) {
+            s_rajada_ate_us = 0;
+            rajada = false;
+            LOGW(TAG, "Rajada encerrada: enlace congestionado (%lu ms na fila)", (unsigned long)latencia_ms);
+        } else if (!s_minimo) {
+            s_minimo = true;
+        } else if (s_nivel > 0) {
+            s_nivel--;
+        }
+    } else if (folgado && !rajada && ++s_janelas_boas >= JANELAS_PARA_SUBIR) {
+        s_janelas_boas = 0;
+        if (s_minimo) s_minimo = false;
+        else if (s_nivel < nivel_max) s_nivel++;
+    } else if (!folgado) {
+        s_janelas_boas = 0;
+    }
+    if (s_nivel > nivel_max) s_nivel = nivel_max;
+
+    s_taxa_hz = rajada ? RAJADA_HZ : s_niveis_hz[s_nivel];
+    if (s_nivel != nivel_antes || s_minimo != minimo_antes) {
+        ESP_LOGI(TAG, "Telemetria %u Hz, %s (fila %lu B, %lu ms; idade %lu ms; RSSI %d)",
+                 s_niveis_hz[s_nivel], s_minimo ? "mínima" : "completa", (unsigned long)outbox_bytes,
+                 (unsigned long)latencia_ms, (unsigned long)idade_ms, rssi);
+    }
+
+    portENTER_CRITICAL(&s_mux);
+    s_estado.taxa_hz = s_taxa_fixa ? s_taxa_fixa : s_taxa_hz;
+    s_estado.minimo = s_minimo && !rajada;
+    s_estado.rajada = rajada;
+    s_estado.outbox_bytes = outbox_bytes;
+    s_estado.outbox_crescimento = crescimento;
+    s_estado.latencia_ms = latencia_ms;
+    s_estado.idade_max_ms = idade_ms;
+    s_estado.rssi = rssi;
+    portEXIT_CRITICAL(&s_mux);
+
+    s_bytes_janela = 0;
+    s_falhas_janela = 0;
+    s_idade_max_janela_us = 0;
+    s_outbox_anterior = outbox_bytes;
+    s_inicio_janela_us = agora_us;
+    return true;
+}
+
+uint16_t agendador_telemetria_divisor(uint8_t periodo_ms) {
+    uint16_t taxa = s_taxa_fixa ? s_taxa_fixa : s_taxa_hz;
+    if (taxa == 0 || periodo_ms == 0) return 1;
+    uint32_t divisor = (uint32_t)lroundf(1000.0f / ((float)periodo_ms * taxa));
+    return divisor < 1 ? 1 : (divisor > UINT16_MAX ? UINT16_MAX : (uint16_t)divisor);
+}
+
+bool agendador_telemetria_minimo(void) {
+    return s_minimo && s_rajada_ate_us <= esp_timer_get_time();
+}
+
+void agendador_telemetria_rajada(float duracao_s) {
+    if (duracao_s > RAJADA_MAX_S) duracao_s = RAJADA_MAX_S;
+    if (duracao_s > 0.0f) {
+        s_rajada_ate_us = esp_timer_get_time() + (int64_t)(duracao_s * 1e6f);
+        s_taxa_hz = RAJADA_HZ;
+        LOGI(TAG, "Rajada de telemetria: %d Hz por %.1f s", RAJADA_HZ, duracao_s);
+    } else {
+        s_rajada_ate_us = 0;
+        s_taxa_hz = s_niveis_hz[s_nivel];
+    }
+}
+
+void agendador_telemetria_taxa_fixa(uint16_t taxa_hz) {
+    s_taxa_fixa = taxa_hz;
+}
+
+void agendador_telemetria_obter_estado(agendador_estado_t *saida) {
+    portENTER_CRITICAL(&s_mux);
+    *saida = s_estado;
+    portEXIT_CRITICAL(&s_mux);
+}
@@ -0,0 +1,74 @@
+// main/TELEMETRIA/agendador_telemetria.h
+
+#ifndef AGENDADOR_TELEMETRIA_H
+#define AGENDADOR_TELEMETRIA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Taxa e conteúdo da telemetria ajustados pela qualidade do enlace (fila de saída do MQTT,
+// latência estimada da fila, idade das amostras e RSSI), com rajada sob demanda.
+
+// Estado publicado em gimbal/tel_estado
+typedef struct {
+    uint16_t taxa_hz;           // Taxa pedida à task_mpu
+    bool minimo;                // Só pitch/roll/t_us, com 2 casas e sem passar pelo cJSON
+    bool rajada;
+    uint32_t outbox_bytes;      // Fila de saída do cliente MQTT
+    int32_t outbox_crescimento; // Variação da fila na última janela (bytes)
+    uint32_t latencia_ms;       // Tempo estimado para esvaziar a fila
+    uint32_t idade_max_ms;      // Maior idade de amostra ao enfileirar, na última janela
+    int8_t rssi;
+    uint32_t enviadas;          // Totais desde o boot
+    uint32_t falhas;            // Fila cheia (descartadas pelo cliente MQTT)
+    uint32_t descartes_buffer;  // Buffer de telemetria cheio (preenchido por quem publica)
+} agendador_estado_t;
+
+/**
+ * @brief Registra uma telemetria enfileirada no MQTT (ok = false se a fila recusou).
+ * @param idade_us Tempo desde a medição da amostra.
+ */
+void agendador_telemetria_registrar_envio(size_t bytes, bool ok, int64_t idade_us);
+
+/**
+ * @brief Reavalia taxa e conteúdo (task de telemetria; age uma vez por janela de 1 s).
+ * @param rssi 0 se desconhecido.
+ * @return true se uma janela foi avaliada (hora de publicar o estado, se quiser).
+ */
+bool agendador_telemetria_atualizar(int64_t agora_us, uint32_t outbox_bytes, int8_t rssi);
+
+/**
+ * @brief Ciclos da task_mpu entre envios para a taxa atual.
+ */
+uint16_t agendador_telemetria_divisor(uint8_t periodo_ms);
+
+/**
+ * @brief true se a telemetria deve levar só os campos mínimos.
+ */
+bool agendador_telemetria_minimo(void);
+
+/**
+ * @brief Taxa máxima e conteúdo completo por um tempo (pedido da GUI); 0 encerra.
+ */
+void agendador_telemetria_rajada(float duracao_s);
+
+/**
+ * @brief Fixa a taxa (telemetria por UDP, fora do MQTT); 0 volta ao controle pelo enlace.
+ */
+void agendador_telemetria_taxa_fixa(uint16_t taxa_hz);
+
+/**
+ * @brief Copia o estado atual.
+ */
+void agendador_telemetria_obter_estado(agendador_estado_t *saida);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AGENDADOR_TELEMETRIA_H
@@ -0,0 +1,147 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "codec_telemetria.h"
+
+// --- Tag de Log ---
+static const char *TAG = "CODEC_TEL";
+
+#define RESOLUCAO_PADRAO_MGRAUS 10      // 0,01°
+#define KEYFRAME_PADRAO         50      // Um keyframe a cada 50 amostras (2,5 s a 20 Hz)
+#define LOTE_MAX_MS_PADRAO      100     // Latência máxima acrescentada pelo lote
+
+typedef struct {
+    bool ativo;
+    uint16_t resolucao_mgraus;
+    uint8_t keyframe;
+    uint16_t lote_max_ms;
+} codec_config_t;
+
+// Configuração pedida pelo MQTT; a task de telemetria aplica no início de cada lote
+static codec_config_t s_pedida = { false, RESOLUCAO_PADRAO_MGRAUS, KEYFRAME_PADRAO, LOTE_MAX_MS_PADRAO };
+static bool s_config_nova = false;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Estado do codificador (só a task de telemetria)
+static codec_config_t s_cfg = { false, RESOLUCAO_PADRAO_MGRAUS, KEYFRAME_PADRAO, LOTE_MAX_MS_PADRAO };
+static uint32_t s_contador;         // Índice da próxima amostra
+static uint32_t s_contador_lote;    // Índice da primeira amostra do lote aberto
+static bool s_forcar_keyframe = true;
+static bool s_flags_lote;
+static int64_t s_t_anterior, s_dt_anterior;
+static int32_t s_q_anterior[2];
+static int64_t s_inicio_lote_us;
+static uint8_t s_n;
+static uint8_t s_corpo[CODEC_LOTE_MAX_BYTES];
+static size_t s_tam_corpo;
+static uint8_t s_saida[CODEC_LOTE_MAX_BYTES];
+
+static size_t escrever_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+void codec_telemetria_configurar(bool ativo, float resolucao_graus, int keyframe, int lote_max_ms) {
+    int mgraus = (int)lroundf(resolucao_graus * 1000.0f);
+    if (mgraus < 1) mgraus = 1;
+    if (mgraus > UINT16_MAX) mgraus = UINT16_MAX;
+    if (keyframe < 1) keyframe = 1;
+    if (keyframe > UINT8_MAX) keyframe = UINT8_MAX;
+    if (lote_max_ms < 0) lote_max_ms = 0;
+    if (lote_max_ms > 1000) lote_max_ms = 1000;
+
+    portENTER_CRITICAL(&s_mux);
+    s_pedida.ativo = ativo;
+    s_pedida.resolucao_mgraus = (uint16_t)mgraus;
+    s_pedida.keyframe = (uint8_t)keyframe;
+    s_pedida.lote_max_ms = (uint16_t)lote_max_ms;
+    s_config_nova = true;
+    portEXIT_CRITICAL(&s_mux);
+
+    LOGI(TAG, "Telemetria %s (resolução %.3f°, keyframe a cada %d, lote até %d ms)",
+         ativo ? "binária" : "JSON", mgraus / 1000.0f, keyframe, lote_max_ms);
+}
+
+bool codec_telemetria_ativo(void) {
+    // Configuração nova só entre lotes; a primeira amostra depois dela vira keyframe
+    if (s_config_nova && s_n == 0) {
+        portENTER_CRITICAL(&s_mux);
+        s_cfg = s_pedida;
+        s_config_nova = false;
+        portEXIT_CRITICAL(&s_mux);
+        s_forcar_keyframe = true;
+    }
+    return s_cfg.ativo || s_n > 0;
+}
+
+bool codec_telemetria_adicionar(const telemetria_amostra_t *a) {
+    if (s_n == 0) {
+        s_contador_lote = s_contador;
+        s_flags_lote = s_forcar_keyframe;
+        s_inicio_lote_us = a->t_us;
+        s_tam_corpo = 0;
+    }
+
+    float res = s_cfg.resolucao_mgraus / 1000.0f;
+    int32_t q[2] = { (int32_t)lroundf(a->pitch / res), (int32_t)lroundf(a->roll / res) };
+    uint8_t *p = &s_corpo[s_tam_corpo];
+
+    if (s_forcar_keyframe || s_contador % s_cfg.keyframe == 0) {
+        p += escrever_varint(p, (uint64_t)a->t_us);
+        p += escrever_varint(p, zigzag(q[0]));
+        p += escrever_varint(p, zigzag(q[1]));
+        s_dt_anterior = 0;
+        s_forcar_keyframe = false;
+    } else {
+        int64_t dt = a->t_us - s_t_anterior;
+        p += escrever_varint(p, zigzag(dt - s_dt_anterior));
+        p += escrever_varint(p, zigzag((int64_t)q[0] - s_q_anterior[0]));
+        p += escrever_varint(p, zigzag((int64_t)q[1] - s_q_anterior[1]));
+        s_dt_anterior = dt;
+    }
+    s_tam_corpo = (size_t)(p - s_corpo);
+    s_t_anterior = a->t_us;
+    s_q_anterior[0] = q[0];
+    s_q_anterior[1] = q[1];
+    s_contador++;
+    s_n++;
+
+    return s_n >= CODEC_LOTE_MAX_AMOSTRAS || codec_telemetria_expirou(a->t_us);
+}
+
+bool codec_telemetria_expirou(int64_t agora_us) {
+    return s_n > 0 && agora_us - s_inicio_lote_us >= (int64_t)s_cfg.lote_max_ms * 1000;
+}
+
+size_t codec_telemetria_fechar(const uint8_t **dados, uint8_t *n_amostras) {
+    if (s_n == 0) return 0;
+
+    uint8_t *p = s_saida;
+    *p++ = CODEC_VERSAO;
+    *p++ = s_flags_lote ? CODEC_FLAG_KEYFRAME : 0;
+    *p++ = s_cfg.keyframe;
+    *p++ = (uint8_t)(s_cfg.resolucao_mgraus & 0xFF);
+    *p++ = (uint8_t)(s_cfg.resolucao_mgraus >> 8);
+    p += escrever_varint(p, s_contador_lote);
+    *p++ = s_n;
+    memcpy(p, s_corpo, s_tam_corpo);
+    p += s_tam_corpo;
+
+    *dados = s_saida;
+    *n_amostras = s_n;
+    s_n = 0;
+    return (size_t)(p - s_saida);
+}
@@ -0,0 +1,62 @@
+// main/TELEMETRIA/codec_telemetria.h
+
+#ifndef CODEC_TELEMETRIA_H
+#define CODEC_TELEMETRIA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "BufferTelemetria.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Telemetria binária compacta (gimbal/tel_bin), decodificada por Interface/MQTT/codec_telemetria.py.
+//
+// Lote: [versao u8][flags u8][keyframe u8][resolucao u16 LE, 0,001°][contador varint][n u8] + n amostras.
+// "contador" é o índice da primeira amostra do lote; a amostra i é keyframe se (contador + i) % keyframe == 0
+// ou, com CODEC_FLAG_KEYFRAME, se i == 0 (início ou mudança de configuração).
+//   keyframe:  t_us varint, pitch zigzag, roll zigzag (absolutos, ângulos quantizados)
+//   delta:     zigzag(dt - dt_anterior), zigzag(dpitch), zigzag(droll)
+// As diferenças atravessam lotes; perdido um lote, o decodificador espera o próximo keyframe.
+
+#define CODEC_VERSAO            1
+#define CODEC_FLAG_KEYFRAME     (1 << 0)
+#define CODEC_LOTE_MAX_AMOSTRAS 32
+#define CODEC_LOTE_MAX_BYTES    (5 + 5 + 1 + CODEC_LOTE_MAX_AMOSTRAS * (10 + 5 + 5))
+
+/**
+ * @brief Liga/desliga o formato binário e ajusta resolução (graus) e intervalo de keyframes.
+ * Vale a partir do próximo lote (chamada pelo MQTT).
+ */
+void codec_telemetria_configurar(bool ativo, float resolucao_graus, int keyframe, int lote_max_ms);
+
+/**
+ * @brief true se a telemetria deve sair no formato binário (task de telemetria; aplica a
+ * configuração pendente entre lotes).
+ */
+bool codec_telemetria_ativo(void);
+
+/**
+ * @brief Acrescenta uma amostra ao lote atual (task de telemetria).
+ * @return true se o lote ficou pronto (cheio ou com lote_max_ms de idade).
+ */
+bool codec_telemetria_adicionar(const telemetria_amostra_t *amostra);
+
+/**
+ * @brief true se o lote aberto já tem lote_max_ms de idade (para fechar sem nova amostra).
+ */
+bool codec_telemetria_expirou(int64_t agora_us);
+
+/**
+ * @brief Fecha o lote e devolve os bytes (válidos até a próxima chamada a adicionar).
+ * @return Tamanho em bytes (0 se o lote estava vazio).
+ */
+size_t codec_telemetria_fechar(const uint8_t **dados, uint8_t *n_amostras);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CODEC_TELEMETRIA_H
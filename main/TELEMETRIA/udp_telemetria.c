@@ -0,0 +1,150 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <errno.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "lwip/sockets.h"
+#include "log_mqtt.h"
+
+// --- Includes do Projeto ---
+#include "udp_telemetria.h"
+#include "codec_telemetria.h"
+
+// --- Tag de Log ---
+static const char *TAG = "UDP_TEL";
+
+#define TAXA_MAX_HZ     500
+
+// Registro pedido pelo MQTT (s_mux); a task de telemetria aplica
+static uint32_t s_ipv4_pedido;
+static uint16_t s_porta_pedida;
+static uint16_t s_taxa_pedida;
+static int64_t s_expira_us;
+static bool s_registro_novo;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Socket e destino (só a task de telemetria)
+static int s_sock = -1;
+static struct sockaddr_in s_destino;
+static uint32_t s_seq;
+static uint8_t s_pacote[UDP_TEL_CABECALHO + CODEC_LOTE_MAX_BYTES];
+
+// Estado exposto (s_mux)
+static udp_telemetria_estado_t s_estado;
+
+bool udp_telemetria_registrar(const char *host, uint16_t porta, uint16_t taxa_hz) {
+    struct in_addr ip = { 0 };
+    if (host && porta && inet_pton(AF_INET, host, &ip) != 1) {
+        ESP_LOGW(TAG, "Endereço inválido: %s", host);
+        return false;
+    }
+    if (taxa_hz == 0) taxa_hz = UDP_TAXA_PADRAO_HZ;
+    if (taxa_hz > TAXA_MAX_HZ) taxa_hz = TAXA_MAX_HZ;
+
+    bool ligar = host && porta;
+    portENTER_CRITICAL(&s_mux);
+    bool renovacao = ligar && s_estado.ativo && s_ipv4_pedido == ip.s_addr
+                     && s_porta_pedida == porta && s_taxa_pedida == taxa_hz;
+    s_ipv4_pedido = ligar ? ip.s_addr : 0;
+    s_porta_pedida = ligar ? porta : 0;
+    s_taxa_pedida = ligar ? taxa_hz : 0;
+    s_expira_us = esp_timer_get_time() + (int64_t)UDP_LEASE_MS * 1000;
+    s_registro_novo = s_registro_novo || !renovacao;   // Não apaga uma mudança ainda não aplicada
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+static void fechar_socket(void) {
+    if (s_sock >= 0) {
+        close(s_sock);
+        s_sock = -1;
+    }
+}
+
+bool udp_telemetria_ativa(int64_t agora_us) {
+    if (!s_registro_novo && !s_estado.ativo) return false;
+
+    portENTER_CRITICAL(&s_mux);
+    bool novo = s_registro_novo;
+    bool expirou = s_estado.ativo && agora_us > s_expira_us;
+    uint32_t ipv4 = s_ipv4_pedido;
+    uint16_t porta = s_porta_pedida;
+    uint16_t taxa = s_taxa_pedida;
+    s_registro_novo = false;
+    portEXIT_CRITICAL(&s_mux);
+
+    if (expirou || (novo && porta == 0)) {
+        fechar_socket();
+        portENTER_CRITICAL(&s_mux);
+        s_estado.ativo = false;
+        s_estado.taxa_hz = 0;
+        s_ipv4_pedido = 0;
+        s_porta_pedida = 0;
+        portEXIT_CRITICAL(&s_mux);
+        LOGI(TAG, "Telemetria UDP desligada%s", expirou ? " (registro não renovado)" : "");
+        return false;
+    }
+    if (!novo) return true;
+
+    if (s_sock < 0) {
+        s_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        if (s_sock < 0) {
+            LOGE(TAG, "Falha ao criar socket UDP: errno %d", errno);
+            return false;
+        }
+    }
+    memset(&s_destino, 0, sizeof(s_destino));
+    s_destino.sin_family = AF_INET;
+    s_destino.sin_addr.s_addr = ipv4;
+    s_destino.sin_port = htons(porta);
+
+    portENTER_CRITICAL(&s_mux);
+    s_estado.ativo = true;
+    s_estado.ipv4 = ipv4;
+    s_estado.porta = porta;
+    s_estado.taxa_hz = taxa;
+    s_estado.pacotes = 0;
+    s_estado.falhas = 0;
+    portEXIT_CRITICAL(&s_mux);
+
+    char ip_txt[16];
+    inet_ntop(AF_INET, &s_destino.sin_addr, ip_txt, sizeof(ip_txt));
+    LOGI(TAG, "Telemetria UDP para %s:%u a %u Hz", ip_txt, porta, taxa);
+    return true;
+}
+
+uint16_t udp_telemetria_taxa_hz(void) {
+    return s_estado.ativo ? s_estado.taxa_hz : 0;
+}
+
+bool udp_telemetria_enviar(const uint8_t *lote, size_t tamanho) {
+    if (s_sock < 0 || tamanho > CODEC_LOTE_MAX_BYTES) return false;
+
+    s_pacote[0] = 'G';
+    s_pacote[1] = 'T';
+    s_pacote[2] = UDP_TEL_VERSAO;
+    s_pacote[3] = 0;
+    s_pacote[4] = (uint8_t)s_seq;
+    s_pacote[5] = (uint8_t)(s_seq >> 8);
+    s_pacote[6] = (uint8_t)(s_seq >> 16);
+    s_pacote[7] = (uint8_t)(s_seq >> 24);
+    memcpy(&s_pacote[UDP_TEL_CABECALHO], lote, tamanho);
+    s_seq++;    // Conta também os recusados: o PC os vê como perdidos
+
+    // Sem buffer no lwIP o datagrama é descartado na hora; a telemetria não espera a rede
+    bool ok = sendto(s_sock, s_pacote, UDP_TEL_CABECALHO + tamanho, MSG_DONTWAIT,
+                     (struct sockaddr *)&s_destino, sizeof(s_destino)) >= 0;
+
+    portENTER_CRITICAL(&s_mux);
+    if (ok) s_estado.pacotes++;
+    else s_estado.falhas++;
+    portEXIT_CRITICAL(&s_mux);
+    return ok;
+}
+
+void udp_telemetria_obter_estado(udp_telemetria_estado_t *saida) {
+    portENTER_CRITICAL(&s_mux);
+    *saida = s_estado;
+    portEXIT_CRITICAL(&s_mux);
+}
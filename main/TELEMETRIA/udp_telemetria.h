@@ -0,0 +1,66 @@
+// main/TELEMETRIA/udp_telemetria.h
+
+#ifndef UDP_TELEMETRIA_H
+#define UDP_TELEMETRIA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Telemetria binária direto para um PC da rede local por UDP, sem TLS nem broker.
+// O MQTT continua com comandos e logs; o PC se registra (e renova) por {"telemetria":{"udp":{...}}}
+// e o envio para sozinho se a renovação não chegar em UDP_LEASE_MS.
+//
+// Datagrama: ['G']['T'][versao u8][reservado u8][seq u32 LE] + um lote de codec_telemetria.h.
+// "seq" conta datagramas (perdas e reordenação); o contador do lote conta amostras.
+
+#define UDP_TEL_VERSAO      1
+#define UDP_TEL_CABECALHO   8
+#define UDP_LEASE_MS        15000
+#define UDP_TAXA_PADRAO_HZ  200
+
+typedef struct {
+    bool ativo;
+    uint32_t ipv4;          // Ordem de rede
+    uint16_t porta;
+    uint16_t taxa_hz;
+    uint32_t pacotes;       // Desde o registro
+    uint32_t falhas;        // sendto recusado (sem buffer no lwIP)
+} udp_telemetria_estado_t;
+
+/**
+ * @brief Registra/renova o destino (chamada pelo MQTT). host NULL ou porta 0 desliga.
+ * @param host IPv4 em texto ("192.168.0.10")
+ * @return false se o endereço for inválido.
+ */
+bool udp_telemetria_registrar(const char *host, uint16_t porta, uint16_t taxa_hz);
+
+/**
+ * @brief true se há destino registrado (task de telemetria; abre/fecha o socket e expira o registro).
+ */
+bool udp_telemetria_ativa(int64_t agora_us);
+
+/**
+ * @brief Taxa pedida pelo PC registrado (0 se inativo).
+ */
+uint16_t udp_telemetria_taxa_hz(void);
+
+/**
+ * @brief Envia um lote num datagrama (task de telemetria, sem bloquear).
+ */
+bool udp_telemetria_enviar(const uint8_t *lote, size_t tamanho);
+
+/**
+ * @brief Copia destino e contadores.
+ */
+void udp_telemetria_obter_estado(udp_telemetria_estado_t *saida);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UDP_TELEMETRIA_H
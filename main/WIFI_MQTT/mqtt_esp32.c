@@ -1,12 +1,30 @@
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <math.h>
+#include <float.h>
 #include "esp_log.h"
 #include "mqtt_client.h"
 #include "mqtt_esp32.h"
 #include "esp_crt_bundle.h"
 #include "cJSON.h"
-#include "mainGlobals.h"
+#include "gerenciador_energia.h"
+#include "wifi_sta.h"
+#include "esp_timer.h"
+#include "sequencia_init.h"
+#include "CalibracaoIMU.h"
+#include "VelocidadeI2C.h"
+#include "SensorMPU6050.h"
+#include "filtros.h"
+#include "identificacao.h"
+#include "setpoint.h"
+#include "parser_comando.h"
+#include "stream_setpoint.h"
+#include "roteiro.h"
+#include "codec_telemetria.h"
+#include "agendador_telemetria.h"
+#include "udp_telemetria.h"
 
 // ---------------------------
 // Tópicos (GUI <-> ESP32)
@@ -14,6 +32,17 @@
 #define TOPIC_CMD "gimbal/cmd"   // GUI -> ESP32 (comando JSON)
 #define TOPIC_TEL "gimbal/tel"   // ESP32 -> GUI (telemetria JSON)
 #define TOPIC_LOG "gimbal/log"   // Logs do ESP32 -> PC
+#define TOPIC_ENERGIA "gimbal/energia" // Modo de energia ESP32 -> GUI (retido)
+#define TOPIC_METRICAS "gimbal/metricas" // Tempos de conexão ESP32 -> PC
+#define TOPIC_ESPECTRO "gimbal/espectro" // Espectro de vibração ESP32 -> GUI (~1 Hz)
+#define TOPIC_IDENT "gimbal/ident"       // Gravações de identificação ESP32 -> PC
+#define TOPIC_ROTEIRO "gimbal/roteiro"   // Progresso do roteiro ESP32 -> GUI
+#define TOPIC_TEL_BIN "gimbal/tel_bin"   // Telemetria binária compacta ESP32 -> GUI (ver codec_telemetria.h)
+#define TOPIC_PONG "gimbal/pong"         // Resposta ao ping de sincronia de relógio ESP32 -> PC
+#define TOPIC_TEL_ESTADO "gimbal/tel_estado" // Taxa/conteúdo da telemetria e saúde do enlace ESP32 -> GUI
+
+// Limite da fila de saída do cliente: acima disso a telemetria é descartada (e contada)
+#define OUTBOX_LIMITE_BYTES 16384
 
 
 // ---------------------------
@@ -24,19 +53,158 @@
 static const char *TAG = "MQTT_GIMBAL";
 static esp_mqtt_client_handle_t s_client = NULL;
 
+// Instantes (desde o boot) para medir o tempo até a primeira telemetria
+static int64_t s_conectado_us = 0;
+static bool s_primeira_telemetria = true;
+
+// Confirmação do último comando com "id" (instantes no relógio do ESP32, em us)
+static bool adicionar_confirmacao(cJSON *root) {
+    setpoint_confirmacao_t conf;
+    if (!setpoint_confirmacao_pendente(&conf)) return false;
+
+    cJSON *ack = cJSON_AddObjectToObject(root, "ack");
+    if (ack) {
+        cJSON_AddNumberToObject(ack, "id", conf.id);
+        cJSON_AddNumberToObject(ack, "th", conf.th_ms);
+        cJSON_AddNumberToObject(ack, "rx", (double)conf.recebido_us);
+        cJSON_AddNumberToObject(ack, "at", (double)conf.atuacao_us);
+        cJSON_AddNumberToObject(ack, "tx", (double)esp_timer_get_time());
+    }
+    return true;
+}
+
+// Telemetria vai para a fila do cliente (enqueue) em vez de escrever no socket: a task de
+// telemetria nunca bloqueia num enlace lento, e o tamanho da fila mede o congestionamento.
+static int enfileirar_telemetria(const char *topico, const char *dados, int tamanho, int64_t t_us) {
+    int id = esp_mqtt_client_enqueue(s_client, topico, dados, tamanho, 0, 0, true);
+    agendador_telemetria_registrar_envio((size_t)tamanho, id >= 0, esp_timer_get_time() - t_us);
+    return id;
+}
+
 // --- Publica telemetria ---
-void mqtt_publish_telemetry(float pitch, float roll) {
-    if (!s_client) return;
+void mqtt_publish_telemetry(float pitch, float roll, int64_t t_us) {
+    if (!s_client || !s_conectado_us) return;
+
+    // Enlace congestionado: só os ângulos e o instante, sem passar pelo cJSON (confirmações pendentes vão completas)
+    if (agendador_telemetria_minimo() && !setpoint_ha_confirmacao()) {
+        char out[64];
+        int n = snprintf(out, sizeof(out), "{\"pitch\":%.2f,\"roll\":%.2f,\"t_us\":%lld}", pitch, roll, t_us);
+        enfileirar_telemetria(TOPIC_TEL, out, n, t_us);
+        return;
+    }
 
     cJSON *root = cJSON_CreateObject();
     if (!root) return;
 
     cJSON_AddNumberToObject(root, "pitch", pitch);
     cJSON_AddNumberToObject(root, "roll",  roll);
+    cJSON_AddNumberToObject(root, "t_us",  (double)t_us);   // Instante da medição no relógio do ESP32
+    adicionar_confirmacao(root);
 
     char *out = cJSON_PrintUnformatted(root);
     if (out) {
-        esp_mqtt_client_publish(s_client, TOPIC_TEL, out, 0, 0, 0);
+        if (enfileirar_telemetria(TOPIC_TEL, out, (int)strlen(out), t_us) >= 0 && s_primeira_telemetria) {
+            s_primeira_telemetria = false;
+            int64_t agora_ms = esp_timer_get_time() / 1000;
+            int64_t apos_broker_ms = agora_ms - s_conectado_us / 1000;
+            ESP_LOGI(TAG, "Primeira telemetria %lld ms após o boot (%lld ms após conectar ao broker)", agora_ms, apos_broker_ms);
+            mqtt_publish_logf(TAG, "INFO", "Primeira telemetria %lld ms após o boot (%lld ms após conectar ao broker)", agora_ms, apos_broker_ms);
+        }
+        free(out);
+    }
+    cJSON_Delete(root);
+}
+
+// --- Publica um lote de telemetria binária ---
+void mqtt_publish_telemetria_lote(const uint8_t *dados, size_t tamanho, int64_t t_us) {
+    if (!s_client || !s_conectado_us) return;
+    enfileirar_telemetria(TOPIC_TEL_BIN, (const char *)dados, (int)tamanho, t_us);
+}
+
+// --- Publica o estado do agendador de telemetria ---
+void mqtt_publish_estado_telemetria(const agendador_estado_t *e) {
+    if (!s_client || !s_conectado_us) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    cJSON_AddNumberToObject(root, "hz", e->taxa_hz);
+    cJSON_AddStringToObject(root, "conteudo", e->minimo ? "minimo" : "completo");
+    cJSON_AddBoolToObject(root, "rajada", e->rajada);
+    cJSON_AddNumberToObject(root, "outbox", e->outbox_bytes);
+    cJSON_AddNumberToObject(root, "outbox_crescimento", e->outbox_crescimento);
+    cJSON_AddNumberToObject(root, "latencia_ms", e->latencia_ms);
+    cJSON_AddNumberToObject(root, "idade_ms", e->idade_max_ms);
+    cJSON_AddNumberToObject(root, "rssi", e->rssi);
+    cJSON_AddNumberToObject(root, "enviadas", e->enviadas);
+    cJSON_AddNumberToObject(root, "falhas", e->falhas);
+    cJSON_AddNumberToObject(root, "descartes_buffer", e->descartes_buffer);
+
+    udp_telemetria_estado_t udp;
+    udp_telemetria_obter_estado(&udp);
+    if (udp.ativo) {
+        cJSON *ju = cJSON_AddObjectToObject(root, "udp");
+        if (ju) {
+            char destino[24];
+            const uint8_t *ip = (const uint8_t *)&udp.ipv4;     // Ordem de rede
+            snprintf(destino, sizeof(destino), "%u.%u.%u.%u:%u", ip[0], ip[1], ip[2], ip[3], udp.porta);
+            cJSON_AddStringToObject(ju, "destino", destino);
+            cJSON_AddNumberToObject(ju, "hz", udp.taxa_hz);
+            cJSON_AddNumberToObject(ju, "pacotes", udp.pacotes);
+            cJSON_AddNumberToObject(ju, "falhas", udp.falhas);
+        }
+    }
+
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        esp_mqtt_client_publish(s_client, TOPIC_TEL_ESTADO, out, 0, 0, 0);
+        free(out);
+    }
+    cJSON_Delete(root);
+}
+
+// --- Bytes na fila de saída do cliente MQTT ---
+uint32_t mqtt_outbox_bytes(void) {
+    if (!s_client) return 0;
+    int n = esp_mqtt_client_get_outbox_size(s_client);
+    return n > 0 ? (uint32_t)n : 0;
+}
+
+// --- Publica só a confirmação de comando (telemetria no formato binário) ---
+void mqtt_publish_confirmacao(void) {
+    if (!s_client || !s_conectado_us) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    if (adicionar_confirmacao(root)) {
+        char *out = cJSON_PrintUnformatted(root);
+        if (out) {
+            esp_mqtt_client_publish(s_client, TOPIC_TEL, out, 0, 0, 0);
+            free(out);
+        }
+    }
+    cJSON_Delete(root);
+}
+
+// --- Publica os tempos de conexão (Wi-Fi e broker) ---
+static void publicar_metricas_conexao(void) {
+    wifi_metricas_t wifi;
+    if (!wifi_obter_metricas(&wifi)) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    cJSON_AddNumberToObject(root, "boot_ms",        (double)(s_conectado_us / 1000));
+    cJSON_AddNumberToObject(root, "wifi_ms",        wifi.tempo_conexao_ms);
+    cJSON_AddNumberToObject(root, "wifi_tentativas", wifi.tentativas);
+    cJSON_AddBoolToObject(root,   "wifi_cache",     wifi.usou_cache);
+    cJSON_AddNumberToObject(root, "canal",          wifi.canal);
+    cJSON_AddNumberToObject(root, "rssi",           wifi.rssi);
+
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        esp_mqtt_client_publish(s_client, TOPIC_METRICAS, out, 0, 0, 0);
         free(out);
     }
     cJSON_Delete(root);
@@ -50,6 +218,7 @@ void mqtt_publish_battery_voltage(double voltage) {
     if (!root) return;
 
     cJSON_AddNumberToObject(root, "vbat", voltage);
+    cJSON_AddNumberToObject(root, "t_us", (double)esp_timer_get_time());
 
     char *out = cJSON_PrintUnformatted(root);
     if (out) {
@@ -59,11 +228,148 @@ void mqtt_publish_battery_voltage(double voltage) {
     cJSON_Delete(root);
 }
 
+// --- Publica o modo de energia ---
+void mqtt_publish_power_mode(const char *modo, bool forcado, float vbat) {
+    if (!s_client) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    cJSON_AddStringToObject(root, "modo", modo ? modo : "");
+    cJSON_AddBoolToObject(root, "forcado", forcado);
+    cJSON_AddNumberToObject(root, "vbat", vbat);
+
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        // Retido para a GUI saber o modo mesmo conectando depois da troca
+        esp_mqtt_client_publish(s_client, TOPIC_ENERGIA, out, 0, 0, 1);
+        free(out);
+    }
+    cJSON_Delete(root);
+}
+
+// --- Publica o espectro de vibração ---
+void mqtt_publish_espectro(const espectro_resultado_t *r) {
+    if (!s_client || !s_conectado_us) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    cJSON_AddNumberToObject(root, "fs", roundf(r->fs_hz * 10.0f) / 10.0f);
+    cJSON_AddNumberToObject(root, "n", ESPECTRO_N);
+    cJSON_AddNumberToObject(root, "janelas", r->janelas);
+
+    static const char *nomes[2] = { "pitch", "roll" };
+    for (int e = 0; e < 2; e++) {
+        const espectro_eixo_t *eixo = &r->eixo[e];
+        cJSON *obj = cJSON_AddObjectToObject(root, nomes[e]);
+        if (!obj) continue;
+
+        // Picos como [f_hz, dB]
+        cJSON *picos = cJSON_AddArrayToObject(obj, "picos");
+        for (int i = 0; picos && i < eixo->n_picos; i++) {
+            cJSON *par = cJSON_CreateArray();
+            cJSON_AddItemToArray(par, cJSON_CreateNumber(roundf(eixo->picos[i].f_hz * 10.0f) / 10.0f));
+            cJSON_AddItemToArray(par, cJSON_CreateNumber(roundf(eixo->picos[i].db * 10.0f) / 10.0f));
+            cJSON_AddItemToArray(picos, par);
+        }
+
+        // Bandas de (fs/2)/ESPECTRO_BANDAS Hz, em dB re 1 °/s
+        cJSON *db = cJSON_AddArrayToObject(obj, "db");
+        for (int b = 0; db && b < ESPECTRO_BANDAS; b++) {
+            cJSON_AddItemToArray(db, cJSON_CreateNumber(eixo->db[b]));
+        }
+    }
+
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        esp_mqtt_client_publish(s_client, TOPIC_ESPECTRO, out, 0, 0, 0);
+        free(out);
+    }
+    cJSON_Delete(root);
+}
+
+// --- Publica o cabeçalho da identificação ---
+bool mqtt_publish_identificacao_inicio(const ident_config_t *cfg, float fs_hz, uint32_t total) {
+    if (!s_client || !s_conectado_us) return false;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return false;
+
+    cJSON_AddStringToObject(root, "eixo", identificacao_nome_eixo(cfg->eixo));
+    cJSON_AddStringToObject(root, "sinal", identificacao_nome_sinal(cfg->sinal));
+    cJSON_AddNumberToObject(root, "amplitude", cfg->amplitude);
+    cJSON_AddNumberToObject(root, "f0", cfg->f0_hz);
+    cJSON_AddNumberToObject(root, "f1", cfg->f1_hz);
+    cJSON_AddNumberToObject(root, "fs", fs_hz);
+    cJSON_AddNumberToObject(root, "total", total);
+    cJSON_AddNumberToObject(root, "escala_cmd", IDENT_ESCALA_CMD);
+    cJSON_AddNumberToObject(root, "giro_lsb_por_grau", IDENT_GIRO_LSB_POR_GRAU);
+
+    bool ok = false;
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        ok = esp_mqtt_client_publish(s_client, TOPIC_IDENT, out, 0, 1, 0) >= 0;
+        free(out);
+    }
+    cJSON_Delete(root);
+    return ok;
+}
+
+// --- Publica um bloco de amostras da identificação ---
+bool mqtt_publish_identificacao_bloco(uint32_t inicio, const ident_amostra_t *amostras, uint16_t n) {
+    if (!s_client || !s_conectado_us) return false;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return false;
+
+    cJSON_AddNumberToObject(root, "inicio", inicio);
+    cJSON *r = cJSON_AddArrayToObject(root, "r");
+    cJSON *u = cJSON_AddArrayToObject(root, "u");
+    cJSON *y = cJSON_AddArrayToObject(root, "y");
+    for (uint16_t i = 0; r && u && y && i < n; i++) {
+        cJSON_AddItemToArray(r, cJSON_CreateNumber(amostras[i].r));
+        cJSON_AddItemToArray(u, cJSON_CreateNumber(amostras[i].u));
+        cJSON_AddItemToArray(y, cJSON_CreateNumber(amostras[i].y));
+    }
+
+    bool ok = false;
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        ok = esp_mqtt_client_publish(s_client, TOPIC_IDENT, out, 0, 1, 0) >= 0;
+        free(out);
+    }
+    cJSON_Delete(root);
+    return ok;
+}
+
+// --- Publica o progresso do roteiro ---
+void mqtt_publish_roteiro(const roteiro_progresso_t *p) {
+    if (!s_client) return;
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+
+    cJSON_AddStringToObject(root, "estado", roteiro_nome_estado(p->estado));
+    cJSON_AddNumberToObject(root, "ponto", p->ponto);
+    cJSON_AddNumberToObject(root, "n_pontos", p->n_pontos);
+    cJSON_AddNumberToObject(root, "volta", p->volta);
+    cJSON_AddNumberToObject(root, "repeticoes", p->repeticoes);
+
+    char *out = cJSON_PrintUnformatted(root);
+    if (out) {
+        esp_mqtt_client_publish(s_client, TOPIC_ROTEIRO, out, 0, 0, 0);
+        free(out);
+    }
+    cJSON_Delete(root);
+}
+
 // --- Publica logs de erro ---
 void mqtt_publish_logf(const char *tag, const char *level, const char *fmt, ...) {
     if (!s_client) {
         return;  // Ainda não conectado ao broker
     }
+    int64_t t_us = esp_timer_get_time();
 
     cJSON *root = cJSON_CreateObject();
     if (!root) return;
@@ -80,6 +386,7 @@ void mqtt_publish_logf(const char *tag, const char *level, const char *fmt, ...)
     va_end(ap);
 
     cJSON_AddStringToObject(root, "msg", msg_buf);
+    cJSON_AddNumberToObject(root, "t_us", (double)t_us);
 
     char *out = cJSON_PrintUnformatted(root);
     if (out) {
@@ -90,8 +397,45 @@ void mqtt_publish_logf(const char *tag, const char *level, const char *fmt, ...)
     cJSON_Delete(root);
 }
 
-// --- Aplica comando JSON recebido: atualiza pr[] ---
-static void apply_cmd_json(const char *payload, int len) {
+// Número finito que cabe em float (mesma regra do parser_setpoint)
+static bool json_float(const cJSON *j, float *saida) {
+    if (!cJSON_IsNumber(j) || !(fabs(j->valuedouble) <= FLT_MAX)) return false;
+    *saida = (float)j->valuedouble;
+    return true;
+}
+
+// Inteiro de 32 bits sem sinal; ausente deixa 0
+static bool json_u32(const cJSON *j, uint32_t *saida) {
+    if (!j) return true;
+    if (!cJSON_IsNumber(j)) return false;
+    double v = j->valuedouble;
+    if (v < 0.0 || v > 4294967295.0 || v != floor(v)) return false;
+    *saida = (uint32_t)v;
+    return true;
+}
+
+// Setpoint que veio junto com configuração: lê vel/tempo/seq/id/th como o parser_setpoint,
+// para valer a mesma rampa, o descarte por sequência e a confirmação na telemetria.
+// Amostra de streaming ("t") só é aceita sozinha.
+static bool setpoint_de_json(const cJSON *root, setpoint_t *sp, bool *tem_seq) {
+    memset(sp, 0, sizeof(*sp));
+    const cJSON *jseq = cJSON_GetObjectItemCaseSensitive(root, "seq");
+    const cJSON *jvel = cJSON_GetObjectItemCaseSensitive(root, "vel");
+    const cJSON *jtempo = cJSON_GetObjectItemCaseSensitive(root, "tempo");
+    *tem_seq = jseq != NULL;
+
+    if (!json_float(cJSON_GetObjectItemCaseSensitive(root, "pitch"), &sp->pitch)
+        || !json_float(cJSON_GetObjectItemCaseSensitive(root, "roll"), &sp->roll)) return false;
+    if (jvel && (!json_float(jvel, &sp->velocidade) || sp->velocidade < 0.0f)) return false;
+    if (jtempo && (!json_float(jtempo, &sp->tempo_s) || sp->tempo_s < 0.0f)) return false;
+    if (cJSON_GetObjectItemCaseSensitive(root, "t")) return false;
+    return json_u32(jseq, &sp->seq)
+           && json_u32(cJSON_GetObjectItemCaseSensitive(root, "id"), &sp->id)
+           && json_u32(cJSON_GetObjectItemCaseSensitive(root, "th"), &sp->th_ms);
+}
+
+// --- Aplica comando JSON recebido (configuração; setpoints puros vão por apply_cmd) ---
+static void apply_cmd_json(const char *payload, int len, int64_t recebido_us) {
     if (!payload || len <= 0) return;
 
     // Garante string \0-terminada para o cJSON
@@ -109,20 +453,258 @@ static void apply_cmd_json(const char *payload, int len) {
 
     const cJSON *jp = cJSON_GetObjectItemCaseSensitive(root, "pitch");
     const cJSON *jr = cJSON_GetObjectItemCaseSensitive(root, "roll");
+    const cJSON *je = cJSON_GetObjectItemCaseSensitive(root, "modo_energia");
+    const cJSON *jc = cJSON_GetObjectItemCaseSensitive(root, "recalibrar");
+    const cJSON *jv = cJSON_GetObjectItemCaseSensitive(root, "caracterizar_i2c");
+    const cJSON *ja = cJSON_GetObjectItemCaseSensitive(root, "divisor_acel");
+    const cJSON *jk = cJSON_GetObjectItemCaseSensitive(root, "kalman_adaptativo");
+    const cJSON *jf = cJSON_GetObjectItemCaseSensitive(root, "filtro");
+    const cJSON *ji = cJSON_GetObjectItemCaseSensitive(root, "ident");
+    const cJSON *js = cJSON_GetObjectItemCaseSensitive(root, "stream_atraso_ms");
+    const cJSON *jt = cJSON_GetObjectItemCaseSensitive(root, "roteiro");
+    const cJSON *jg = cJSON_GetObjectItemCaseSensitive(root, "ping");
+    const cJSON *jl = cJSON_GetObjectItemCaseSensitive(root, "telemetria");
+    bool reconhecido = false;
+
+    // Ping de sincronia de relógio: devolve chegada e resposta no relógio do ESP32 (o PC
+    // estima o offset pelo RTT mínimo, como no NTP). Primeiro para não somar o resto do comando.
+    if (cJSON_IsNumber(jg)) {
+        char pong[80];
+        snprintf(pong, sizeof(pong), "{\"ping\":%.0f,\"rx\":%lld,\"tx\":%lld}",
+                 jg->valuedouble, recebido_us, esp_timer_get_time());
+        esp_mqtt_client_publish(s_client, TOPIC_PONG, pong, 0, 0, 0);
+        reconhecido = true;
+    }
+
+    if (jp || jr) {
+        setpoint_t sp;
+        bool tem_seq;
+        if (!setpoint_de_json(root, &sp, &tem_seq)) {
+            ESP_LOGW(TAG, "Setpoint inválido no comando");
+        } else {
+            sp.recebido_us = recebido_us;
+            if (!setpoint_publicar(&sp, tem_seq)) {
+                ESP_LOGD(TAG, "Setpoint fora de ordem descartado (seq %lu)", (unsigned long)sp.seq);
+            }
+        }
+        reconhecido = true;
+    }
+
+    // Modo de energia: "auto", "normal", "economia", "reserva" ou "critico"
+    if (cJSON_IsString(je)) {
+        int modo = energia_modo_por_nome(je->valuestring);
+        if (modo >= -1) {
+            energia_forcar_modo(modo);
+        } else {
+            ESP_LOGW(TAG, "Modo de energia desconhecido: %s", je->valuestring);
+        }
+        reconhecido = true;
+    }
 
-    if (cJSON_IsNumber(jp) && cJSON_IsNumber(jr)) {
-        xSemaphoreTake(mutex_pr, portMAX_DELAY);
-        pr[0] = (float)jp->valuedouble;  // setpoint de pitch
-        pr[1] = (float)jr->valuedouble;  // setpoint de roll
-        xSemaphoreGive(mutex_pr);
-    } else {
-        ESP_LOGW(TAG, "JSON sem campos numéricos 'pitch'/'roll'");
+    // Recalibração do IMU: "giro" ou "completa" (inclui o acelerômetro; gimbal nivelado)
+    if (cJSON_IsString(jc)) {
+        if (strcmp(jc->valuestring, "giro") == 0 || strcmp(jc->valuestring, "completa") == 0) {
+            calibracao_solicitar(strcmp(jc->valuestring, "completa") == 0);
+        } else {
+            ESP_LOGW(TAG, "Recalibração desconhecida: %s", jc->valuestring);
+        }
+        reconhecido = true;
+    }
+
+    // Nova caracterização da velocidade do barramento I2C
+    if (cJSON_IsTrue(jv)) {
+        velocidade_i2c_solicitar();
+        reconhecido = true;
+    }
+
+    // Ciclos entre leituras do acelerômetro (1 = leitura completa todo ciclo)
+    if (cJSON_IsNumber(ja)) {
+        mpu_definir_divisor_acel(ja->valueint);
+        reconhecido = true;
+    }
+
+    if (cJSON_IsBool(jk)) {
+        mpu_definir_kalman_adaptativo(cJSON_IsTrue(jk));
+        reconhecido = true;
+    }
+
+    // Estágio de filtro: {"alvo":"giro"|"saida","estagio":0..2,"tipo":"notch","fc":120,"q":4}
+    if (cJSON_IsObject(jf)) {
+        const cJSON *alvo = cJSON_GetObjectItemCaseSensitive(jf, "alvo");
+        const cJSON *estagio = cJSON_GetObjectItemCaseSensitive(jf, "estagio");
+        const cJSON *tipo = cJSON_GetObjectItemCaseSensitive(jf, "tipo");
+        const cJSON *fc = cJSON_GetObjectItemCaseSensitive(jf, "fc");
+        const cJSON *q = cJSON_GetObjectItemCaseSensitive(jf, "q");
+        int a = cJSON_IsString(alvo) ? filtros_alvo_por_nome(alvo->valuestring) : -1;
+        int t = cJSON_IsString(tipo) ? filtros_tipo_por_nome(tipo->valuestring) : -1;
+
+        if (a < 0 || t < 0 || !cJSON_IsNumber(estagio)
+            || !filtros_definir_estagio((filtro_alvo_t)a, estagio->valueint, (filtro_tipo_t)t,
+                                        cJSON_IsNumber(fc) ? (float)fc->valuedouble : 0.0f,
+                                        cJSON_IsNumber(q) ? (float)q->valuedouble : 0.0f)) {
+            ESP_LOGW(TAG, "Filtro inválido");
+        }
+        reconhecido = true;
+    }
+
+    // Formato da telemetria: {"formato":"json"|"binario","resolucao":0.01,"keyframe":50,"lote_ms":100}
+    if (cJSON_IsObject(jl)) {
+        const cJSON *formato = cJSON_GetObjectItemCaseSensitive(jl, "formato");
+        const cJSON *res = cJSON_GetObjectItemCaseSensitive(jl, "resolucao");
+        const cJSON *kf = cJSON_GetObjectItemCaseSensitive(jl, "keyframe");
+        const cJSON *lote = cJSON_GetObjectItemCaseSensitive(jl, "lote_ms");
+        if (cJSON_IsString(formato)) {
+            bool binario = strcmp(formato->valuestring, "binario") == 0;
+            if (binario || strcmp(formato->valuestring, "json") == 0) {
+                codec_telemetria_configurar(binario,
+                                            cJSON_IsNumber(res) ? (float)res->valuedouble : 0.01f,
+                                            cJSON_IsNumber(kf) ? kf->valueint : 50,
+                                            cJSON_IsNumber(lote) ? lote->valueint : 100);
+            } else {
+                ESP_LOGW(TAG, "Formato de telemetria desconhecido: %s", formato->valuestring);
+            }
+        }
+        // Telemetria direto por UDP: {"udp":{"host":"192.168.0.10","porta":5005,"hz":200}} (renovar
+        // a cada poucos segundos) ou {"udp":false}
+        const cJSON *udp = cJSON_GetObjectItemCaseSensitive(jl, "udp");
+        if (cJSON_IsObject(udp)) {
+            const cJSON *host = cJSON_GetObjectItemCaseSensitive(udp, "host");
+            const cJSON *porta = cJSON_GetObjectItemCaseSensitive(udp, "porta");
+            const cJSON *hz = cJSON_GetObjectItemCaseSensitive(udp, "hz");
+            if (cJSON_IsString(host) && cJSON_IsNumber(porta) && porta->valueint > 0 && porta->valueint <= UINT16_MAX) {
+                udp_telemetria_registrar(host->valuestring, (uint16_t)porta->valueint,
+                                         cJSON_IsNumber(hz) && hz->valueint > 0 ? (uint16_t)hz->valueint : 0);
+            }
+        } else if (cJSON_IsFalse(udp)) {
+            udp_telemetria_registrar(NULL, 0, 0);
+        }
+
+        // Rajada sob demanda (GUI): taxa máxima e conteúdo completo por "rajada_s" segundos
+        const cJSON *rajada = cJSON_GetObjectItemCaseSensitive(jl, "rajada_s");
+        if (cJSON_IsNumber(rajada)) {
+            agendador_telemetria_rajada((float)rajada->valuedouble);
+        }
+        reconhecido = true;
+    }
+
+    // Profundidade do buffer de jitter do streaming de setpoint
+    if (cJSON_IsNumber(js)) {
+        stream_definir_atraso(js->valueint);
+        reconhecido = true;
+    }
+
+    // Identificação: {"eixo":"pitch"|"roll","sinal":"chirp"|"prbs","amplitude":0.5,"f0":1,"f1":200,"duracao":4}
+    if (cJSON_IsObject(ji)) {
+        const cJSON *eixo = cJSON_GetObjectItemCaseSensitive(ji, "eixo");
+        const cJSON *sinal = cJSON_GetObjectItemCaseSensitive(ji, "sinal");
+        const cJSON *amp = cJSON_GetObjectItemCaseSensitive(ji, "amplitude");
+        const cJSON *f0 = cJSON_GetObjectItemCaseSensitive(ji, "f0");
+        const cJSON *f1 = cJSON_GetObjectItemCaseSensitive(ji, "f1");
+        const cJSON *dur = cJSON_GetObjectItemCaseSensitive(ji, "duracao");
+        int e = cJSON_IsString(eixo) ? identificacao_eixo_por_nome(eixo->valuestring) : -1;
+        int s = cJSON_IsString(sinal) ? identificacao_sinal_por_nome(sinal->valuestring) : IDENT_CHIRP;
+
+        if (e < 0 || s < 0 || !cJSON_IsNumber(amp) || !cJSON_IsNumber(f0) || !cJSON_IsNumber(f1) || !cJSON_IsNumber(dur)) {
+            ESP_LOGW(TAG, "Identificação inválida");
+        } else {
+            ident_config_t cfg = {
+                .eixo = (ident_eixo_t)e,
+                .sinal = (ident_sinal_t)s,
+                .amplitude = (float)amp->valuedouble,
+                .f0_hz = (float)f0->valuedouble,
+                .f1_hz = (float)f1->valuedouble,
+                .duracao_s = (float)dur->valuedouble,
+            };
+            identificacao_solicitar(&cfg);
+        }
+        reconhecido = true;
+    }
+
+    // Roteiro: {"pontos":[[pitch_cgraus,roll_cgraus,movimento,espera_ms,suavizacao,flags],...],"repeticoes":N}
+    // e/ou {"acao":"iniciar"|"parar"}; o script legível é compilado no PC (Interface/MQTT/roteiro.py)
+    if (cJSON_IsObject(jt)) {
+        const cJSON *pontos = cJSON_GetObjectItemCaseSensitive(jt, "pontos");
+        const cJSON *rep = cJSON_GetObjectItemCaseSensitive(jt, "repeticoes");
+        const cJSON *acao = cJSON_GetObjectItemCaseSensitive(jt, "acao");
+
+        if (cJSON_IsArray(pontos)) {
+            static roteiro_ponto_t lidos[ROTEIRO_MAX_PONTOS];   // Fora da pilha da task MQTT
+            int n = 0;
+            bool ok = cJSON_GetArraySize(pontos) <= ROTEIRO_MAX_PONTOS;
+            const cJSON *pt;
+            cJSON_ArrayForEach(pt, pontos) {
+                if (!ok) break;
+                int v[6];
+                ok = cJSON_IsArray(pt) && cJSON_GetArraySize(pt) == 6;
+                for (int i = 0; ok && i < 6; i++) {
+                    const cJSON *c = cJSON_GetArrayItem(pt, i);
+                    ok = cJSON_IsNumber(c);
+                    if (ok) v[i] = c->valueint;
+                }
+                if (ok) ok = v[2] >= 0 && v[2] <= UINT16_MAX && v[3] >= 0 && v[3] <= UINT16_MAX
+                          && v[0] >= INT16_MIN && v[0] <= INT16_MAX && v[1] >= INT16_MIN && v[1] <= INT16_MAX
+                          && v[4] >= 0 && v[4] <= UINT8_MAX && v[5] >= 0 && v[5] <= UINT8_MAX;
+                if (ok) {
+                    lidos[n++] = (roteiro_ponto_t){
+                        .pitch_cgraus = (int16_t)v[0], .roll_cgraus = (int16_t)v[1],
+                        .movimento = (uint16_t)v[2], .espera_ms = (uint16_t)v[3],
+                        .suavizacao = (uint8_t)v[4], .flags = (uint8_t)v[5],
+                    };
+                }
+            }
+            int repeticoes = cJSON_IsNumber(rep) ? rep->valueint : 1;
+            if (!ok || repeticoes < 0 || repeticoes > UINT16_MAX || !roteiro_carregar(lidos, n, (uint16_t)repeticoes)) {
+                ESP_LOGW(TAG, "Roteiro inválido");
+            }
+        }
+
+        if (cJSON_IsString(acao)) {
+            if (strcmp(acao->valuestring, "iniciar") == 0) {
+                stream_encerrar();
+                roteiro_iniciar();
+            } else if (strcmp(acao->valuestring, "parar") == 0) {
+                roteiro_parar();
+            } else {
+                ESP_LOGW(TAG, "Ação de roteiro desconhecida: %s", acao->valuestring);
+            }
+        }
+        reconhecido = true;
+    }
+
+    if (!reconhecido) {
+        ESP_LOGW(TAG, "Comando desconhecido");
     }
 
     cJSON_Delete(root);
 }
 
 // --- Handler de eventos do cliente MQTT ---
+// --- Comando recebido: setpoint sem alocação; o resto (configuração) pelo cJSON ---
+static void apply_cmd(const char *payload, int len) {
+    int64_t recebido_us = esp_timer_get_time();
+    setpoint_t sp;
+    bool tem_seq;
+
+    switch (parser_setpoint(payload, len, &sp, &tem_seq)) {
+    case PARSER_SETPOINT:
+        sp.recebido_us = recebido_us;
+        if (!setpoint_publicar(&sp, tem_seq)) {
+            ESP_LOGD(TAG, "Setpoint fora de ordem descartado (seq %lu)", (unsigned long)sp.seq);
+        }
+        break;
+    case PARSER_STREAM:
+        sp.recebido_us = recebido_us;
+        stream_inserir(&sp);
+        break;
+    case PARSER_OUTRO:
+        apply_cmd_json(payload, len, recebido_us);
+        break;
+    default:
+        ESP_LOGW(TAG, "Comando inválido");
+        break;
+    }
+}
+
 static void _mqtt_event_handler(void *arg, esp_event_base_t base, int32_t eid, void *edata) {
     esp_mqtt_event_handle_t e = (esp_mqtt_event_handle_t) edata;
 
@@ -131,6 +713,9 @@ static void _mqtt_event_handler(void *arg, esp_event_base_t base, int32_t eid, v
         ESP_LOGI(TAG, "Conectado ao broker: %s", MQTT_URI);
         esp_mqtt_client_subscribe(s_client, TOPIC_CMD, 0);
         esp_mqtt_client_publish(s_client, "gimbal/status", "online", 0, 0, 1);
+        s_conectado_us = esp_timer_get_time();
+        init_marcar(INIT_BROKER_CONECTADO);
+        publicar_metricas_conexao();
         break;
 
     case MQTT_EVENT_DATA:
@@ -139,7 +724,7 @@ static void _mqtt_event_handler(void *arg, esp_event_base_t base, int32_t eid, v
             // Confere se o tópico é exatamente TOPIC_CMD
             if (strncmp(e->topic, TOPIC_CMD, e->topic_len) == 0
                 && strlen(TOPIC_CMD) == (size_t)e->topic_len) {
-                apply_cmd_json(e->data, e->data_len);
+                apply_cmd(e->data, e->data_len);
             }
         }
         break;
@@ -150,6 +735,8 @@ static void _mqtt_event_handler(void *arg, esp_event_base_t base, int32_t eid, v
 
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGW(TAG, "MQTT_EVENT_DISCONNECTED");
+        s_conectado_us = 0;
+        init_desmarcar(INIT_BROKER_CONECTADO);
         break;
 
     default:
@@ -163,6 +750,8 @@ void mqtt_start(void) {
     esp_mqtt_client_config_t cfg = {
         .broker.address.uri = MQTT_URI,
         .broker.verification.crt_bundle_attach = esp_crt_bundle_attach, // Habilita TLS com certificados padrão        
+        .buffer.size = 2560,    // Roteiro de 64 pontos (~2 KB) chega numa mensagem só
+        .outbox.limit = OUTBOX_LIMITE_BYTES,
         .credentials = {
             .username = "SEU_USUARIO_AQUI",                // Troque para seu usuário MQTT
             .authentication.password = "SEU_SENHA_AQUI",   // Troque para sua senha MQTT
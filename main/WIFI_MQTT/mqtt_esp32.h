@@ -3,6 +3,14 @@
 #ifndef MQTT_ESP32_H
 #define MQTT_ESP32_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "espectro.h"
+#include "identificacao.h"
+#include "roteiro.h"
+#include "agendador_telemetria.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,13 +23,61 @@ void mqtt_start(void);
 /**
  * @brief Tarefa de publicação de mensagens MQTT
  */
-void mqtt_publish_telemetry(float pitch, float roll);
+void mqtt_publish_telemetry(float pitch, float roll, int64_t t_us);
+
+/**
+ * @brief Publica um lote de telemetria binária (gimbal/tel_bin, ver codec_telemetria.h)
+ * @param t_us Instante da amostra mais recente do lote
+ */
+void mqtt_publish_telemetria_lote(const uint8_t *dados, size_t tamanho, int64_t t_us);
+
+/**
+ * @brief Publica taxa/conteúdo da telemetria e a saúde do enlace (gimbal/tel_estado)
+ */
+void mqtt_publish_estado_telemetria(const agendador_estado_t *e);
+
+/**
+ * @brief Bytes esperando na fila de saída do cliente MQTT
+ */
+uint32_t mqtt_outbox_bytes(void);
+
+/**
+ * @brief Publica a confirmação de comando pendente sozinha (telemetria no formato binário)
+ */
+void mqtt_publish_confirmacao(void);
 
 /**
  * @brief Publica a tensão da bateria via MQTT
  */
 void mqtt_publish_battery_voltage(double voltage);
 
+/**
+ * @brief Publica o modo do gerenciador de energia via MQTT
+ */
+void mqtt_publish_power_mode(const char *modo, bool forcado, float vbat);
+
+/**
+ * @brief Publica o espectro de vibração do giroscópio via MQTT
+ */
+void mqtt_publish_espectro(const espectro_resultado_t *r);
+
+/**
+ * @brief Publica o cabeçalho de uma gravação de identificação (gimbal/ident)
+ * @return false se o cliente não estiver conectado ou a publicação falhar.
+ */
+bool mqtt_publish_identificacao_inicio(const ident_config_t *cfg, float fs_hz, uint32_t total);
+
+/**
+ * @brief Publica um bloco de amostras da gravação de identificação
+ * @return false se o cliente não estiver conectado ou a publicação falhar.
+ */
+bool mqtt_publish_identificacao_bloco(uint32_t inicio, const ident_amostra_t *amostras, uint16_t n);
+
+/**
+ * @brief Publica o progresso do roteiro (gimbal/roteiro)
+ */
+void mqtt_publish_roteiro(const roteiro_progresso_t *p);
+
 /**
  * @brief Publica mensagem de log via MQTT (JSON)
  */
@@ -0,0 +1,149 @@
+// --- Includes Padrão e de Biblioteca ---
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+// --- Includes do Projeto ---
+#include "parser_comando.h"
+
+#define CHAVE_MAX       16      // Maior chave de setpoint com folga
+#define NUMERO_MAX      32      // Maior número aceito (caracteres)
+
+// Chaves do setpoint
+enum {
+    CAMPO_PITCH = 1 << 0,
+    CAMPO_ROLL  = 1 << 1,
+    CAMPO_VEL   = 1 << 2,
+    CAMPO_TEMPO = 1 << 3,
+    CAMPO_SEQ   = 1 << 4,
+    CAMPO_T     = 1 << 5,
+    CAMPO_ID    = 1 << 6,
+    CAMPO_TH    = 1 << 7,
+};
+
+// Cursor sobre o payload (sem \0)
+typedef struct {
+    const char *p;
+    const char *fim;
+} cursor_t;
+
+static void pular_espacos(cursor_t *c) {
+    while (c->p < c->fim && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) c->p++;
+}
+
+static bool consumir(cursor_t *c, char esperado) {
+    pular_espacos(c);
+    if (c->p >= c->fim || *c->p != esperado) return false;
+    c->p++;
+    return true;
+}
+
+// Chave entre aspas; escapes não fazem parte do esquema de setpoint (-1 = malformada, 0 = desconhecida)
+static int ler_chave(cursor_t *c) {
+    if (!consumir(c, '"')) return -1;
+    char chave[CHAVE_MAX];
+    int n = 0;
+    while (c->p < c->fim && *c->p != '"') {
+        if (*c->p == '\\' || n >= CHAVE_MAX - 1) {
+            // Chave longa ou com escape: não é de setpoint, mas o resto ainda pode ser JSON válido
+            while (c->p < c->fim && *c->p != '"') {
+                if (*c->p == '\\' && c->p + 1 < c->fim) c->p++;
+                c->p++;
+            }
+            if (c->p >= c->fim) return -1;
+            c->p++;
+            return 0;
+        }
+        chave[n++] = *c->p++;
+    }
+    if (c->p >= c->fim) return -1;
+    c->p++;
+    chave[n] = '\0';
+
+    if (strcmp(chave, "pitch") == 0) return CAMPO_PITCH;
+    if (strcmp(chave, "roll") == 0)  return CAMPO_ROLL;
+    if (strcmp(chave, "vel") == 0)   return CAMPO_VEL;
+    if (strcmp(chave, "tempo") == 0) return CAMPO_TEMPO;
+    if (strcmp(chave, "seq") == 0)   return CAMPO_SEQ;
+    if (strcmp(chave, "t") == 0)     return CAMPO_T;
+    if (strcmp(chave, "id") == 0)    return CAMPO_ID;
+    if (strcmp(chave, "th") == 0)    return CAMPO_TH;
+    return 0;
+}
+
+// Número JSON copiado para um buffer local para o strtod (o payload não termina em \0)
+static bool ler_numero(cursor_t *c, double *valor) {
+    pular_espacos(c);
+    char num[NUMERO_MAX];
+    int n = 0;
+    while (c->p < c->fim && n < NUMERO_MAX - 1) {
+        char ch = *c->p;
+        if ((ch < '0' || ch > '9') && ch != '-' && ch != '+' && ch != '.' && ch != 'e' && ch != 'E') break;
+        num[n++] = ch;
+        c->p++;
+    }
+    if (n == 0 || n >= NUMERO_MAX - 1) return false;
+    num[n] = '\0';
+
+    char *resto;
+    *valor = strtod(num, &resto);
+    // Os campos são float: um double finito ainda pode virar inf na conversão
+    return *resto == '\0' && fabs(*valor) <= FLT_MAX;
+}
+
+parser_resultado_t parser_setpoint(const char *json, int len, setpoint_t *sp, bool *tem_seq) {
+    if (!json || len <= 0) return PARSER_INVALIDO;
+
+    cursor_t c = { json, json + len };
+    memset(sp, 0, sizeof(*sp));
+    *tem_seq = false;
+    int campos = 0;
+
+    if (!consumir(&c, '{')) return PARSER_INVALIDO;
+    pular_espacos(&c);
+    if (c.p < c.fim && *c.p == '}') return PARSER_INVALIDO;
+
+    while (1) {
+        int campo = ler_chave(&c);
+        if (campo < 0 || !consumir(&c, ':')) return PARSER_INVALIDO;
+        if (campo == 0) return PARSER_OUTRO;
+
+        double v;
+        if (!ler_numero(&c, &v)) return PARSER_INVALIDO;
+        switch (campo) {
+        case CAMPO_PITCH: sp->pitch = (float)v; break;
+        case CAMPO_ROLL:  sp->roll = (float)v; break;
+        case CAMPO_VEL:   sp->velocidade = (float)v; break;
+        case CAMPO_TEMPO: sp->tempo_s = (float)v; break;
+        case CAMPO_SEQ:
+        case CAMPO_T:
+        case CAMPO_ID:
+        case CAMPO_TH:
+            if (v < 0.0 || v > 4294967295.0 || v != floor(v)) return PARSER_INVALIDO;
+            if (campo == CAMPO_SEQ) {
+                sp->seq = (uint32_t)v;
+                *tem_seq = true;
+            } else if (campo == CAMPO_T) {
+                sp->t_ms = (uint32_t)v;
+            } else if (campo == CAMPO_ID) {
+                sp->id = (uint32_t)v;
+            } else {
+                sp->th_ms = (uint32_t)v;
+            }
+            break;
+        }
+        campos |= campo;
+
+        if (consumir(&c, ',')) continue;
+        if (!consumir(&c, '}')) return PARSER_INVALIDO;
+        break;
+    }
+
+    pular_espacos(&c);
+    if (c.p != c.fim) return PARSER_INVALIDO;
+    if ((campos & (CAMPO_PITCH | CAMPO_ROLL)) != (CAMPO_PITCH | CAMPO_ROLL)) return PARSER_INVALIDO;
+    if (sp->velocidade < 0.0f || sp->tempo_s < 0.0f) return PARSER_INVALIDO;
+    if (campos & CAMPO_T) return (campos & CAMPO_SEQ) ? PARSER_STREAM : PARSER_INVALIDO;
+    return PARSER_SETPOINT;
+}
@@ -0,0 +1,30 @@
+// main/WIFI_MQTT/parser_comando.h
+
+#ifndef PARSER_COMANDO_H
+#define PARSER_COMANDO_H
+
+#include "setpoint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    PARSER_SETPOINT = 0,    // Só chaves de setpoint: preenchido sem alocar memória
+    PARSER_STREAM,          // Amostra de streaming (setpoint com "seq" e "t")
+    PARSER_OUTRO,           // Tem outras chaves (configuração): tratar com o cJSON
+    PARSER_INVALIDO         // JSON malformado ou setpoint incompleto
+} parser_resultado_t;
+
+/**
+ * @brief Lê um comando {"pitch":..,"roll":..[,"vel":..][,"tempo":..][,"seq":..][,"t":..][,"id":..][,"th":..]} direto do payload.
+ * Não exige \0 no fim nem aloca memória; nunca lê além de len.
+ * @param tem_seq Saída: true se o comando trouxe "seq".
+ */
+parser_resultado_t parser_setpoint(const char *json, int len, setpoint_t *sp, bool *tem_seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARSER_COMANDO_H
@@ -1,11 +1,14 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
+#include "nvs.h"
 #include "esp_netif.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "wifi_sta.h"
+#include "sequencia_init.h"
 #include <string.h>
 
 // --- CONFIGURAÇÃO DAS REDES (Prioridade: Topo -> Base) ---
@@ -23,6 +26,23 @@ static const wifi_creds_t wifi_networks[] = {
 
 #define NUM_NETWORKS (sizeof(wifi_networks) / sizeof(wifi_networks[0]))
 #define WIFI_MAX_RETRY 5
+#define WIFI_CACHE_MAX_RETRY 2          // Tentativas com BSSID/canal do cache antes da lista
+
+// --- Backoff exponencial entre tentativas ---
+#define WIFI_BACKOFF_INICIAL_MS 100
+#define WIFI_BACKOFF_MAX_MS     4000
+
+// --- Cache da última conexão (NVS) ---
+#define WIFI_NVS_NAMESPACE  "wifi"
+#define WIFI_NVS_CHAVE      "cache"
+#define WIFI_CACHE_MAGIC    0x57494643  // "WIFC"
+
+typedef struct {
+    uint32_t magic;
+    char ssid[32];
+    uint8_t bssid[6];
+    uint8_t canal;
+} wifi_cache_t;
 
 static const char *TAG = "WIFI";
 static EventGroupHandle_t s_wifi_event_group;
@@ -30,73 +50,204 @@ static EventGroupHandle_t s_wifi_event_group;
 // Variáveis de controle de estado
 static int s_retry_num = 0;
 static int s_current_network_index = 0; // Começa na rede 0
+static bool s_usando_cache = false;
+static bool s_falha_sinalizada = false;
+static wifi_cache_t s_cache = { 0 };
+static esp_timer_handle_t s_timer_reconexao = NULL;
+
+// Métricas da última conexão
+static wifi_metricas_t s_metricas = { 0 };
+static int64_t s_inicio_conexao_us = 0;
+static uint16_t s_tentativas = 0;
+static uint8_t s_bssid_conectado[6];
+static uint8_t s_canal_conectado = 0;
+static volatile bool s_economia = false;    // Modem sleep pedido pelo gerenciador de energia
 
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT      BIT1
 
+// --- Lê o cache da última conexão bem sucedida ---
+static bool cache_carregar(void) {
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+
+    size_t tamanho = sizeof(s_cache);
+    esp_err_t err = nvs_get_blob(nvs, WIFI_NVS_CHAVE, &s_cache, &tamanho);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || tamanho != sizeof(s_cache) || s_cache.magic != WIFI_CACHE_MAGIC) {
+        memset(&s_cache, 0, sizeof(s_cache));
+        return false;
+    }
+
+    // Só vale se a rede ainda estiver na lista configurada
+    for (int i = 0; i < NUM_NETWORKS; i++) {
+        if (strncmp(s_cache.ssid, wifi_networks[i].ssid, sizeof(s_cache.ssid)) == 0) {
+            s_current_network_index = i;
+            return true;
+        }
+    }
+    memset(&s_cache, 0, sizeof(s_cache));
+    return false;
+}
+
+// --- Grava o cache só quando muda (poupa a flash) ---
+static void cache_salvar(const char *ssid, const uint8_t bssid[6], uint8_t canal) {
+    if (s_cache.magic == WIFI_CACHE_MAGIC && canal == s_cache.canal
+        && memcmp(bssid, s_cache.bssid, 6) == 0
+        && strncmp(ssid, s_cache.ssid, sizeof(s_cache.ssid)) == 0) {
+        return;
+    }
+
+    s_cache.magic = WIFI_CACHE_MAGIC;
+    strlcpy(s_cache.ssid, ssid, sizeof(s_cache.ssid));
+    memcpy(s_cache.bssid, bssid, 6);
+    s_cache.canal = canal;
+
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, WIFI_NVS_CHAVE, &s_cache, sizeof(s_cache)) == ESP_OK) {
+        nvs_commit(nvs);
+        ESP_LOGI(TAG, "Cache atualizado: %s canal %d", s_cache.ssid, s_cache.canal);
+    }
+    nvs_close(nvs);
+}
+
 // Função auxiliar para configurar e conectar à rede atual baseada no índice
 static void connect_to_current_network() {
     wifi_config_t wifi_config = { 0 };
-    
+
     // Copia SSID e Senha da lista atual
     strlcpy((char *)wifi_config.sta.ssid, wifi_networks[s_current_network_index].ssid, sizeof(wifi_config.sta.ssid));
     strlcpy((char *)wifi_config.sta.password, wifi_networks[s_current_network_index].password, sizeof(wifi_config.sta.password));
-    
+
     wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
 
-    ESP_LOGI(TAG, "Configurando para conectar em: %s (Tentativa rede %d de %d)", 
-             wifi_config.sta.ssid, s_current_network_index + 1, NUM_NETWORKS);
+    if (s_usando_cache) {
+        // AP conhecido: pula a varredura de todos os canais
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, s_cache.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = s_cache.canal;
+        ESP_LOGI(TAG, "Conectando via cache em: %s (canal %d)", wifi_config.sta.ssid, s_cache.canal);
+    } else {
+        wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        wifi_config.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+        ESP_LOGI(TAG, "Configurando para conectar em: %s (Tentativa rede %d de %d)",
+                 wifi_config.sta.ssid, s_current_network_index + 1, NUM_NETWORKS);
+    }
 
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    s_tentativas++;
     esp_wifi_connect();
 }
 
+// --- Timer do backoff: dispara a próxima tentativa ---
+static void reconexao_timer_cb(void *arg) {
+    connect_to_current_network();
+}
+
+// --- Atraso exponencial para a n-ésima tentativa ---
+static uint32_t atraso_backoff_ms(int tentativa) {
+    uint32_t atraso_ms = WIFI_BACKOFF_INICIAL_MS << (tentativa < 6 ? tentativa : 6);
+    return (atraso_ms > WIFI_BACKOFF_MAX_MS) ? WIFI_BACKOFF_MAX_MS : atraso_ms;
+}
+
+// --- Agenda a próxima tentativa ---
+static void agendar_reconexao(uint32_t atraso_ms) {
+    esp_timer_stop(s_timer_reconexao);
+    esp_timer_start_once(s_timer_reconexao, (uint64_t)atraso_ms * 1000);
+}
+
 // --- Manipulador de Eventos WiFi ---
 static void event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        // Ao iniciar, tenta a primeira rede da lista
+        // Ao iniciar, tenta o AP do cache (ou a primeira rede da lista)
         connect_to_current_network();
 
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        // Guarda o AP/canal para o cache
+        wifi_event_sta_connected_t *event = (wifi_event_sta_connected_t *) event_data;
+        memcpy(s_bssid_conectado, event->bssid, sizeof(s_bssid_conectado));
+        s_canal_conectado = event->channel;
+
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < WIFI_MAX_RETRY) {
-            // Tenta reconectar na MESMA rede algumas vezes
-            esp_wifi_connect();
+        // Queda após estar conectado: começa a medir a reconexão
+        if (xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT) {
+            xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+            init_desmarcar(INIT_REDE_PRONTA);
+            s_inicio_conexao_us = esp_timer_get_time();
+            s_tentativas = 0;
+            s_usando_cache = (s_cache.magic == WIFI_CACHE_MAGIC);
+        }
+
+        int max_retry = s_usando_cache ? WIFI_CACHE_MAX_RETRY : WIFI_MAX_RETRY;
+        if (s_retry_num < max_retry) {
+            // Tenta reconectar na MESMA rede, esperando cada vez mais
             s_retry_num++;
-            ESP_LOGW(TAG, "Tentando reconectar em %s (%d/%d)", 
-                     wifi_networks[s_current_network_index].ssid, s_retry_num, WIFI_MAX_RETRY);
+            ESP_LOGW(TAG, "Tentando reconectar em %s (%d/%d)",
+                     wifi_networks[s_current_network_index].ssid, s_retry_num, max_retry);
+            agendar_reconexao(atraso_backoff_ms(s_retry_num - 1));
+        } else if (s_usando_cache) {
+            // O AP do cache não respondeu: volta para a lista completa com varredura
+            ESP_LOGW(TAG, "Cache falhou. Varrendo a lista de redes...");
+            s_usando_cache = false;
+            s_retry_num = 0;
+            s_current_network_index = 0;
+            connect_to_current_network();
         } else {
             // Falhou muitas vezes na rede atual, vamos tentar a PRÓXIMA
             ESP_LOGW(TAG, "Falha ao conectar em %s. Tentando próxima rede...", wifi_networks[s_current_network_index].ssid);
-            
+
             s_retry_num = 0;
             s_current_network_index++;
 
-            if (s_current_network_index < NUM_NETWORKS) {
-                // Ainda tem redes na lista para tentar
-                connect_to_current_network();
-            } else {
-                // Acabaram as redes da lista, falha total
+            if (s_current_network_index >= NUM_NETWORKS) {
+                // Acabaram as redes da lista: avisa uma vez e recomeça com o maior atraso
                 ESP_LOGE(TAG, "Todas as redes falharam.");
-                xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+                if (!s_falha_sinalizada) {
+                    s_falha_sinalizada = true;
+                    xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+                }
+                s_current_network_index = 0;
+                agendar_reconexao(WIFI_BACKOFF_MAX_MS);
+            } else {
+                connect_to_current_network();
             }
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "Conectado! IP:" IPSTR, IP2STR(&event->ip_info.ip));
+
+        // Métricas da conexão
+        s_metricas.tempo_conexao_ms = (uint32_t)((esp_timer_get_time() - s_inicio_conexao_us) / 1000);
+        s_metricas.tentativas = s_tentativas;
+        s_metricas.usou_cache = s_usando_cache;
+        s_metricas.canal = s_canal_conectado;
+        wifi_ap_record_t ap;
+        s_metricas.rssi = (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) ? ap.rssi : 0;
+        ESP_LOGI(TAG, "Conexão em %u ms (%u tentativas, cache: %s)", (unsigned)s_metricas.tempo_conexao_ms,
+                 (unsigned)s_metricas.tentativas, s_metricas.usou_cache ? "sim" : "não");
+
+        cache_salvar(wifi_networks[s_current_network_index].ssid, s_bssid_conectado, s_canal_conectado);
+
         s_retry_num = 0;
+        s_usando_cache = true; // Próxima queda tenta o mesmo AP primeiro
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        init_marcar(INIT_REDE_PRONTA);
+
+        // O modo de energia pode ter mudado antes do Wi-Fi subir (esp_wifi_set_ps falha sem o driver)
+        if (s_economia) wifi_definir_economia(true);
     }
 }
 
 // --- Inicializa o WiFi e conecta às redes configuradas ---
 void wifi_init_sta(void) {
-    // NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ESP_ERROR_CHECK(nvs_flash_init());
-    }
-    
+    s_inicio_conexao_us = esp_timer_get_time();
+
+    // NVS já inicializada no app_main
+    s_usando_cache = cache_carregar();
+
     // Netif / Eventos
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
@@ -105,22 +256,58 @@ void wifi_init_sta(void) {
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
+    const esp_timer_create_args_t timer_args = {
+        .callback = reconexao_timer_cb,
+        .name = "wifi_backoff",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_timer_reconexao));
+
     s_wifi_event_group = xEventGroupCreate();
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &event_handler, NULL, NULL));
     ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &event_handler, NULL, NULL));
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    
-    // O esp_wifi_start dispara o evento WIFI_EVENT_STA_START, 
+
+    // O esp_wifi_start dispara o evento WIFI_EVENT_STA_START,
     // que chama nossa função connect_to_current_network()
     ESP_ERROR_CHECK(esp_wifi_start());
 
     // Espera conectar ou falhar
-    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
 
     if (bits & WIFI_CONNECTED_BIT) {
         ESP_LOGI(TAG, "Sucesso: Conectado à rede %s", wifi_networks[s_current_network_index].ssid);
     } else {
         ESP_LOGE(TAG, "Falha Geral: Não foi possível conectar em nenhuma rede.");
     }
+}
+
+// --- Copia as métricas da última conexão ---
+bool wifi_obter_metricas(wifi_metricas_t *saida) {
+    if (!saida || !s_wifi_event_group) return false;
+    if (!(xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT)) return false;
+
+    *saida = s_metricas;
+    return true;
+}
+
+// --- RSSI atual do AP (0 se desconectado) ---
+int8_t wifi_rssi_atual(void) {
+    wifi_ap_record_t ap;
+    if (!s_wifi_event_group || !(xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT)) return 0;
+    return (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) ? ap.rssi : 0;
+}
+
+// --- Ajusta o modo de economia do rádio ---
+void wifi_definir_economia(bool ativo) {
+    // Guardado para reaplicar ao conectar
+    s_economia = ativo;
+
+    // WIFI_PS_MIN_MODEM é o padrão do ESP-IDF; o máximo dorme por vários beacons
+    esp_err_t err = esp_wifi_set_ps(ativo ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Falha ao ajustar modem sleep: %s (reaplicado ao conectar)", esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "Modem sleep %s", ativo ? "máximo" : "mínimo");
+    }
 }
\ No newline at end of file
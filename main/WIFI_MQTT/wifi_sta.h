@@ -3,15 +3,44 @@
 #ifndef WIFI_STA_H
 #define WIFI_STA_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Métricas da última conexão (boot ou reconexão após queda)
+typedef struct {
+    uint32_t tempo_conexao_ms;  // Do início (ou da queda) até receber IP
+    uint16_t tentativas;        // Tentativas de associação até conectar
+    bool usou_cache;            // Conectou pelo BSSID/canal salvos na NVS
+    uint8_t canal;
+    int8_t rssi;
+} wifi_metricas_t;
+
 /**
  * @brief Tarefa de inicialização do Wi-Fi em modo estação (STA).
  */
 void wifi_init_sta(void);
 
+/**
+ * @brief Copia as métricas da conexão atual.
+ * @return false se não estiver conectado.
+ */
+bool wifi_obter_metricas(wifi_metricas_t *saida);
+
+/**
+ * @brief RSSI atual do AP, em dBm (0 se desconectado).
+ */
+int8_t wifi_rssi_atual(void);
+
+/**
+ * @brief Liga/desliga o modem sleep máximo (economia de bateria). Pode ser chamada antes
+ * do Wi-Fi subir: o modo pedido é reaplicado ao conectar.
+ */
+void wifi_definir_economia(bool ativo);
+
 
 #ifdef __cplusplus
 }
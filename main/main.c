@@ -3,6 +3,8 @@
 #include "freertos/task.h"
 #include "log_mqtt.h"
 #include "esp_err.h"
+#include "nvs_flash.h"
+#include "esp_timer.h"
 #include "mainGlobals.h"
 #include "SensorMPU6050.h"
 #include "ControladorPID.h"
@@ -11,33 +13,100 @@
 #include "adc_bateria.h"
 #include "botao.h"
 #include "BufferTelemetria.h"
+#include "sequencia_init.h"
+#include "espectro.h"
+#include "identificacao.h"
+#include "roteiro.h"
+#include "gerenciador_energia.h"
+#include "codec_telemetria.h"
+#include "agendador_telemetria.h"
+#include "udp_telemetria.h"
 
 // --- Declarações Globais Compartilhadas ---
-float pr[2] = {0.0f, 0.0f};             // [pitch, roll]   Ângulos alvo de Pitch e Roll em graus
 float pr_medido[2] = {0.0f, 0.0f};      // [pitch, roll]   Ângulos medidos de Pitch e Roll em graus
-SemaphoreHandle_t mutex_pr;             // Mutex para proteger o acesso à variável pr
 SemaphoreHandle_t mutex_sensor_data;    // Mutex para proteger o acesso à variável pr_medido
-SemaphoreHandle_t g_mpu_pronta;         // Semáforo para indicar que o MPU está pronto
+
+#define ESTADO_TELEMETRIA_JANELAS   5   // Publica o estado do agendador a cada 5 janelas (~5 s)
+
+static int64_t s_t_us_ultima_amostra;   // Amostra mais recente do lote aberto
+static bool s_udp_ativa;                // PC registrado para receber a telemetria por UDP
+
+static void publicar_lote_telemetria(void) {
+    const uint8_t *lote;
+    uint8_t n;
+    size_t tamanho = codec_telemetria_fechar(&lote, &n);
+    if (!tamanho) return;
+    if (s_udp_ativa) udp_telemetria_enviar(lote, tamanho);
+    else mqtt_publish_telemetria_lote(lote, tamanho, s_t_us_ultima_amostra);
+}
 
 void task_mqtt_publish(void *pvParameters) {
-    float dados[2];
+    telemetria_amostra_t amostra;
+    roteiro_progresso_t progresso;
+    int janelas = 0;
     while (1) {
-        // Aguarda até haver dados no buffer circular
-        if (buffer_telemetria_ler(dados, portMAX_DELAY)) {
-            mqtt_publish_telemetry(dados[0], dados[1]);
+        // Telemetria por UDP (PC na rede local): sempre binária, na taxa pedida pelo PC
+        s_udp_ativa = udp_telemetria_ativa(esp_timer_get_time());
+        agendador_telemetria_taxa_fixa(udp_telemetria_taxa_hz());
+
+        // Aguarda até haver dados no buffer circular (com timeout para não atrasar o progresso do roteiro)
+        if (buffer_telemetria_ler(&amostra, pdMS_TO_TICKS(100))) {
+            if (codec_telemetria_ativo() || s_udp_ativa) {
+                // Formato binário: amostras em lotes; confirmações de comando seguem em JSON
+                s_t_us_ultima_amostra = amostra.t_us;
+                if (codec_telemetria_adicionar(&amostra)) publicar_lote_telemetria();
+                mqtt_publish_confirmacao();
+            } else {
+                mqtt_publish_telemetry(amostra.pitch, amostra.roll, amostra.t_us);
+            }
+        } else if (codec_telemetria_expirou(esp_timer_get_time())) {
+            publicar_lote_telemetria();
+        }
+        if (roteiro_progresso_novo(&progresso)) {
+            mqtt_publish_roteiro(&progresso);
+        }
+
+        // Taxa e conteúdo da telemetria conforme o enlace (uma vez por segundo)
+        if (agendador_telemetria_atualizar(esp_timer_get_time(), mqtt_outbox_bytes(), wifi_rssi_atual())
+            && ++janelas >= ESTADO_TELEMETRIA_JANELAS) {
+            janelas = 0;
+            agendador_estado_t estado;
+            agendador_telemetria_obter_estado(&estado);
+            estado.descartes_buffer = buffer_telemetria_descartes();
+            mqtt_publish_estado_telemetria(&estado);
         }
     }
     vTaskDelete(NULL);
 }
 
+// Rede em paralelo com sensor e motores: o controle não espera o Wi-Fi
+void task_rede(void *pvParameters) {
+    wifi_init_sta();
+    mqtt_start();
+
+    // Relatório de tempos assim que o gimbal estabilizar (e o broker puder recebê-lo)
+    init_aguardar(INIT_ESTABILIZADO, portMAX_DELAY);
+    init_aguardar(INIT_BROKER_CONECTADO, pdMS_TO_TICKS(10000));
+    init_publicar_relatorio();
+    vTaskDelete(NULL);
+}
+
 void app_main(void)
 {
     LOGI("MAIN", "Iniciando aplicação...");
 
-    // Inicializa mutex e queue
-    mutex_pr = xSemaphoreCreateMutex();
+    // NVS (cache do Wi-Fi e calibração do IMU)
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ESP_ERROR_CHECK(nvs_flash_init());
+    }
+    roteiro_iniciar_modulo();
+    energia_iniciar();
+
+    // Inicializa mutex e event group de inicialização
     mutex_sensor_data = xSemaphoreCreateMutex();
-    g_mpu_pronta = xSemaphoreCreateBinary();
+    init_sequencia_criar();
 
     const size_t CAPACIDADE_BUFFER_TELEMETRIA = 200;
     if (!buffer_telemetria_iniciar(CAPACIDADE_BUFFER_TELEMETRIA)) {
@@ -46,19 +115,23 @@ void app_main(void)
 
     LOGI("MAIN", "Globais (Mutex/Filas) criadas.");
 
-    wifi_init_sta();
-    mqtt_start();
     setup_adc();
     botao_init_isr_task();
 
+    // Cada task espera só as fases de que depende (ver sequencia_init.h)
     xTaskCreatePinnedToCore(task_initI2C, "task_initI2C", 2048, NULL, 10, NULL, 1);
-    vTaskDelay(500 / portTICK_PERIOD_MS);
     xTaskCreatePinnedToCore(task_mpu, "task_mpu", 8192, NULL, 10, NULL, 1);
     LOGI("MAIN", "Task MPU criada.");
     xTaskCreatePinnedToCore(task_pid, "task_pid", 4096, NULL, 9, NULL, 1);
     LOGI("MAIN", "Task PID criada.");
+    xTaskCreatePinnedToCore(task_rede, "task_rede", 4096, NULL, 5, NULL, 0);
+    LOGI("MAIN", "Task Rede criada.");
     xTaskCreatePinnedToCore(task_mqtt_publish, "task_mqtt_publish", 4096, NULL, 3, NULL, 0);
     LOGI("MAIN", "Task MQTT Publish criada.");
     xTaskCreatePinnedToCore(task_leitura_bateria, "task_leitura_bateria", 2048, NULL, 2, NULL, 0);
     LOGI("MAIN", "Task Leitura Bateria criada.");
+    xTaskCreatePinnedToCore(task_espectro, "task_espectro", 4096, NULL, 1, NULL, 0);
+    LOGI("MAIN", "Task Espectro criada.");
+    xTaskCreatePinnedToCore(task_identificacao, "task_identificacao", 4096, NULL, 2, NULL, 0);
+    LOGI("MAIN", "Task Identificação criada.");
 }